@@ -0,0 +1,189 @@
+#ifndef EXTRA_ATTR_EXTRACT_H
+#define EXTRA_ATTR_EXTRACT_H
+
+#include <maya/MDagPath.h>
+#include <maya/MMatrix.h>
+#include <maya/MObject.h>
+#include <maya/MStatus.h>
+#include <maya/MString.h>
+#include <vector>
+#include "ExtraAttrShading.h"
+
+// One UV set in the layout MFnMesh::assignUVs expects
+struct MeshUVSet {
+    MString name;
+    std::vector<float> u;
+    std::vector<float> v;
+    std::vector<int> uvCounts;  // UVs assigned per face (0 or the face's vertex count)
+    std::vector<int> uvIds;     // UV per assigned face-vertex
+};
+
+// One color set, stored per face-vertex
+struct MeshColorSet {
+    MString name;
+    bool clamped;
+    int representation;         // MFnMesh::MColorRepresentation
+    std::vector<float> rgba;    // Four floats per face-vertex
+    std::vector<char> assigned; // Face-vertex has a color
+
+    MeshColorSet()
+        : clamped(false), representation(0) {}
+};
+
+/**
+ * @brief Plain copy of mesh geometry
+ *
+ * Holds everything needed to rebuild a mesh with MFnMesh::create: points,
+ * topology, UV sets, color sets, hard edges, creases and locked normals.
+ * Edges are identified by their two vertex indices so the data survives
+ * the renumbering done by MFnMesh::create. Polygon holes are not kept, so
+ * faces with holes go through copyFaces instead (see hasHoles).
+ */
+struct MeshBuffers {
+    std::vector<float> points;          // xyz per vertex
+    std::vector<int> polygonCounts;     // Vertices per face
+    std::vector<int> polygonConnects;   // Vertex per face-vertex
+
+    std::vector<MeshUVSet> uvSets;
+    MString currentUVSet;
+
+    std::vector<MeshColorSet> colorSets;
+    MString currentColorSet;
+
+    std::vector<int> hardEdges;         // Vertex pairs of hard edges
+    std::vector<int> creaseEdges;       // Vertex pairs of creased edges
+    std::vector<double> creaseEdgeValues;
+    std::vector<int> creaseVertices;
+    std::vector<double> creaseVertexValues;
+
+    std::vector<int> lockedNormalFaceVertices;  // Ascending face-vertex indices with a locked normal
+    std::vector<float> lockedNormals;           // xyz per locked face-vertex
+
+    int vertexCount() const { return static_cast<int>(points.size() / 3); }
+    int faceCount() const { return static_cast<int>(polygonCounts.size()); }
+    int faceVertexCount() const { return static_cast<int>(polygonConnects.size()); }
+
+    void clear();
+};
+
+// One source mesh to split into groups of faces on a worker thread
+struct PartitionJob {
+    MeshBuffers source;                  // Read on the main thread
+    const std::vector<int>* faceGroups;  // Group per face, or -1
+    int groupCount;
+    std::vector<MeshBuffers> outMeshes;  // One per group (empty when the group has no faces)
+
+    PartitionJob()
+        : faceGroups(nullptr), groupCount(0) {}
+};
+
+/**
+ * @brief Native mesh extraction
+ *
+ * Meshes are read once into MeshBuffers on the main thread, face subsets
+ * are copied between buffers without touching Maya, and the result is
+ * written back with MFnMesh::create. No component names are built.
+ */
+namespace ExtraAttrExtract {
+
+/**
+ * @brief Read the geometry of a mesh
+ * @param meshPath Mesh shape path
+ * @param outMesh Output buffers
+ * @return MS::kSuccess, or the failure of the mesh function set
+ */
+MStatus readMesh(const MDagPath& meshPath, MeshBuffers& outMesh);
+
+/**
+ * @brief Check whether any grouped face of a mesh has a hole
+ * @param meshPath Mesh shape path
+ * @param faceGroups Group per face, or -1 for faces left out
+ */
+bool hasHoles(const MDagPath& meshPath, const std::vector<int>& faceGroups);
+
+/**
+ * @brief Copy a mesh shape exactly and delete every face outside one group
+ *
+ * Used for meshes whose faces have holes, which MeshBuffers cannot hold.
+ * Slower than extractFaces, since faces are deleted one at a time.
+ *
+ * @param meshPath Source mesh shape path
+ * @param faceGroups Group per face of the source
+ * @param group Group whose faces are kept
+ * @param parent Transform to create the shape under
+ * @param outShape Output mesh shape
+ * @return MS::kSuccess, or the failure of MFnMesh::copy or MFnMesh::deleteFace
+ */
+MStatus copyFaces(const MDagPath& meshPath, const std::vector<int>& faceGroups, int group, const MObject& parent,
+                  MObject& outShape);
+
+/**
+ * @brief Copy a subset of faces into new buffers
+ *
+ * Vertices, UVs and colors used by the faces are renumbered in order of
+ * first use; faces keep their relative order and winding.
+ *
+ * @param source Source geometry
+ * @param faces Face indices in ascending order
+ * @param outMesh Output buffers
+ */
+void extractFaces(const MeshBuffers& source, const std::vector<int>& faces, MeshBuffers& outMesh);
+
+/**
+ * @brief Split the faces of a mesh into groups in one pass
+ * @param source Source geometry
+ * @param faceGroups Group per face, or -1 for faces left out
+ * @param groupCount Number of groups
+ * @param outMeshes Output buffers, one per group
+ */
+void partitionFaces(const MeshBuffers& source, const std::vector<int>& faceGroups, int groupCount,
+                    std::vector<MeshBuffers>& outMeshes);
+
+/**
+ * @brief Run partitionFaces for every job, spread over worker threads
+ *
+ * Only plain buffers are touched, so no Maya API calls happen off the main thread.
+ */
+void partitionAll(std::vector<PartitionJob>& jobs);
+
+/**
+ * @brief Append a mesh to another, as polyUnite does
+ *
+ * Vertex, UV and face-vertex indices of the source are offset past the
+ * destination's. UV and color sets are merged by name; faces missing a
+ * set get no UVs or colors in it.
+ *
+ * @param dest Mesh to grow
+ * @param source Mesh to append
+ * @param matrix Transform from source space to destination space
+ */
+void appendMesh(MeshBuffers& dest, const MeshBuffers& source, const MMatrix& matrix);
+
+/**
+ * @brief Create a mesh shape from buffers
+ * @param mesh Geometry
+ * @param parent Transform to create the shape under
+ * @param outShape Output mesh shape
+ * @return MS::kSuccess, or the failure of MFnMesh::create
+ */
+MStatus createMesh(const MeshBuffers& mesh, const MObject& parent, MObject& outShape);
+
+/**
+ * @brief Give a transform the world placement and pivots of a mesh's transform
+ * @param sourceShape Mesh shape path whose parent transform is copied
+ * @param transform Transform to place (expected to be parented to the world)
+ */
+MStatus matchPlacement(const MDagPath& sourceShape, const MObject& transform);
+
+/**
+ * @brief Assign an extracted mesh to the shading engines of its source faces
+ * @param partition Source mesh instance and its face grouping
+ * @param group Group the mesh was built from
+ * @param shape Extracted mesh shape
+ * @param faceOffset Index of the group's first face in the shape (when meshes were combined)
+ */
+MStatus copyShaderAssignment(const MeshPartition& partition, int group, const MObject& shape, int faceOffset = 0);
+
+} // namespace ExtraAttrExtract
+
+#endif // EXTRA_ATTR_EXTRACT_H
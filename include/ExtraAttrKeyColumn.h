@@ -0,0 +1,139 @@
+#ifndef EXTRA_ATTR_KEY_COLUMN_H
+#define EXTRA_ATTR_KEY_COLUMN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class ExtraAttrKeyColumn
+ * @brief Precomputed per-row keys of one table column for filtering and sorting
+ *
+ * Each row holds either a number or a byte string. All strings live in one
+ * contiguous buffer separated by '\0', so a substring search can scan the
+ * whole column in a single pass instead of visiting row objects.
+ * Rows are numbered from 0 in the order they were appended.
+ *
+ * A row whose text grows is moved to the end of the buffer instead of
+ * rewriting it; once too many rows have moved, the buffer is rebuilt in
+ * row order.
+ */
+class ExtraAttrKeyColumn {
+public:
+    ExtraAttrKeyColumn();
+
+    /**
+     * @brief Compare text with runs of digits as numbers ("item9" before "item10")
+     */
+    void setNaturalOrder(bool natural);
+
+    /**
+     * @brief Remove all rows
+     */
+    void clear();
+
+    /**
+     * @brief Reserve space for a number of rows and text bytes
+     */
+    void reserve(size_t rowCount, size_t textBytes = 0);
+
+    /**
+     * @brief Append a text row
+     * @param text UTF-8 bytes (callers fold case beforehand for case-insensitive search)
+     * @param length Number of bytes
+     */
+    void appendText(const char* text, size_t length);
+
+    /**
+     * @brief Append a numeric row
+     */
+    void appendNumber(double value);
+
+    /**
+     * @brief Replace the key of an existing row
+     */
+    void setText(uint32_t row, const char* text, size_t length);
+    void setNumber(uint32_t row, double value);
+
+    /**
+     * @brief Remove a range of rows; later rows move up
+     * @param first First row to remove
+     * @param count Number of rows
+     */
+    void removeRows(uint32_t first, uint32_t count);
+
+    /**
+     * @brief Get number of rows
+     */
+    size_t size() const;
+
+    /**
+     * @brief Find rows whose text contains a substring
+     * @param needle Bytes to search for; an empty needle matches every row
+     * @param outRows Output rows in ascending order (numeric rows never match)
+     */
+    void findSubstring(const std::string& needle, std::vector<uint32_t>& outRows) const;
+
+    /**
+     * @brief Find rows among candidates whose text contains a substring
+     *
+     * Used to narrow a previous result when the query is extended.
+     *
+     * @param candidates Rows to test, in ascending order
+     */
+    void narrowSubstring(const std::string& needle, const std::vector<uint32_t>& candidates,
+                         std::vector<uint32_t>& outRows) const;
+
+    /**
+     * @brief Compare the keys of two rows
+     *
+     * Numbers sort before text, with NaN after all other numbers; text
+     * compares bytewise, or in natural order if enabled.
+     *
+     * @return Negative, zero or positive like strcmp
+     */
+    int compare(uint32_t a, uint32_t b) const;
+
+    /**
+     * @brief Stable sort rows by key
+     *
+     * Large inputs are split into chunks sorted on worker threads and then
+     * merged. All-numeric inputs are sorted as packed (value, position) pairs.
+     *
+     * @param rows Rows to sort in place
+     * @param descending Sort in descending order (equal keys keep their order)
+     */
+    void sortRows(std::vector<uint32_t>& rows, bool descending) const;
+
+private:
+    // Key of one row: text rows point into m_text
+    struct Key {
+        double number;
+        uint32_t offset;  // Start of the text
+        uint32_t slot;    // Position in row order; the text is elsewhere once it moved to the tail
+        uint32_t length;
+        bool isText;
+        bool moved;       // Listed in m_tailRows
+    };
+
+    /**
+     * @brief Rewrite the text buffer in row order, bringing moved rows back into place
+     */
+    void compactText();
+
+private:
+    // Slots never decrease with the row number (numeric rows get the current end)
+    std::vector<Key> m_keys;
+
+    // Text of all text rows, each followed by at least one '\0'
+    std::string m_text;
+
+    // Rows whose text was moved behind m_tailBegin because it grew
+    std::vector<uint32_t> m_tailRows;
+    uint32_t m_tailBegin;
+
+    bool m_naturalOrder;
+};
+
+#endif // EXTRA_ATTR_KEY_COLUMN_H
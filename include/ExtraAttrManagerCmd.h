@@ -6,6 +6,12 @@
 #include <maya/MArgDatabase.h>
 #include <maya/MString.h>
 #include <maya/MSyntax.h>
+#include <maya/MDGModifier.h>
+#include <maya/MDagModifier.h>
+#include <maya/MObject.h>
+#include <vector>
+#include "ExtraAttrScanner.h"
+#include "ExtraAttrShading.h"
 
 /**
  * @class ExtraAttrManagerCmd
@@ -15,6 +21,30 @@
  *
  * Flags:
  *   -scan/-s         : Scan the scene to detect Extra Attributes
+ *   -async/-as       : With -scan, run the scan in idle time and return a job ID
+ *   -jobStatus/-js <id> : Get state and progress of a scan job
+ *   -jobWait/-jw <id>   : Finish a scan job synchronously
+ *   -jobCancel/-jc <id> : Cancel a scan job
+ *   -snapshot/-ss <name> : Capture a hashed snapshot of the index
+ *   -diff/-df <a> <b>    : List entries added, removed or changed between two snapshots
+ *   -rename/-rn <old> <new> : Rename an attribute on every node that has it (undoable)
+ *   -purge/-pg <attr>    : Remove an attribute from every node that has it (undoable)
+ *   -nodeType/-nt <type> : With -purge, only affect nodes of this type
+ *   -namespace/-ns <ns>  : With -purge, only affect nodes in this namespace
+ *   -dryRun/-dr          : With -purge, list affected nodes without changing the scene
+ *   -extract/-ex <material> : Copy the faces assigned to a material into new meshes, one per
+ *                          mesh and material (repeatable, undoable)
+ *   -extractName/-xn <name> : With -extract, name of the new objects
+ *   -keepOriginal/-ko    : With -extract, keep the faces on the source meshes
+ *   -combine/-cb         : With -extract, write every extracted face to one mesh in world space
+ *   -stats/-st <attr>    : Get value statistics of a numeric attribute
+ *   -query/-qr <attr>    : Get nodes whose attribute value matches -equals
+ *   -equals/-eq <value>  : With -query, accepted value (repeat for an IN list)
+ *   -valueIndex/-vi <on> : Enable or disable the inverted value index (off by default; applies from the next scan)
+ *   -search/-sr <text>   : Search attribute names, node names and string values (case-insensitive)
+ *   -regex/-rx           : With -search, treat the text as a regular expression
+ *   -codecBenchmark/-cbm <count> : Measure value format/parse throughput and check round trips of scalars,
+ *                                  vectors, arrays and unit values (through UI unit conversion)
  *   -list/-ls        : Get a list of detected Extra Attributes
  *   -nodes/-n <attr> : Get a list of nodes with the specified attribute
  *   -ui/-ui          : Open UI
@@ -26,6 +56,16 @@
  *
  * Usage examples:
  *   exAttrEditor -scan;
+ *   exAttrEditor -scan -async;
+ *   exAttrEditor -jobWait 1;
+ *   exAttrEditor -snapshot "before";
+ *   exAttrEditor -diff "before" "after";
+ *   exAttrEditor -rename "oldAttr" "newAttr";
+ *   exAttrEditor -purge "legacyAttr" -namespace "char" -dryRun;
+ *   exAttrEditor -extract "blinn1" -extract "lambert2" -extractName "extracted";
+ *   exAttrEditor -stats "lodLevel";
+ *   exAttrEditor -query "assetType" -equals "prop" -equals "set";
+ *   exAttrEditor -search "geo_LOD[0-9]" -regex;
  *   exAttrEditor -list;
  *   exAttrEditor -nodes "myCustomAttr";
  *   exAttrEditor -ui;
@@ -54,6 +94,131 @@ private:
      */
     MStatus doScan();
 
+    /**
+     * @brief Start a background scan job
+     */
+    MStatus doScanAsync();
+
+    /**
+     * @brief Get state and progress of a scan job
+     * @param jobId Job ID
+     */
+    MStatus doJobStatus(int jobId);
+
+    /**
+     * @brief Finish a scan job synchronously
+     * @param jobId Job ID
+     */
+    MStatus doJobWait(int jobId);
+
+    /**
+     * @brief Cancel a scan job
+     * @param jobId Job ID
+     */
+    MStatus doJobCancel(int jobId);
+
+    /**
+     * @brief Rescan the scene and capture a snapshot of the shared index
+     * @param name Snapshot name
+     */
+    MStatus doSnapshot(const MString& name);
+
+    /**
+     * @brief Compare two snapshots
+     * @param beforeName Older snapshot name
+     * @param afterName Newer snapshot name
+     */
+    MStatus doDiff(const MString& beforeName, const MString& afterName);
+
+    /**
+     * @brief Rename an attribute on every indexed node that has it
+     * @param oldName Current attribute name
+     * @param newName New attribute name
+     */
+    MStatus doRename(const MString& oldName, const MString& newName);
+
+    /**
+     * @brief Remove an attribute from every indexed node that has it
+     * @param attrName Attribute name
+     * @param nodeType Only affect nodes of this type (empty for all)
+     * @param nameSpace Only affect nodes in this namespace (empty for all)
+     * @param dryRun List affected nodes without modifying the scene
+     */
+    MStatus doPurge(const MString& attrName, const MString& nodeType, const MString& nameSpace, bool dryRun);
+
+    /**
+     * @brief Move or copy the faces assigned to materials into new meshes
+     * @param materials Materials, textures or shading engines
+     * @param objectName Name of the new objects
+     * @param keepOriginal Keep the faces on the source meshes
+     * @param combine Write all faces to a single mesh
+     */
+    MStatus doExtract(const std::vector<MString>& materials, const MString& objectName, bool keepOriginal,
+                      bool combine);
+
+    /**
+     * @brief Build the extracted meshes and delete the source faces
+     */
+    MStatus redoExtract();
+
+    /**
+     * @brief Remove the extracted meshes and restore the source faces
+     */
+    MStatus undoExtract();
+
+    /**
+     * @brief Delete the extracted meshes and transforms, leaving the source faces as they are
+     */
+    MStatus removeExtractedObjects();
+
+    /**
+     * @brief Get the faces assigned to materials as coalesced range names
+     * @param materials Materials, textures or shading engines
+     */
+    MStatus doMaterialFaces(const std::vector<MString>& materials);
+
+    /**
+     * @brief Get value statistics of a numeric attribute
+     * @param attrName Attribute name
+     */
+    MStatus doStats(const MString& attrName);
+
+    /**
+     * @brief Get nodes whose attribute value equals one of the given values
+     * @param attrName Attribute name
+     * @param values Accepted values (empty accepts any value)
+     * @param requiredFlags MayaUtils::PlugFlag values every returned occurrence has
+     * @param excludedFlags MayaUtils::PlugFlag values no returned occurrence has
+     */
+    MStatus doQuery(const MString& attrName, const std::vector<MString>& values,
+                    unsigned int requiredFlags, unsigned int excludedFlags);
+
+    /**
+     * @brief Enable or disable the inverted value index
+     * @param enabled New state
+     */
+    MStatus doValueIndex(bool enabled);
+
+    /**
+     * @brief Search attribute names, node names and string values
+     * @param pattern Substring or regular expression
+     * @param isRegex Treat the pattern as a regular expression
+     */
+    MStatus doSearch(const MString& pattern, bool isRegex);
+
+    /**
+     * @brief Measure value codec throughput against MString conversions
+     * @param count Number of values to format and parse
+     */
+    MStatus doCodecBenchmark(int count);
+
+    /**
+     * @brief Get the shared index, scanning the scene if it has never been populated
+     * @param outScanner Output pointer to the shared index
+     * @param rescan Rescan even if a scan is held, for results that must reflect the current scene
+     */
+    MStatus getSharedIndex(ExtraAttrScanner*& outScanner, bool rescan = false);
+
     /**
      * @brief Get a list of Extra Attributes
      */
@@ -107,6 +272,56 @@ private:
     // Command flags
     static const char* kScanFlag;
     static const char* kScanFlagLong;
+    static const char* kAsyncFlag;
+    static const char* kAsyncFlagLong;
+    static const char* kJobStatusFlag;
+    static const char* kJobStatusFlagLong;
+    static const char* kJobWaitFlag;
+    static const char* kJobWaitFlagLong;
+    static const char* kJobCancelFlag;
+    static const char* kJobCancelFlagLong;
+    static const char* kSnapshotFlag;
+    static const char* kSnapshotFlagLong;
+    static const char* kDiffFlag;
+    static const char* kDiffFlagLong;
+    static const char* kRenameFlag;
+    static const char* kRenameFlagLong;
+    static const char* kPurgeFlag;
+    static const char* kPurgeFlagLong;
+    static const char* kNodeTypeFlag;
+    static const char* kNodeTypeFlagLong;
+    static const char* kNamespaceFlag;
+    static const char* kNamespaceFlagLong;
+    static const char* kDryRunFlag;
+    static const char* kDryRunFlagLong;
+    static const char* kExtractFlag;
+    static const char* kExtractFlagLong;
+    static const char* kExtractNameFlag;
+    static const char* kExtractNameFlagLong;
+    static const char* kKeepOriginalFlag;
+    static const char* kKeepOriginalFlagLong;
+    static const char* kCombineFlag;
+    static const char* kCombineFlagLong;
+    static const char* kMaterialFacesFlag;
+    static const char* kMaterialFacesFlagLong;
+    static const char* kStatsFlag;
+    static const char* kStatsFlagLong;
+    static const char* kQueryFlag;
+    static const char* kQueryFlagLong;
+    static const char* kEqualsFlag;
+    static const char* kEqualsFlagLong;
+    static const char* kWithFlagsFlag;
+    static const char* kWithFlagsFlagLong;
+    static const char* kWithoutFlagsFlag;
+    static const char* kWithoutFlagsFlagLong;
+    static const char* kValueIndexFlag;
+    static const char* kValueIndexFlagLong;
+    static const char* kSearchFlag;
+    static const char* kSearchFlagLong;
+    static const char* kRegexFlag;
+    static const char* kRegexFlagLong;
+    static const char* kCodecBenchmarkFlag;
+    static const char* kCodecBenchmarkFlagLong;
     static const char* kListFlag;
     static const char* kListFlagLong;
     static const char* kNodesFlag;
@@ -128,16 +343,34 @@ private:
     struct UndoData {
         MString nodeName;
         MString attrName;
+        MString newAttrName;
         MString oldValue;
+        AttributeInfo attrInfo;
+        std::vector<MObject> nodes;
+        std::vector<MeshPartition> partitions;  // Extracted faces per source mesh, one group per material
+        std::vector<MObject> transforms;        // One per non-empty group, in partition order
+        std::vector<MObject> shapes;            // Extracted mesh shapes, rebuilt on every redo
+        std::vector<char> copiedSources;        // Per partition: faces have holes, so outputs are copies
         bool wasDeleted;
         bool wasAdded;
+        bool wasRenamed;
+        bool wasPurged;
+        bool wasExtracted;
+        bool combine;                           // Extracted faces went to a single mesh
 
-        UndoData() : nodeName(""), attrName(""), oldValue(""),
-                     wasDeleted(false), wasAdded(false) {}
+        UndoData() : nodeName(""), attrName(""), newAttrName(""), oldValue(""),
+                     wasDeleted(false), wasAdded(false), wasRenamed(false), wasPurged(false),
+                     wasExtracted(false), combine(false) {}
     };
 
     UndoData m_undoData;
     bool m_isUndoable;
+
+    // Batched scene edits replayed by redoIt() and reverted by undoIt()
+    MDGModifier m_dgModifier;
+
+    // DAG nodes created by -extract
+    MDagModifier m_dagModifier;
 };
 
 #endif // EXTRA_ATTR_MANAGER_CMD_H
@@ -4,13 +4,19 @@
 #include <QAbstractItemModel>
 #include <QList>
 #include <QString>
+#include <cstdint>
 #include <memory>
+#include <vector>
 #include <maya/MString.h>
 #include "ExtraAttrScanner.h"
+#include "ExtraAttrStringPool.h"
 
 /**
  * @class ExtraAttrModel
  * @brief Class to manage Extra Attribute list using Qt Model/View architecture
+ *
+ * Rows are stored column by column, with names and type names interned in a
+ * string pool; QStrings are only created for the cells a view asks for.
  */
 class ExtraAttrModel : public QAbstractTableModel {
     Q_OBJECT
@@ -58,28 +64,44 @@ public:
      */
     std::shared_ptr<AttributeInfo> getAttributeInfo(int row) const;
 
+private:
+    // Rows stored column by column; names and type names are IDs into m_strings
+    struct AttributeColumns {
+        std::vector<uint32_t> names;
+        std::vector<uint32_t> typeNames;
+        std::vector<int> usageCounts;
+        std::vector<char> isArray;
+        std::vector<std::shared_ptr<AttributeInfo>> infos;
+
+        int size() const;
+        void reserve(size_t rowCount);
+        void clear();
+        void append(const AttributeColumns& source, int sourceRow);
+        void assign(int row, const AttributeColumns& source, int sourceRow);
+        void erase(int first, int last);
+    };
+
     /**
-     * @brief Sort function
-     * @param column Column number
-     * @param order Sort order
+     * @brief Get an interned string as a QString
      */
-    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    QString string(uint32_t id) const;
 
-private:
-    struct AttributeRow {
-        QString name;
-        QString typeName;
-        int usageCount;
-        bool isArray;
-        std::shared_ptr<AttributeInfo> info;
-    };
+    /**
+     * @brief Drop interned strings no longer used by any row
+     */
+    void compactStrings();
 
-    QList<AttributeRow> m_rows;
+    ExtraAttrStringPool m_strings;
+    AttributeColumns m_rows;
 };
 
 /**
  * @class NodeAttributeModel
  * @brief Model to display nodes with a specific Extra Attribute and their values
+ *
+ * Rows are stored column by column like ExtraAttrModel; node names, node
+ * types and values are IDs into one string pool, so repeated types and
+ * values are stored once.
  */
 class NodeAttributeModel : public QAbstractTableModel {
     Q_OBJECT
@@ -88,7 +110,12 @@ public:
     enum Column {
         COL_NODE_NAME = 0,      // Node name
         COL_NODE_TYPE,          // Node type
-        COL_VALUE,              // Attribute value
+        COL_FACES,              // Mesh faces assigned to a shading node
+        COL_TRIANGLES,          // Triangles of those faces
+        COL_VERTICES,           // Vertices used by those faces
+        COL_AREA,               // World-space area of those faces
+        COL_FLAGS,              // Plug state (connected, animated, locked, keyable, default)
+        COL_VALUE,              // Attribute value (last, so it takes the remaining width)
         COL_COUNT
     };
 
@@ -123,17 +150,32 @@ public:
     QString getNodeName(int row) const;
 
     /**
-     * @brief Get currently displayed attribute name
-     * @return Attribute name
+     * @brief Get the shading classification of the node at specified row
+     * @param row Row number
+     * @return Combination of MayaUtils::NodeTypeFlag values
      */
-    QString getCurrentAttributeName() const;
+    unsigned int getNodeTypeFlags(int row) const;
+
+    /**
+     * @brief Check whether the value at specified row is driven and was not read
+     * @param row Row number
+     */
+    bool isDrivenRow(int row) const;
 
     /**
-     * @brief Sort table
-     * @param column Column to sort
-     * @param order Sort order
+     * @brief Show the value of a driven row once it has been read
+     * @param row Row number
+     * @param value Value text
+     * @param sortNumber Numeric sort key (used if hasSortNumber)
+     * @param hasSortNumber The value is a scalar with a numeric sort key
+     */
+    void setEvaluatedValue(int row, const QString& value, double sortNumber, bool hasSortNumber);
+
+    /**
+     * @brief Get currently displayed attribute name
+     * @return Attribute name
      */
-    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    QString getCurrentAttributeName() const;
 
 signals:
     /**
@@ -145,14 +187,40 @@ signals:
     void valueChanged(const QString& nodeName, const QString& attrName, const QString& newValue);
 
 private:
-    struct NodeRow {
-        QString nodeName;
-        QString nodeType;
-        QString value;
+    // Rows stored column by column; text columns are IDs into m_strings
+    struct NodeColumns {
+        std::vector<uint32_t> nodeNames;
+        std::vector<uint32_t> nodeTypes;
+        std::vector<uint32_t> values;
+        std::vector<double> sortNumbers;    // Numeric sort key of the value (valid if hasSortNumber)
+        std::vector<char> hasSortNumber;
+        std::vector<uint8_t> typeFlags;     // MayaUtils::NodeTypeFlag combination
+        std::vector<char> isDriven;         // Value is driven by a connection and was not read
+        std::vector<uint8_t> plugFlags;     // MayaUtils::PlugFlag combination
+        std::vector<MaterialMeshStats> meshStats;   // Assigned geometry (valid if hasMeshStats)
+        std::vector<char> hasMeshStats;
+
+        int size() const;
+        void reserve(size_t rowCount);
+        void clear();
+        void append(const NodeColumns& source, int sourceRow);
+        void assign(int row, const NodeColumns& source, int sourceRow);
+        void erase(int first, int last);
     };
 
+    /**
+     * @brief Get an interned string as a QString
+     */
+    QString string(uint32_t id) const;
+
+    /**
+     * @brief Drop interned strings no longer used by any row
+     */
+    void compactStrings();
+
     QString m_currentAttrName;
-    QList<NodeRow> m_rows;
+    ExtraAttrStringPool m_strings;
+    NodeColumns m_rows;
 };
 
 #endif // EXTRA_ATTR_MODEL_H
@@ -0,0 +1,256 @@
+#ifndef EXTRA_ATTR_PROXY_MODEL_H
+#define EXTRA_ATTR_PROXY_MODEL_H
+
+#include <QAbstractProxyModel>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ExtraAttrKeyColumn.h"
+
+/**
+ * @class ExtraAttrProxyModel
+ * @brief Filter and sort proxy for flat table models with precomputed keys
+ *
+ * Keys of the filter column (case-folded) and the sort column are read from
+ * the source once and kept in ExtraAttrKeyColumn buffers, so filtering and
+ * sorting never call data() per row. Source edits only update the keys of
+ * the rows they touch. Extending the search text narrows the previous
+ * result instead of rescanning every row.
+ *
+ * Sort keys come from SortKeyRole when the source provides it, otherwise
+ * from the display text. Numbers sort numerically and text in natural order.
+ *
+ * On large tables, search and sort changes run as a pass on a worker thread
+ * over immutable snapshots of the keys. The finished pass is published with
+ * a single layout change; a newer request or a source change makes any
+ * running pass stale, and its result is dropped. Edits to the key columns
+ * are collected into one refresh per event loop turn, and edits to other
+ * columns only repaint.
+ */
+class ExtraAttrProxyModel : public QAbstractProxyModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        SortKeyRole = Qt::UserRole + 1  // Typed sort key (a number, or text to sort naturally)
+    };
+
+    explicit ExtraAttrProxyModel(QObject* parent = nullptr);
+    ~ExtraAttrProxyModel();
+
+    // QAbstractProxyModel overrides
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    /**
+     * @brief Set the column the search text is matched against
+     */
+    void setFilterKeyColumn(int column);
+
+    /**
+     * @brief Get the column the search text is matched against
+     */
+    int filterKeyColumn() const;
+
+    /**
+     * @brief Set the search text (case-insensitive substring match)
+     * @param text Substring to search for (empty shows all rows)
+     */
+    void setSearchText(const QString& text);
+
+private slots:
+    void onSourceAboutToBeReset();
+    void onSourceReset();
+    void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+    void onSourceRowsInserted(const QModelIndex& parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onSourceHeaderDataChanged(Qt::Orientation orientation, int first, int last);
+
+private:
+    // Inputs and results of one filter/sort pass. A pass only reads its own
+    // fields, so it can run on a worker thread while the model changes.
+    struct Pass {
+        uint64_t generation;
+        std::atomic<bool> cancelled;
+        int rowCount;
+
+        // Filter: previous matches go in (for narrowing), new matches come out
+        std::shared_ptr<const ExtraAttrKeyColumn> filterKeys;  // null if there is no search text
+        std::string searchText;
+        std::vector<uint32_t> matchedRows;
+        std::string matchedText;
+        bool matchedValid;
+
+        // Sort: the current order goes in if still valid, otherwise a full sort runs
+        std::shared_ptr<const ExtraAttrKeyColumn> sortKeys;  // null if unsorted
+        bool descending;
+        std::vector<uint32_t> sortedRows;
+        bool sortedValid;
+
+        std::vector<int> proxyToSource;
+    };
+
+    /**
+     * @brief Read the value a key is made from: the sort key if available, else the display value
+     */
+    QVariant keyValue(int row, int column, bool foldCase) const;
+
+    /**
+     * @brief Append the key of a source cell
+     * @param foldCase Store case-folded text (for filtering) instead of a typed key (for sorting)
+     */
+    void appendKey(ExtraAttrKeyColumn& keys, int row, int column, bool foldCase) const;
+
+    /**
+     * @brief Replace the key of a source cell
+     */
+    void updateKey(ExtraAttrKeyColumn& keys, int row, int column, bool foldCase) const;
+
+    /**
+     * @brief Read all keys of a column from the source
+     */
+    std::shared_ptr<ExtraAttrKeyColumn> buildKeys(int column, bool foldCase) const;
+
+    /**
+     * @brief Build any keys the current search and sort need
+     */
+    void ensureKeys();
+
+    /**
+     * @brief Get keys for modification, copying them first if a pass still reads them
+     */
+    static ExtraAttrKeyColumn& writableKeys(std::shared_ptr<ExtraAttrKeyColumn>& keys);
+
+    /**
+     * @brief Re-sort a few source rows whose sort keys changed or which were added
+     * @param rows Source rows to move into place
+     */
+    void resortRows(const std::vector<uint32_t>& rows);
+
+    /**
+     * @brief Create a pass for the current search and sort; any earlier pass becomes stale
+     */
+    std::shared_ptr<Pass> createPass();
+
+    /**
+     * @brief Compute matches, sort order and mapping of a pass
+     *
+     * Returns early if the pass is cancelled.
+     */
+    static void runPass(Pass& pass);
+
+    /**
+     * @brief Run a pass on the worker thread; the result is published from the event loop
+     *
+     * The worker is started on first use. A pass still waiting for it is replaced.
+     */
+    void startPass(const std::shared_ptr<Pass>& pass);
+
+    /**
+     * @brief Worker thread loop: run queued passes until stopWorker() is called
+     */
+    void workerLoop();
+
+    /**
+     * @brief Cancel any pass and join the worker thread (used on destruction)
+     */
+    void stopWorker();
+
+    /**
+     * @brief Publish a worker pass unless a newer one replaced it
+     */
+    void onPassFinished(const std::shared_ptr<Pass>& pass);
+
+    /**
+     * @brief Keep the matches and sort order of a finished pass for later passes
+     */
+    void adoptPassResults(Pass& pass);
+
+    /**
+     * @brief Rebuild keys and mapping inside a model reset
+     * @return Pass to start after the reset on large tables (the mapping is unsorted until then)
+     */
+    std::shared_ptr<Pass> resetMapping();
+
+    /**
+     * @brief Rebuild the source-to-proxy lookup from m_proxyToSource
+     */
+    void rebuildSourceToProxy();
+
+    /**
+     * @brief Publish a new mapping with a single layout change
+     * @param proxyToSource New mapping (swapped in)
+     * @param remapSourceRow Maps old source rows to new ones (-1 if removed); null if unchanged
+     * @return false if the mapping was unchanged and nothing was emitted
+     */
+    bool applyMapping(std::vector<int>& proxyToSource, const std::function<int(int)>& remapSourceRow);
+
+    /**
+     * @brief Recompute the mapping from the current keys and publish it
+     *
+     * Source row changes are applied at once; search and sort changes on
+     * large tables go to a worker pass.
+     */
+    void refresh(const std::function<int(int)>& remapSourceRow = nullptr);
+
+    /**
+     * @brief Refresh once the event loop is reached; further requests until then are merged
+     */
+    void scheduleRefresh();
+
+private:
+    std::vector<QMetaObject::Connection> m_sourceConnections;
+
+    int m_filterColumn;
+    std::string m_foldedSearchText;
+
+    int m_sortColumn;
+    Qt::SortOrder m_sortOrder;
+
+    // Case-folded text of the filter column (shared with running passes)
+    std::shared_ptr<ExtraAttrKeyColumn> m_filterKeys;
+    bool m_filterKeysValid;
+
+    // Typed keys of the sort column (shared with running passes)
+    std::shared_ptr<ExtraAttrKeyColumn> m_sortKeys;
+    bool m_sortKeysValid;
+
+    // Source rows matching m_matchedText, in ascending order
+    std::vector<uint32_t> m_matchedRows;
+    std::string m_matchedText;
+    bool m_matchedValid;
+
+    // All source rows in sort order
+    std::vector<uint32_t> m_sortedRows;
+    bool m_sortedValid;
+
+    std::vector<int> m_proxyToSource;
+    std::vector<int> m_sourceToProxy;
+
+    // Generation of the newest pass; results of older passes are dropped
+    uint64_t m_generation;
+    std::shared_ptr<Pass> m_activePass;
+    bool m_refreshQueued;
+
+    // Single worker thread, fed one pass at a time
+    std::thread m_worker;
+    std::mutex m_workerMutex;
+    std::condition_variable m_workerWake;
+    std::shared_ptr<Pass> m_queuedPass;
+    bool m_stopWorker;
+};
+
+#endif // EXTRA_ATTR_PROXY_MODEL_H
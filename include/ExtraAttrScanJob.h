@@ -0,0 +1,147 @@
+#ifndef EXTRA_ATTR_SCAN_JOB_H
+#define EXTRA_ATTR_SCAN_JOB_H
+
+#include <maya/MCallbackIdArray.h>
+#include <maya/MMessage.h>
+#include <maya/MString.h>
+#include <map>
+#include <memory>
+#include "ExtraAttrScanner.h"
+
+// State of a background scan job
+enum class ScanJobState {
+    kPending,      // Waiting for earlier jobs to finish
+    kRunning,      // Visiting nodes in idle time
+    kDone,         // Results published to the shared index
+    kCancelled,    // Cancelled before completion
+    kFailed        // Could not start the scan
+};
+
+/**
+ * @class ExtraAttrScanJobManager
+ * @brief Runs scene scans incrementally during Maya idle time
+ *
+ * Each job scans into a private scanner and swaps the result into
+ * ExtraAttrScanner::sharedIndex() once every node has been visited, so
+ * readers never see a partially built index. Jobs run one at a time in
+ * the order they were started.
+ *
+ * Scene callbacks drop the shared index and cancel unfinished jobs before
+ * a new scene is created, opened or imported, so no command reads nodes
+ * of the previous scene.
+ */
+class ExtraAttrScanJobManager {
+public:
+    /**
+     * @brief Get singleton instance
+     */
+    static ExtraAttrScanJobManager& instance();
+
+    /**
+     * @brief Start a new background scan
+     * @return Job ID, or -1 on failure
+     */
+    int startScan();
+
+    /**
+     * @brief Get the state and progress of a job
+     * @param jobId Job ID
+     * @param state Output job state
+     * @param processed Output number of visited nodes
+     * @param total Output number of nodes to visit
+     * @return false if the job does not exist
+     */
+    bool getStatus(int jobId, ScanJobState& state, size_t& processed, size_t& total) const;
+
+    /**
+     * @brief Finish a job synchronously
+     * @param jobId Job ID
+     * @return false if the job does not exist or did not complete
+     */
+    bool wait(int jobId);
+
+    /**
+     * @brief Cancel a pending or running job
+     * @param jobId Job ID
+     * @return false if the job does not exist or has already finished
+     */
+    bool cancel(int jobId);
+
+    /**
+     * @brief Register the scene callbacks (call on plugin load)
+     */
+    void installSceneCallbacks();
+
+    /**
+     * @brief Cancel all jobs and remove the idle and scene callbacks (call on plugin unload)
+     */
+    void shutdown();
+
+    /**
+     * @brief Get display name of a job state
+     */
+    static MString stateName(ScanJobState state);
+
+private:
+    ExtraAttrScanJobManager();
+    ~ExtraAttrScanJobManager();
+
+    struct ScanJob {
+        ScanJobState state;
+        std::unique_ptr<ExtraAttrScanner> scanner;
+        size_t processed;
+        size_t total;
+
+        ScanJob() : state(ScanJobState::kPending), processed(0), total(0) {}
+    };
+
+    /**
+     * @brief Maya idle event callback
+     */
+    static void idleCallback(void* clientData);
+
+    /**
+     * @brief Scene callback run before File > New, Open or Import
+     */
+    static void sceneChangingCallback(void* clientData);
+
+    /**
+     * @brief Cancel every pending or running job
+     */
+    void cancelAll();
+
+    /**
+     * @brief Advance the oldest unfinished job within the idle time budget
+     */
+    void processIdle();
+
+    /**
+     * @brief Advance a job by one batch of nodes
+     * @return true when the job has finished
+     */
+    bool stepJob(int jobId, ScanJob& job);
+
+    /**
+     * @brief Swap job results into the shared index
+     */
+    void publish(ScanJob& job);
+
+    /**
+     * @brief Register or remove the idle callback depending on pending work
+     */
+    void updateIdleCallback();
+
+    /**
+     * @brief Get the oldest unfinished job
+     */
+    std::map<int, ScanJob>::iterator nextActiveJob();
+
+private:
+    std::map<int, ScanJob> m_jobs;
+    int m_nextJobId;
+    MCallbackId m_idleCallbackId;
+    bool m_hasIdleCallback;
+    MCallbackIdArray m_sceneCallbackIds;
+};
+
+#endif // EXTRA_ATTR_SCAN_JOB_H
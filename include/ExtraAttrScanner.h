@@ -2,11 +2,20 @@
 #define EXTRA_ATTR_SCANNER_H
 
 #include <maya/MObject.h>
+#include <maya/MObjectHandle.h>
 #include <maya/MString.h>
 #include <maya/MFnAttribute.h>
+#include <maya/MMessage.h>
+#include <maya/MNodeMessage.h>
+#include <maya/MCallbackIdArray.h>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <string>
+#include <cstdint>
 #include <memory>
+#include "ExtraAttrShading.h"
+#include "ExtraAttrTrigramIndex.h"
 
 // Structure to store Extra Attribute information
 struct AttributeInfo {
@@ -34,9 +43,34 @@ struct NodeAttributeValue {
     MString nodeType;          // Node type
     MObject nodeObj;           // Node object
     MString valueStr;          // Attribute value (string representation)
+    double sortNumber;         // Numeric sort key (valid if hasSortNumber)
+    bool hasSortNumber;        // Value is a scalar with a numeric sort key
+    unsigned int typeFlags;    // Shading classification of the node type (MayaUtils::NodeTypeFlag)
+    bool isDriven;             // Value comes from a connection and was left unread (valueStr is empty)
+    unsigned int plugFlags;    // Current plug state (MayaUtils::PlugFlag); the scanned state if the plug is gone
+    bool hasMeshStats;         // Node is a shading node and meshStats is filled
+    MaterialMeshStats meshStats;  // Geometry assigned to the shading node
 
     NodeAttributeValue()
-        : nodeName(""), nodeType(""), nodeObj(MObject::kNullObj), valueStr("") {}
+        : nodeName(""), nodeType(""), nodeObj(MObject::kNullObj), valueStr(""),
+          sortNumber(0.0), hasSortNumber(false), typeFlags(0), isDriven(false), plugFlags(0),
+          hasMeshStats(false) {}
+};
+
+// Entry found by a name or value search
+struct SearchMatch {
+    enum Kind {
+        kAttribute = 0,        // Attribute name matched
+        kNode,                 // Node name matched
+        kValue                 // String attribute value matched
+    };
+
+    Kind kind;                 // What matched
+    MString name;              // Attribute name, node name, or "node.attr" for values
+    MString valueStr;          // Matched value (kValue only)
+
+    SearchMatch()
+        : kind(kAttribute), name(""), valueStr("") {}
 };
 
 /**
@@ -45,15 +79,56 @@ struct NodeAttributeValue {
  */
 class ExtraAttrScanner {
 public:
-    ExtraAttrScanner();
+    // Options for reading node values
+    enum ReadFlag {
+        kReadMeshStats = 1 << 0,        // Measure the geometry assigned to shading nodes
+        kSkipDrivenValues = 1 << 1      // Do not read connected plugs, so no upstream node is evaluated
+    };
+
+    /**
+     * @param watchValueChanges Keep the value index up to date through attribute-changed callbacks
+     */
+    explicit ExtraAttrScanner(bool watchValueChanges = false);
     ~ExtraAttrScanner();
 
+    /**
+     * @brief Get the shared index used by the command and the UI
+     * @return Scanner instance holding the latest published scan
+     */
+    static ExtraAttrScanner& sharedIndex();
+
     /**
      * @brief Scan the entire scene to detect Extra Attributes
      * @return true on success
      */
     bool scanScene();
 
+    /**
+     * @brief Start an incremental scan by collecting the nodes to visit
+     * @return true on success
+     */
+    bool beginIncrementalScan();
+
+    /**
+     * @brief Scan the next batch of collected nodes
+     * @param maxNodes Maximum number of nodes to visit in this step
+     * @return true when all collected nodes have been visited
+     */
+    bool scanStep(unsigned int maxNodes);
+
+    /**
+     * @brief Get progress of the current incremental scan
+     * @param processed Number of nodes visited so far
+     * @param total Number of nodes collected at the start of the scan
+     */
+    void getScanProgress(size_t& processed, size_t& total) const;
+
+    /**
+     * @brief Exchange scan results with another scanner
+     * @param other Scanner to swap with
+     */
+    void swap(ExtraAttrScanner& other);
+
     /**
      * @brief Get the list of detected Extra Attributes
      * @return Map of attribute information keyed by attribute name
@@ -63,15 +138,125 @@ public:
     /**
      * @brief Get the list of nodes using the specified attribute and their values
      * @param attrName Attribute name
+     * @param readFlags Combination of ReadFlag values
      * @return List of nodes and attribute values
      */
-    std::vector<NodeAttributeValue> getNodesWithAttribute(const MString& attrName) const;
+    std::vector<NodeAttributeValue> getNodesWithAttribute(const MString& attrName, unsigned int readFlags = 0) const;
+
+    /**
+     * @brief Read the values of a numeric attribute into a contiguous array
+     * @param attrName Attribute name
+     * @param outValues Output values, one per node that has the attribute (and is read)
+     * @param readFlags Combination of ReadFlag values (kSkipDrivenValues leaves out driven plugs)
+     * @return false if the attribute is not indexed or not a scalar numeric, enum or unit type
+     */
+    bool getNumericValues(const MString& attrName, std::vector<double>& outValues, unsigned int readFlags = 0) const;
+
+    /**
+     * @brief Enable or disable the inverted value index (applies from the next scan)
+     *
+     * When enabled, string, enum, bool and integer attributes get a
+     * value -> node postings index built during the scan. Driven plugs are
+     * left out of the postings and read at lookup time instead; plugs move
+     * in and out of the postings as connections are made and broken. Off by default.
+     */
+    void setValueIndexEnabled(bool enabled);
+
+    /**
+     * @brief Check if the inverted value index is enabled
+     */
+    bool isValueIndexEnabled() const;
+
+    /**
+     * @brief Find nodes whose attribute value equals one of the given values
+     *
+     * Uses the inverted value index when the attribute has one, otherwise
+     * reads and compares every value.
+     *
+     * @param attrName Attribute name
+     * @param values Accepted values (string representation, enum field names)
+     * @param outNodes Output matching nodes
+     * @return false if the attribute is not in the index
+     */
+    bool findNodesWithValues(const MString& attrName, const std::vector<MString>& values,
+                             std::vector<MObject>& outNodes) const;
+
+    /**
+     * @brief Search attribute names, node names and string attribute values
+     *
+     * Uses a trigram index built on the first search after the index changes.
+     *
+     * @param pattern Substring, or regular expression if isRegex is true (case-insensitive)
+     * @param isRegex Treat the pattern as an ECMAScript regular expression
+     * @param outMatches Output matches
+     * @return false if the pattern is not a valid regular expression
+     */
+    bool search(const MString& pattern, bool isRegex, std::vector<SearchMatch>& outMatches);
+
+    /**
+     * @brief Get the nodes recorded for an attribute without reading values
+     *
+     * Nodes deleted since the scan stay in the list; skip handles that are no longer valid.
+     *
+     * @param attrName Attribute name
+     * @return Node list, or nullptr if the attribute is not in the index
+     */
+    const std::vector<MObjectHandle>* getNodeList(const MString& attrName) const;
+
+    /**
+     * @brief Get the plug flags recorded for an attribute, parallel to getNodeList()
+     * @param attrName Attribute name
+     * @return MayaUtils::PlugFlag combination per node, or nullptr if the attribute is not in the index
+     */
+    const std::vector<uint8_t>* getPlugFlagList(const MString& attrName) const;
+
+    /**
+     * @brief Get the nodes whose recorded plug flags match, without reading plugs
+     *
+     * Flags are recorded by the scan and by index edits, not kept up to date
+     * with later connection, lock or value changes; rescan to refresh them.
+     *
+     * @param attrName Attribute name
+     * @param requiredFlags Flags every returned occurrence has
+     * @param excludedFlags Flags no returned occurrence has
+     * @param outNodes Output matching nodes, in index order
+     * @return false if the attribute is not in the index
+     */
+    bool findNodesWithPlugFlags(const MString& attrName, unsigned int requiredFlags, unsigned int excludedFlags,
+                                std::vector<MObject>& outNodes) const;
+
+    /**
+     * @brief Rename an attribute on the given nodes in the index without rescanning
+     * @param oldName Current attribute name
+     * @param newName New attribute name
+     * @param nodes Nodes on which the attribute was renamed
+     */
+    void renameAttribute(const MString& oldName, const MString& newName, const std::vector<MObject>& nodes);
+
+    /**
+     * @brief Remove an attribute from the given nodes in the index without rescanning
+     * @param attrName Attribute name
+     * @param nodes Nodes from which the attribute was removed
+     */
+    void removeAttributeFromNodes(const MString& attrName, const std::vector<MObject>& nodes);
+
+    /**
+     * @brief Add nodes back to an attribute in the index (e.g. after undoing a removal)
+     * @param info Attribute information to restore if the attribute is no longer indexed
+     * @param nodes Nodes that have the attribute again
+     */
+    void restoreAttributeOnNodes(const AttributeInfo& info, const std::vector<MObject>& nodes);
 
     /**
      * @brief Clear cache
      */
     void clearCache();
 
+    /**
+     * @brief Check whether a completed scan is held (cleared by clearCache())
+     */
+    bool hasScanResults() const;
+
     /**
      * @brief Get scan result statistics
      * @param totalAttrs Total number of Extra Attributes
@@ -109,15 +294,104 @@ private:
      */
     MString getAttributeTypeName(const MObject& attr) const;
 
+    /**
+     * @brief Remove nodes from an attribute's node list
+     * @param attrName Attribute name
+     * @param nodes Nodes to remove
+     * @param outFlags Plug flags of the removed nodes, parallel to the result
+     * @return Removed nodes, in index order
+     */
+    std::vector<MObjectHandle> extractNodes(const MString& attrName, const std::vector<MObject>& nodes,
+                                            std::vector<uint8_t>& outFlags);
+
+    /**
+     * @brief Build the search index from the attribute index and current string values
+     */
+    void buildSearchIndex();
+
+    /**
+     * @brief Check if an attribute type gets an inverted value index
+     * @param typeName Type name from getAttributeTypeName()
+     */
+    static bool isValueIndexedType(const MString& typeName);
+
+    /**
+     * @brief Move a node to a new value key in an attribute's value index
+     */
+    void updateValuePosting(const MString& attrName, uint32_t nodeId, const std::string& newValue);
+
+    /**
+     * @brief Move a node between an attribute's postings and its driven nodes
+     * @param driven true if the plug became driven, false if it no longer is
+     * @param value Current value, used when the node returns to the postings
+     */
+    void setValueDriven(const MString& attrName, uint32_t nodeId, bool driven, const std::string& value);
+
+    /**
+     * @brief Register attribute-changed callbacks for nodes in the value index
+     */
+    void installValueCallbacks();
+
+    /**
+     * @brief Remove all attribute-changed callbacks
+     */
+    void removeValueCallbacks();
+
+    /**
+     * @brief Attribute-changed callback keeping the value index up to date
+     */
+    static void attributeChangedCallback(MNodeMessage::AttributeMessage msg, MPlug& plug,
+                                         MPlug& otherPlug, void* clientData);
+
 private:
     // Map of attribute name -> attribute information
     std::map<MString, std::shared_ptr<AttributeInfo>, MStringLess> m_attributeInfoMap;
 
     // Map of attribute name -> node list (cache)
-    std::map<MString, std::vector<MObject>, MStringLess> m_attrToNodesMap;
+    std::map<MString, std::vector<MObjectHandle>, MStringLess> m_attrToNodesMap;
+
+    // Map of attribute name -> MayaUtils::PlugFlag combination per node, parallel to m_attrToNodesMap
+    std::map<MString, std::vector<uint8_t>, MStringLess> m_attrToFlagsMap;
 
     // Total number of scanned nodes
     int m_totalNodesScanned;
+
+    // A scan has completed since the last clearCache()
+    bool m_hasScanResults;
+
+    // Nodes collected for an incremental scan and the position of the next one to visit
+    std::vector<MObjectHandle> m_pendingNodes;
+    size_t m_nextPendingNode;
+
+    // Inverted index of one attribute: value -> IDs of nodes holding that value
+    struct ValueIndex {
+        std::unordered_map<std::string, std::vector<uint32_t>> postings;
+        std::unordered_map<uint32_t, std::string> nodeValues;  // Current value of each node
+        std::vector<uint32_t> drivenNodes;  // Nodes whose plug is driven; not in the postings
+    };
+
+    // Map of attribute name -> inverted value index
+    std::map<MString, ValueIndex, MStringLess> m_valueIndexMap;
+
+    // Node ID -> node, for nodes referenced by the value index
+    std::vector<MObjectHandle> m_nodeTable;
+
+    bool m_valueIndexEnabled;
+    bool m_watchValueChanges;
+
+    // Client data of an attribute-changed callback
+    struct NodeWatch {
+        ExtraAttrScanner* scanner;
+        uint32_t nodeId;
+    };
+
+    std::vector<NodeWatch> m_nodeWatches;
+    MCallbackIdArray m_valueCallbackIds;
+
+    // Trigram index over names and string values, with one entry per document
+    ExtraAttrTrigramIndex m_searchIndex;
+    std::vector<SearchMatch> m_searchEntries;
+    bool m_searchIndexValid;
 };
 
 #endif // EXTRA_ATTR_SCANNER_H
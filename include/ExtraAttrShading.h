@@ -0,0 +1,165 @@
+#ifndef EXTRA_ATTR_SHADING_H
+#define EXTRA_ATTR_SHADING_H
+
+#include <maya/MDagPath.h>
+#include <maya/MObject.h>
+#include <maya/MSelectionList.h>
+#include <maya/MStatus.h>
+#include <maya/MStringArray.h>
+#include <vector>
+
+// Faces of one mesh instance assigned to a set of shading engines
+struct MeshFaceSet {
+    MDagPath meshPath;          // Mesh shape instance
+    std::vector<int> faces;     // Face indices in ascending order
+    int faceCount;              // Number of faces of the mesh
+    bool allFaces;              // Every face of the mesh is included
+
+    MeshFaceSet()
+        : faceCount(0), allFaces(false) {}
+};
+
+// Faces of one mesh instance grouped by the shading nodes they are assigned to
+struct MeshPartition {
+    MDagPath meshPath;              // Mesh shape instance
+    std::vector<MObject> shaders;   // Shading engines connected to the instance
+    std::vector<int> faceShaders;   // Index into shaders per face, or -1
+    std::vector<int> faceGroups;    // Group per face, or -1 when the face is in no group
+    std::vector<int> groupSizes;    // Number of faces per group
+
+    // Set by resolvePartitions: instances of one shape share its geometry
+    int shapeOwner;                 // First partition on the same shape node (own index for the first)
+    int geometrySource;             // First partition on the same shape node with the same face groups
+
+    MeshPartition()
+        : shapeOwner(-1), geometrySource(-1) {}
+};
+
+// Geometry assigned to a shading node
+struct MaterialMeshStats {
+    int faceCount;              // Assigned faces over all mesh instances
+    int triangleCount;          // Triangles of those faces
+    int vertexCount;            // Distinct vertices used by those faces, counted per mesh instance
+    double surfaceArea;         // World-space area of those faces
+
+    MaterialMeshStats()
+        : faceCount(0), triangleCount(0), vertexCount(0), surfaceArea(0.0) {}
+};
+
+/**
+ * @brief Material to geometry resolution through the Maya API
+ *
+ * Materials and textures are mapped to the shading engines they feed,
+ * shading engine members give the meshes, and each mesh's per-face shader
+ * assignment gives the faces. No face names are built along the way.
+ */
+namespace ExtraAttrShading {
+
+/**
+ * @brief Find the shading engines of shading nodes
+ *
+ * A shading engine maps to itself; any other node maps to the shading
+ * engines its outputs are directly connected to.
+ *
+ * @param shadingNodes Materials, textures or shading engines
+ * @param outEngines Output shading engines, without duplicates
+ */
+void findShadingEngines(const std::vector<MObject>& shadingNodes, std::vector<MObject>& outEngines);
+
+/**
+ * @brief Find the mesh instances that are members of shading engines
+ *
+ * Transform members are expanded to their mesh shapes.
+ *
+ * @param engines Shading engines
+ * @param outMeshes Output mesh shape paths, without duplicates
+ */
+void findMemberMeshes(const std::vector<MObject>& engines, std::vector<MDagPath>& outMeshes);
+
+/**
+ * @brief Get the faces of a mesh instance assigned to any of the shading engines
+ * @param meshPath Mesh shape path (the instance selects the per-instance assignment)
+ * @param engines Shading engines
+ * @param outFaceSet Output faces
+ * @return MS::kSuccess, or the failure of the mesh function set
+ */
+MStatus getAssignedFaces(const MDagPath& meshPath, const std::vector<MObject>& engines, MeshFaceSet& outFaceSet);
+
+/**
+ * @brief Group the faces of a mesh instance by shading engine groups
+ *
+ * The per-face shader assignment is read once. A face whose engine is in
+ * several groups goes to the first of them.
+ *
+ * @param meshPath Mesh shape path (the instance selects the per-instance assignment)
+ * @param engineGroups Shading engines of each group
+ * @param outPartition Output grouping
+ * @return MS::kSuccess, or the failure of the mesh function set
+ */
+MStatus getFacePartition(const MDagPath& meshPath, const std::vector<std::vector<MObject>>& engineGroups,
+                         MeshPartition& outPartition);
+
+/**
+ * @brief Get the faces of one group of a partition
+ * @param partition Face grouping
+ * @param group Group index, or -1 for the faces of every group
+ * @param outFaceSet Output faces
+ */
+void getPartitionFaces(const MeshPartition& partition, int group, MeshFaceSet& outFaceSet);
+
+/**
+ * @brief Resolve shading nodes to the faces of each mesh, one group per shading node
+ *
+ * Each instance of a shape gets its own entry, since face assignment is per
+ * instance; shapeOwner and geometrySource link instances of the same shape
+ * so geometry work can be done once per shape.
+ *
+ * @param shadingNodes Materials, textures or shading engines
+ * @param outPartitions Output groupings, one entry per mesh instance with at least one grouped face
+ */
+void resolvePartitions(const std::vector<MObject>& shadingNodes, std::vector<MeshPartition>& outPartitions);
+
+/**
+ * @brief Resolve shading nodes to the faces assigned to them
+ * @param shadingNodes Materials, textures or shading engines
+ * @param outFaceSets Output faces, one entry per mesh instance with at least one face
+ */
+void resolveFaces(const std::vector<MObject>& shadingNodes, std::vector<MeshFaceSet>& outFaceSets);
+
+/**
+ * @brief Resolve shading nodes to the objects assigned to them
+ *
+ * Shape members give their parent transforms; transform members are kept.
+ *
+ * @param shadingNodes Materials, textures or shading engines
+ * @param outObjects Output DAG paths, without duplicates
+ */
+void resolveObjects(const std::vector<MObject>& shadingNodes, MSelectionList& outObjects);
+
+/**
+ * @brief Create a mesh face component
+ * @param faceSet Faces to include (allFaces gives a complete component)
+ * @return kMeshPolygonComponent object
+ */
+MObject createFaceComponent(const MeshFaceSet& faceSet);
+
+/**
+ * @brief Add face sets to a selection list as one component per mesh instance
+ */
+void addFaceSets(const std::vector<MeshFaceSet>& faceSets, MSelectionList& outList);
+
+/**
+ * @brief Name the faces of a face set with contiguous faces coalesced into ranges
+ *
+ * Each run of consecutive faces gives one "mesh.f[first:last]" name (or
+ * "mesh.f[face]" for a single face), so the names never go through a
+ * selection list.
+ *
+ * @param faceSet Faces to name
+ * @param outNames Names appended to, using the full path of the mesh
+ */
+void getFaceRangeNames(const MeshFaceSet& faceSet, MStringArray& outNames);
+
+} // namespace ExtraAttrShading
+
+#endif // EXTRA_ATTR_SHADING_H
@@ -0,0 +1,162 @@
+#ifndef EXTRA_ATTR_SHADING_INDEX_H
+#define EXTRA_ATTR_SHADING_INDEX_H
+
+#include <maya/MCallbackIdArray.h>
+#include <maya/MDagPath.h>
+#include <maya/MMatrix.h>
+#include <maya/MMessage.h>
+#include <maya/MObject.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MPlug.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "ExtraAttrShading.h"
+
+/**
+ * @class ExtraAttrShadingIndex
+ * @brief Cached shading assignment: the member meshes of each shading engine and their faces
+ *
+ * The index is built on first use, reading each mesh's per-face shader
+ * assignment once and storing the faces of every engine as a bitset.
+ * Set-membership and connection callbacks mark single engines dirty, and a
+ * dirty engine is re-read on its next query. Creating or deleting a shading
+ * engine, or a new scene, rebuilds the whole index on next use.
+ *
+ * Mesh statistics are cached per engine and measured again only when the
+ * engine was re-read or one of its member meshes moved.
+ */
+class ExtraAttrShadingIndex {
+public:
+    ExtraAttrShadingIndex();
+    ~ExtraAttrShadingIndex();
+
+    /**
+     * @brief Get the index shared by the command and the UI
+     */
+    static ExtraAttrShadingIndex& sharedIndex();
+
+    /**
+     * @brief Resolve shading nodes to the faces assigned to them
+     * @param shadingNodes Materials, textures or shading engines
+     * @param outFaceSets Output faces, one entry per mesh instance with at least one face
+     */
+    void resolveFaces(const std::vector<MObject>& shadingNodes, std::vector<MeshFaceSet>& outFaceSets);
+
+    /**
+     * @brief Measure the geometry assigned to shading nodes
+     *
+     * Points and face-vertex lists are read on the main thread, once per
+     * shape; counts and areas are then computed on worker threads. A node
+     * fed by a single engine reuses that engine's cached statistics.
+     *
+     * @param shadingNodes Materials, textures or shading engines
+     * @param outStats Output statistics, one per shading node
+     */
+    void computeMeshStats(const std::vector<MObject>& shadingNodes, std::vector<MaterialMeshStats>& outStats);
+
+    /**
+     * @brief Measure every engine again on its next query
+     *
+     * Point edits do not mark an engine dirty, so a full rescan calls this.
+     */
+    void invalidateMeshStats();
+
+    /**
+     * @brief Drop the index and remove its callbacks
+     */
+    void clear();
+
+private:
+    // Faces of one mesh instance assigned to one shading engine
+    struct MeshFaces {
+        MDagPath meshPath;
+        MObjectHandle mesh;
+        std::vector<uint64_t> bits;     // One bit per face
+        int faceCount;                  // Faces of the mesh when the bits were read
+        int assignedCount;              // Set bits
+
+        MeshFaces()
+            : faceCount(0), assignedCount(0) {}
+    };
+
+    struct EngineEntry {
+        MObjectHandle engine;
+        std::vector<MeshFaces> meshes;
+        bool dirty;                     // Membership changed since the meshes were read
+
+        MaterialMeshStats stats;        // Geometry of the meshes (valid if statsValid)
+        std::vector<MMatrix> statsMatrices;  // World matrix of each mesh when stats were measured
+        bool statsValid;
+
+        EngineEntry()
+            : dirty(false), statsValid(false) {}
+    };
+
+    // Faces of one mesh instance over several engines
+    struct InstanceFaces {
+        MDagPath meshPath;
+        MObjectHandle mesh;
+        std::vector<uint64_t> bits;     // One bit per face
+        int faceCount;                  // Faces of the mesh
+    };
+
+    /**
+     * @brief Merge the faces of engines into one bitset per mesh instance
+     * @param engines Shading engines
+     * @param outInstances Output faces, one entry per mesh instance
+     */
+    void collectFaces(const std::vector<MObject>& engines, std::vector<InstanceFaces>& outInstances);
+
+    /**
+     * @brief Read every shading engine and mesh in the scene
+     */
+    void build();
+
+    /**
+     * @brief Add a mesh instance's faces to the engines it is assigned to
+     * @param meshPath Mesh shape path
+     * @param onlyEntry Only update this engine, or nullptr for all of them
+     */
+    void readMesh(const MDagPath& meshPath, EngineEntry* onlyEntry);
+
+    /**
+     * @brief Re-read the members of one engine
+     */
+    void refreshEngine(EngineEntry& entry);
+
+    /**
+     * @brief Check whether a member mesh was deleted or its topology changed
+     */
+    bool isStale(const EngineEntry& entry) const;
+
+    /**
+     * @brief Check whether the cached statistics of an engine still apply
+     */
+    bool hasCurrentStats(const EngineEntry& entry) const;
+
+    /**
+     * @brief Find the entry of a shading engine without refreshing it
+     */
+    EngineEntry* findEngine(const MObject& engine);
+
+    /**
+     * @brief Find the entry of a shading engine, building or refreshing it as needed
+     */
+    EngineEntry* getEngine(const MObject& engine);
+
+    void installCallbacks();
+    void removeCallbacks();
+
+    static void setMembersCallback(MObject& node, void* clientData);
+    static void connectionCallback(MPlug& srcPlug, MPlug& destPlug, bool made, void* clientData);
+    static void engineAddedRemovedCallback(MObject& node, void* clientData);
+    static void sceneCallback(void* clientData);
+
+    std::vector<EngineEntry> m_engines;
+    std::unordered_multimap<unsigned int, size_t> m_engineLookup;  // MObjectHandle hash -> entry
+    bool m_valid;
+    MCallbackIdArray m_callbackIds;
+};
+
+#endif // EXTRA_ATTR_SHADING_INDEX_H
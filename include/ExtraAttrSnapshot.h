@@ -0,0 +1,93 @@
+#ifndef EXTRA_ATTR_SNAPSHOT_H
+#define EXTRA_ATTR_SNAPSHOT_H
+
+#include <maya/MString.h>
+#include <maya/MStringArray.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include "ExtraAttrScanner.h"
+
+/**
+ * @class ExtraAttrSnapshot
+ * @brief Compact, hashed copy of the Extra Attribute index
+ *
+ * Holds one entry per attribute definition (keyed by attribute name,
+ * hashed type name as value) and one entry per node occurrence (keyed by
+ * "node.attr", hashed value string as value). DAG nodes are keyed by their
+ * full path, since short names need not be unique. Entries are sorted by key
+ * hash so two snapshots can be compared with a single linear merge.
+ */
+class ExtraAttrSnapshot {
+public:
+    // Kind of difference reported by diff()
+    enum ChangeType {
+        kAdded = 0,     // Entry only exists in the newer snapshot
+        kRemoved,       // Entry only exists in the older snapshot
+        kChanged        // Entry exists in both with a different value
+    };
+
+    ExtraAttrSnapshot();
+
+    /**
+     * @brief Capture a snapshot of the index and the current attribute values
+     * @param scanner Scanner holding the index
+     * @return New snapshot
+     */
+    static std::shared_ptr<ExtraAttrSnapshot> capture(const ExtraAttrScanner& scanner);
+
+    /**
+     * @brief Compare two snapshots
+     * @param before Older snapshot
+     * @param after Newer snapshot
+     * @param outLines Output lines of the form "+ key", "- key" or "~ key"
+     */
+    static void diff(const ExtraAttrSnapshot& before, const ExtraAttrSnapshot& after, MStringArray& outLines);
+
+    /**
+     * @brief Store a snapshot under a name, replacing any existing one
+     */
+    static void store(const MString& name, const std::shared_ptr<ExtraAttrSnapshot>& snapshot);
+
+    /**
+     * @brief Find a stored snapshot
+     * @return Snapshot, or nullptr if not found
+     */
+    static std::shared_ptr<ExtraAttrSnapshot> find(const MString& name);
+
+    /**
+     * @brief Get number of entries
+     */
+    size_t entryCount() const;
+
+private:
+    struct Entry {
+        uint64_t keyHash;       // Hash of the entry key
+        uint64_t valueHash;     // Hash of the type name or value string
+        uint32_t keyOffset;     // Offset of the null-terminated key in m_keys
+    };
+
+    /**
+     * @brief Append an entry and its key
+     */
+    void addEntry(const char* key, const char* value);
+
+    /**
+     * @brief Get the key of an entry
+     */
+    const char* keyOf(const Entry& entry) const;
+
+    /**
+     * @brief Compare two entries by key hash, then by key
+     * @return Negative, zero or positive
+     */
+    static int compareKeys(const ExtraAttrSnapshot& a, const Entry& ea,
+                           const ExtraAttrSnapshot& b, const Entry& eb);
+
+private:
+    std::vector<Entry> m_entries;
+    std::vector<char> m_keys;
+};
+
+#endif // EXTRA_ATTR_SNAPSHOT_H
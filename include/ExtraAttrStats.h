@@ -0,0 +1,46 @@
+#ifndef EXTRA_ATTR_STATS_H
+#define EXTRA_ATTR_STATS_H
+
+#include <cstddef>
+#include <vector>
+
+// Summary statistics for the values of a numeric attribute
+struct ValueStatistics {
+    size_t count;                   // Number of finite values (all other fields cover only these)
+    size_t skippedCount;            // Non-finite values (inf, NaN) left out
+    double minValue;                // Smallest value
+    double maxValue;                // Largest value
+    double mean;                    // Arithmetic mean
+    double stddev;                  // Population standard deviation
+    size_t distinctCount;           // Number of distinct values
+    std::vector<size_t> histogram;  // Value counts per equal-width bin over [min, max]
+
+    ValueStatistics()
+        : count(0), skippedCount(0), minValue(0.0), maxValue(0.0), mean(0.0),
+          stddev(0.0), distinctCount(0) {}
+};
+
+/**
+ * @brief Utility functions for attribute value statistics
+ */
+namespace ExtraAttrStats {
+
+// Default number of histogram bins
+const int kDefaultHistogramBins = 10;
+
+/**
+ * @brief Compute statistics over a contiguous array of values
+ *
+ * Infinite and NaN values are counted in skippedCount and otherwise ignored.
+ *
+ * @param values Pointer to the first value
+ * @param count Number of values
+ * @param binCount Number of histogram bins
+ * @return Computed statistics (all zero for an empty array)
+ */
+ValueStatistics computeValueStatistics(const double* values, size_t count,
+                                       int binCount = kDefaultHistogramBins);
+
+} // namespace ExtraAttrStats
+
+#endif // EXTRA_ATTR_STATS_H
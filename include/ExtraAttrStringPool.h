@@ -0,0 +1,89 @@
+#ifndef EXTRA_ATTR_STRING_POOL_H
+#define EXTRA_ATTR_STRING_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class ExtraAttrStringPool
+ * @brief Interned UTF-8 strings referenced by 32-bit IDs
+ *
+ * Each distinct string is stored once in a contiguous buffer, so columns
+ * with many repeated values (node types, type names, common values) cost
+ * one ID per row. Equal strings always get the same ID, so IDs from one
+ * pool can be compared instead of the text.
+ */
+class ExtraAttrStringPool {
+public:
+    ExtraAttrStringPool();
+
+    /**
+     * @brief Remove all strings (invalidates all IDs)
+     */
+    void clear();
+
+    /**
+     * @brief Reserve space for a number of strings and text bytes
+     */
+    void reserve(size_t stringCount, size_t textBytes = 0);
+
+    /**
+     * @brief Get the ID of a string, adding it if it is new
+     * @param text UTF-8 bytes
+     * @param length Number of bytes
+     * @return String ID (IDs are numbered from 0 in the order strings were added)
+     */
+    uint32_t intern(const char* text, size_t length);
+    uint32_t intern(const char* text);
+
+    /**
+     * @brief Get the null-terminated text of a string
+     */
+    const char* text(uint32_t id) const;
+
+    /**
+     * @brief Get the length of a string in bytes
+     */
+    size_t length(uint32_t id) const;
+
+    /**
+     * @brief Get number of distinct strings
+     */
+    size_t size() const;
+
+    /**
+     * @brief Drop strings no longer referenced, renumbering IDs in place
+     * @param idColumns Every column holding IDs of this pool
+     */
+    void compact(const std::vector<std::vector<uint32_t>*>& idColumns);
+
+private:
+    struct Entry {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t hash;
+    };
+
+    /**
+     * @brief Hash string bytes (FNV-1a)
+     */
+    static uint32_t hashBytes(const char* text, size_t length);
+
+    /**
+     * @brief Resize the slot table and re-insert all strings
+     */
+    void rehash(size_t slotCount);
+
+private:
+    std::vector<Entry> m_entries;
+
+    // Text of all strings, each followed by '\0'
+    std::string m_text;
+
+    // Open-addressing table of string IDs + 1 (0 marks an empty slot); size is a power of two
+    std::vector<uint32_t> m_slots;
+};
+
+#endif // EXTRA_ATTR_STRING_POOL_H
@@ -0,0 +1,92 @@
+#ifndef EXTRA_ATTR_TRIGRAM_INDEX_H
+#define EXTRA_ATTR_TRIGRAM_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class ExtraAttrTrigramIndex
+ * @brief Case-insensitive trigram index for substring and regex search
+ *
+ * Each document is a string identified by the order in which it was added.
+ * A search first intersects the posting lists of the trigrams the match
+ * requires, then runs the full match only on the remaining candidates.
+ */
+class ExtraAttrTrigramIndex {
+public:
+    ExtraAttrTrigramIndex();
+
+    /**
+     * @brief Remove all documents
+     */
+    void clear();
+
+    /**
+     * @brief Reserve space for a number of documents
+     */
+    void reserve(size_t documentCount);
+
+    /**
+     * @brief Add a document
+     * @param text Document text
+     * @return Document ID (documents are numbered from 0 in insertion order)
+     */
+    uint32_t add(const std::string& text);
+
+    /**
+     * @brief Get number of documents
+     */
+    size_t size() const;
+
+    /**
+     * @brief Find documents containing a substring (case-insensitive)
+     * @param needle Substring to search for; an empty needle matches every document
+     * @param outIds Output document IDs in ascending order
+     */
+    void findSubstring(const std::string& needle, std::vector<uint32_t>& outIds) const;
+
+    /**
+     * @brief Find documents matching an ECMAScript regular expression (case-insensitive)
+     * @param pattern Regular expression, matched anywhere in the document
+     * @param outIds Output document IDs in ascending order
+     * @return false if the pattern is not a valid regular expression
+     */
+    bool findRegex(const std::string& pattern, std::vector<uint32_t>& outIds) const;
+
+private:
+    /**
+     * @brief Collect documents containing every trigram of the given literals
+     * @param literals Lowercase strings that every match must contain
+     * @param outIds Output candidate IDs in ascending order
+     */
+    void findCandidates(const std::vector<std::string>& literals, std::vector<uint32_t>& outIds) const;
+
+    /**
+     * @brief Collect literal runs that every match of a regex must contain
+     * @param pattern Regular expression
+     * @param outLiterals Output lowercase literals
+     * @return false if the pattern cannot be narrowed (e.g. top-level alternation)
+     */
+    static bool extractRequiredLiterals(const std::string& pattern, std::vector<std::string>& outLiterals);
+
+    /**
+     * @brief Lowercase ASCII letters (other bytes are kept as is)
+     */
+    static std::string foldCase(const std::string& text);
+
+    /**
+     * @brief Pack three bytes into a trigram key
+     */
+    static uint32_t trigramKey(const char* p);
+
+private:
+    // Lowercase text of each document
+    std::vector<std::string> m_texts;
+
+    // Trigram key -> IDs of documents containing it, in ascending order
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_postings;
+};
+
+#endif // EXTRA_ATTR_TRIGRAM_INDEX_H
@@ -14,14 +14,16 @@
 #include <QComboBox>
 #include <QRadioButton>
 #include <QButtonGroup>
-#include <QSortFilterProxyModel>
 #include <QDialog>
 #include <QCheckBox>
+#include <QToolButton>
 #include <QDialogButtonBox>
 #include <QFormLayout>
 #include <memory>
+#include <vector>
 
 #include "ExtraAttrModel.h"
+#include "ExtraAttrProxyModel.h"
 #include "ExtraAttrScanner.h"
 
 // Forward declaration
@@ -99,6 +101,11 @@ public:
      */
     static void destroyInstance();
 
+    /**
+     * @brief Reload the UI from the shared index if the window exists
+     */
+    static void notifyIndexChanged();
+
     /**
      * @brief Show UI
      */
@@ -153,11 +160,21 @@ private slots:
      */
     void onDeleteAttribute();
 
+    /**
+     * @brief Delete attribute from all nodes action
+     */
+    void onPurgeAttribute();
+
     /**
      * @brief Add attribute action
      */
     void onAddAttribute();
 
+    /**
+     * @brief Rename attribute on all nodes action
+     */
+    void onRenameAttribute();
+
     /**
      * @brief Batch edit action
      */
@@ -168,6 +185,16 @@ private slots:
      */
     void onSelectNode();
 
+    /**
+     * @brief Select all nodes whose attribute value equals the current node's value
+     */
+    void onSelectNodesWithSameValue();
+
+    /**
+     * @brief Read the values of selected driven nodes, evaluating their inputs
+     */
+    void onEvaluateDrivenValues();
+
     /**
      * @brief Select polygons assigned to material
      */
@@ -188,6 +215,11 @@ private slots:
      */
     void onNodeFilterChanged(const QString& text);
 
+    /**
+     * @brief Handler when the plug flag filter menu is changed
+     */
+    void onPlugFlagFilterChanged();
+
     /**
      * @brief Handler when node table selection is changed
      */
@@ -204,20 +236,35 @@ private:
      */
     QWidget* createToolBar();
 
+    /**
+     * @brief Reload models from the shared index, preserving the selected attribute
+     */
+    void reloadFromIndex();
+
+    /**
+     * @brief Reload node values of the current attribute into the node table
+     */
+    void refreshNodeValues();
+
+    /**
+     * @brief Show the rows of m_nodeValues that pass the plug flag filter
+     */
+    void applyPlugFlagFilter();
+
     /**
      * @brief Update statistics
      */
     void updateStatistics();
 
     /**
-     * @brief Set attribute value using Maya API
+     * @brief Update value statistics of the current attribute (numeric attributes only)
      */
-    bool setAttributeValue(const QString& nodeName, const QString& attrName, const QString& value);
+    void updateValueStatistics();
 
     /**
-     * @brief Delete attribute using Maya API
+     * @brief Set attribute value using Maya API
      */
-    bool deleteAttribute(const QString& nodeName, const QString& attrName);
+    bool setAttributeValue(const QString& nodeName, const QString& attrName, const QString& value);
 
     /**
      * @brief Add attribute using Maya API
@@ -230,14 +277,34 @@ private:
     bool selectNodeInMaya(const QString& nodeName);
 
     /**
-     * @brief Check if node is a shading node (material)
+     * @brief Check if the node at a node model row is a shading node (material, texture, shading engine)
+     * @param sourceRow Row in m_nodeModel
      */
-    bool isShadingNode(const QString& nodeName);
+    bool isShadingRow(int sourceRow) const;
 
     /**
-     * @brief Select polygons assigned to material
+     * @brief Select the polygons assigned to materials, as one face component per mesh
+     * @param materialNames Materials, textures or shading engines
+     * @return false if the selection could not be set
      */
-    bool selectPolygonsWithMaterial(const QString& materialName);
+    bool selectPolygonsWithMaterials(const QStringList& materialNames);
+
+    /**
+     * @brief Select the objects assigned to materials (the materials themselves if there are none)
+     * @param materialNames Materials, textures or shading engines
+     */
+    void selectObjectsWithMaterials(const QStringList& materialNames);
+
+    /**
+     * @brief Resolve node names to nodes, skipping names that no longer exist
+     */
+    static std::vector<MObject> getNodeObjects(const QStringList& nodeNames);
+
+    /**
+     * @brief Enable an outlinerEditor flag in all outliner panels
+     * @param flag Flag name, e.g. "showSelected"
+     */
+    static void editOutliners(const char* flag);
 
 private:
     // Singleton instance
@@ -252,21 +319,28 @@ private:
     QRadioButton* m_filterNodeTypeRadio;    // Filter by node type
     QRadioButton* m_filterValueRadio;       // Filter by value
     QButtonGroup* m_filterButtonGroup;      // Radio button group
+    QToolButton* m_plugFlagButton;          // Plug flag filter menu
+    std::vector<QAction*> m_requireFlagActions;   // Checked: rows must have the flag (data = PlugFlag)
+    std::vector<QAction*> m_excludeFlagActions;   // Checked: rows must not have the flag (data = PlugFlag)
     QPushButton* m_scanButton;              // Scan button
     QLabel* m_statsLabel;                   // Statistics label
+    QLabel* m_valueStatsLabel;              // Value statistics of the current attribute
 
     // Data models
     ExtraAttrModel* m_attributeModel;
     NodeAttributeModel* m_nodeModel;
-    QSortFilterProxyModel* m_attributeProxyModel;
-    QSortFilterProxyModel* m_nodeProxyModel;
+    ExtraAttrProxyModel* m_attributeProxyModel;
+    ExtraAttrProxyModel* m_nodeProxyModel;
 
-    // Scanner
-    std::unique_ptr<ExtraAttrScanner> m_scanner;
+    // Shared index (owned by ExtraAttrScanner::sharedIndex())
+    ExtraAttrScanner* m_scanner;
 
     // Currently selected attribute name
     QString m_currentAttributeName;
 
+    // Last read rows of the current attribute, before the plug flag filter
+    std::vector<NodeAttributeValue> m_nodeValues;
+
     // Original data for filtering
     QList<int> m_filteredRows;
 };
@@ -0,0 +1,82 @@
+#ifndef EXTRA_ATTR_VALUE_CODEC_H
+#define EXTRA_ATTR_VALUE_CODEC_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Locale-independent text encoding of attribute values
+ *
+ * Numbers are written in the shortest form that parses back to the same
+ * value (std::to_chars) and read with std::from_chars, so a format/parse
+ * round trip of the formatted number is exact regardless of the user's
+ * locale. Callers that convert before formatting (unit attributes are shown
+ * in UI units) only get the number back that they formatted; converting it
+ * back may differ from the original in the last bits.
+ *
+ * Text forms:
+ *   bool                 : "true" / "false" (parse also accepts "1" / "0")
+ *   scalars              : "1.5", "-3"
+ *   tuples and matrices  : components separated by spaces, e.g. "1 2 3"
+ *   arrays               : elements separated by ", ", e.g. "1, 2, 3"
+ *                          or "0 0 1, 0 1 0" for point and vector arrays
+ *   string arrays        : double-quoted elements, '"' and '\' escaped with '\'
+ *
+ * List parsers also accept commas, brackets and parentheses as separators.
+ */
+namespace ExtraAttrValueCodec {
+
+// Separator between array elements
+const char* const kElementSeparator = ", ";
+
+/**
+ * @brief Append a single value
+ */
+void appendBool(std::string& out, bool value);
+void appendInt(std::string& out, long long value);
+void appendFloat(std::string& out, float value);
+void appendDouble(std::string& out, double value);
+
+/**
+ * @brief Append a list of numbers
+ * @param values First value
+ * @param count Number of values
+ * @param tupleSize Components per element (1 for plain arrays; all values form one tuple if equal to count)
+ */
+void appendDoubles(std::string& out, const double* values, size_t count, size_t tupleSize);
+void appendFloats(std::string& out, const float* values, size_t count, size_t tupleSize);
+void appendInts(std::string& out, const int* values, size_t count);
+
+/**
+ * @brief Append a double-quoted, escaped string
+ */
+void appendQuotedString(std::string& out, const char* value, size_t length);
+
+/**
+ * @brief Parse a single value, ignoring surrounding whitespace
+ * @return false if the text is not exactly one valid value
+ */
+bool parseBool(const char* text, bool& out);
+bool parseShort(const char* text, short& out);
+bool parseInt(const char* text, int& out);
+bool parseFloat(const char* text, float& out);
+bool parseDouble(const char* text, double& out);
+
+/**
+ * @brief Parse a list of numbers
+ * @return false if the text contains anything other than numbers and separators
+ */
+bool parseDoubles(const char* text, std::vector<double>& out);
+bool parseFloats(const char* text, std::vector<float>& out);
+bool parseInts(const char* text, std::vector<int>& out);
+
+/**
+ * @brief Parse a list of double-quoted strings
+ * @return false on an unterminated string or text outside quotes
+ */
+bool parseQuotedStrings(const char* text, std::vector<std::string>& out);
+
+} // namespace ExtraAttrValueCodec
+
+#endif // EXTRA_ATTR_VALUE_CODEC_H
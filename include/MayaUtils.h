@@ -6,12 +6,59 @@
 #include <maya/MFnDependencyNode.h>
 #include <maya/MPlug.h>
 #include <maya/MStatus.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Name <-> value lookup table of an enum attribute
+struct EnumFieldTable {
+    std::vector<MString> names;                              // Field names in value order
+    std::vector<short> values;                               // Field values, parallel to names
+    std::unordered_map<std::string, short> valueByName;     // Field name -> value
+    std::unordered_map<short, size_t> indexByValue;         // Field value -> index in names
+    short minValue;                                          // Value range the fields were read from
+    short maxValue;
+
+    EnumFieldTable()
+        : minValue(0), maxValue(0) {}
+
+    /**
+     * @brief Find the value of a field name
+     * @return false if no field has this name
+     */
+    bool findValue(const MString& name, short& outValue) const;
+
+    /**
+     * @brief Find the field name of a value
+     * @return false if no field has this value
+     */
+    bool findName(short value, MString& outName) const;
+};
 
 /**
  * @brief Utility functions for Maya API operations
  */
 namespace MayaUtils {
 
+// Shading classification of a node type (see getNodeTypeFlags)
+enum NodeTypeFlag {
+    kNodeTypeShadingEngine = 1 << 0,    // shadingEngine set
+    kNodeTypeMaterial = 1 << 1,         // Surface, volume or displacement shader
+    kNodeTypeTexture = 1 << 2,          // 2D, 3D or environment texture
+    kNodeTypeShading = kNodeTypeShadingEngine | kNodeTypeMaterial | kNodeTypeTexture
+};
+
+// State of an attribute occurrence on one node (see getPlugFlags)
+enum PlugFlag {
+    kPlugConnected = 1 << 0,            // Plug, a child or an element has a connection
+    kPlugAnimated = 1 << 1,             // Plug, a child or an element is driven by an animation curve
+    kPlugLocked = 1 << 2,               // Plug is locked
+    kPlugKeyable = 1 << 3,              // Plug is keyable
+    kPlugDefault = 1 << 4,              // Plug holds the attribute's default value
+    kPlugAll = kPlugConnected | kPlugAnimated | kPlugLocked | kPlugKeyable | kPlugDefault
+};
+
 /**
  * @brief Get a dependency node from its name
  * @param nodeName Name of the node
@@ -28,15 +75,138 @@ bool getNodeFromName(const MString& nodeName, MObject& outNode);
  */
 bool getDependencyNodeFromName(const MString& nodeName, MFnDependencyNode& outFnDep);
 
+/**
+ * @brief Get attribute value as string representation
+ *
+ * Covers the scalar, tuple, unit (in UI units), matrix and array types;
+ * the text round-trips through setAttributeValueFromString. The round trip
+ * is exact except for unit values, which pass through a UI unit conversion
+ * both ways and may differ in the last bits.
+ *
+ * @param plug MPlug to read
+ * @param attr MObject of the attribute
+ * @return String representation of the value
+ */
+MString getPlugValueAsString(const MPlug& plug, const MObject& attr);
+
+/**
+ * @brief Check whether a plug's value comes from a connection
+ *
+ * Animation curves, expressions, constraints and other incoming
+ * connections all count; reading such a plug may evaluate the nodes
+ * upstream of it. Compound children and array elements are checked too.
+ *
+ * @param plug MPlug to check
+ * @return true if the plug or one of its children or elements is a destination
+ */
+bool isPlugDriven(const MPlug& plug);
+
+/**
+ * @brief Get the connection, lock, keyable and default state of a plug
+ *
+ * Only plug state is queried; the default check does not force
+ * evaluation, so a driven plug compares its last computed value.
+ *
+ * @param plug MPlug to check
+ * @return Combination of PlugFlag values
+ */
+unsigned int getPlugFlags(const MPlug& plug);
+
+/**
+ * @brief Parse plug flag names into a PlugFlag combination
+ * @param names Names separated by spaces or commas: connected, animated, locked, keyable, default
+ * @param outFlags Output flags
+ * @return false if a name is not recognized
+ */
+bool parsePlugFlagNames(const MString& names, unsigned int& outFlags);
+
+/**
+ * @brief Check whether a name is a valid attribute name
+ *
+ * Attribute names are ASCII letters, digits and underscores and do not
+ * start with a digit.
+ */
+bool isValidAttributeName(const MString& name);
+
+/**
+ * @brief Quote text as a MEL string literal
+ *
+ * Backslashes, double quotes and line breaks are escaped, so the result can
+ * be placed in a command string as one argument.
+ *
+ * @return Text in double quotes
+ */
+MString quoteMelString(const MString& text);
+
+/**
+ * @brief Get a numeric sort key for a scalar attribute value
+ *
+ * Booleans give 0 or 1, unit types are read in UI units and enum values give
+ * the position of their field, so sorting by the key matches the displayed order.
+ *
+ * @param plug MPlug to read
+ * @param attr MObject of the attribute
+ * @param outValue Output sort key
+ * @return false if the type has no single numeric value (strings, tuples, arrays, ...)
+ */
+bool getPlugSortNumber(const MPlug& plug, const MObject& attr, double& outValue);
+
 /**
  * @brief Set attribute value from string representation
  * @param plug MPlug to set value on
  * @param attr MObject of the attribute
- * @param value String representation of the value
- * @return true on success, false on failure
+ * @param value String representation of the value (see ExtraAttrValueCodec)
+ * @return true on success, false if the text is not a valid value for the type
  */
 bool setAttributeValueFromString(MPlug& plug, const MObject& attr, const MString& value);
 
+/**
+ * @brief Get the cached field table of an enum attribute, building it on first use
+ *
+ * No callback keeps the cache current on its own. Instead, each lookup
+ * rebuilds a cached table whose value range or first or last field no
+ * longer match the attribute, and drops tables of attributes that have been
+ * deleted (an added attribute is a new object with no table yet). The cache
+ * is cleared by a full scan, on scene changes and once it holds too many
+ * attributes.
+ *
+ * @param attr MObject of the attribute
+ * @param refresh Rebuild the table even if it is cached
+ * @return Field table, or nullptr if the attribute is not an enum
+ */
+std::shared_ptr<const EnumFieldTable> getEnumFieldTable(const MObject& attr, bool refresh = false);
+
+/**
+ * @brief Drop the cached field table of an enum attribute
+ *
+ * Called by the value index callbacks when they see an attribute added or
+ * removed; an early release only, since lookups validate tables themselves.
+ *
+ * @param attr MObject of the attribute
+ */
+void invalidateEnumFieldTable(const MObject& attr);
+
+/**
+ * @brief Drop all cached enum field tables
+ */
+void clearEnumFieldTables();
+
+/**
+ * @brief Get the shading classification of a node's type
+ *
+ * Computed once per node type from the type's classification string and
+ * the MFn type hierarchy, then served from a cache keyed by type ID.
+ *
+ * @param fnDep Function set attached to the node
+ * @return Combination of NodeTypeFlag values (0 for non-shading nodes)
+ */
+unsigned int getNodeTypeFlags(const MFnDependencyNode& fnDep);
+
+/**
+ * @brief Drop the cached node type classifications
+ */
+void clearNodeTypeFlags();
+
 } // namespace MayaUtils
 
 #endif // MAYA_UTILS_H
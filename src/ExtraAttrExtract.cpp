@@ -0,0 +1,867 @@
+#include "ExtraAttrExtract.h"
+#include <maya/MColor.h>
+#include <maya/MColorArray.h>
+#include <maya/MDoubleArray.h>
+#include <maya/MFloatArray.h>
+#include <maya/MFloatPointArray.h>
+#include <maya/MFloatVectorArray.h>
+#include <maya/MFnMesh.h>
+#include <maya/MFnSet.h>
+#include <maya/MFnSingleIndexedComponent.h>
+#include <maya/MFnTransform.h>
+#include <maya/MIntArray.h>
+#include <maya/MMatrix.h>
+#include <maya/MStringArray.h>
+#include <maya/MTransformationMatrix.h>
+#include <maya/MUintArray.h>
+#include <maya/MVector.h>
+#include <maya/MVectorArray.h>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// Copy a Maya array into a vector
+template <typename MayaArray, typename T>
+void copyArray(const MayaArray& source, std::vector<T>& dest)
+{
+    dest.resize(source.length());
+    if (!dest.empty()) {
+        source.get(dest.data());
+    }
+}
+
+// Key of an undirected edge between two vertices
+uint64_t edgeKey(int v0, int v1)
+{
+    if (v0 > v1) {
+        std::swap(v0, v1);
+    }
+    return (static_cast<uint64_t>(static_cast<uint32_t>(v0)) << 32) | static_cast<uint32_t>(v1);
+}
+
+// Index of the first face-vertex of every face, plus the total at the end
+std::vector<int> prefixOffsets(const std::vector<int>& counts)
+{
+    std::vector<int> offsets(counts.size() + 1, 0);
+    for (size_t i = 0; i < counts.size(); ++i) {
+        offsets[i + 1] = offsets[i] + counts[i];
+    }
+    return offsets;
+}
+
+// Renumber an index on first use
+int remapIndex(std::vector<int>& map, int oldIndex, int& nextIndex)
+{
+    int& newIndex = map[oldIndex];
+    if (newIndex < 0) {
+        newIndex = nextIndex++;
+    }
+    return newIndex;
+}
+
+// Keep vertex pairs whose vertices are both part of the subset
+void remapEdges(const std::vector<int>& edges, const std::vector<double>* values, const std::vector<int>& vertexMap,
+                std::vector<int>& outEdges, std::vector<double>* outValues)
+{
+    for (size_t i = 0; i + 1 < edges.size(); i += 2) {
+        int v0 = vertexMap[edges[i]];
+        int v1 = vertexMap[edges[i + 1]];
+        if (v0 < 0 || v1 < 0) {
+            continue;
+        }
+        outEdges.push_back(v0);
+        outEdges.push_back(v1);
+        if (values) {
+            outValues->push_back((*values)[i / 2]);
+        }
+    }
+}
+
+// Face-vertex offsets of a mesh, shared by every subset taken from it
+struct SourceOffsets {
+    std::vector<int> faces;
+    std::vector<std::vector<int>> uvSets;
+
+    explicit SourceOffsets(const MeshBuffers& source)
+        : faces(prefixOffsets(source.polygonCounts))
+    {
+        for (const MeshUVSet& uvSet : source.uvSets) {
+            uvSets.push_back(prefixOffsets(uvSet.uvCounts));
+        }
+    }
+};
+
+/**
+ * @brief Copies faces of a source mesh into new buffers
+ *
+ * Faces must be added in ascending order. Vertices and UVs are renumbered
+ * in order of first use; per-vertex and per-UV data is filled in finish().
+ */
+class SubsetBuilder {
+public:
+    SubsetBuilder(const MeshBuffers& source, const SourceOffsets& offsets, MeshBuffers& outMesh)
+        : m_source(source)
+        , m_offsets(offsets)
+        , m_out(outMesh)
+        , m_vertexMap(source.vertexCount(), -1)
+        , m_nextVertex(0)
+        , m_uvMaps(source.uvSets.size())
+        , m_nextUVs(source.uvSets.size(), 0)
+    {
+        m_out.clear();
+        m_out.uvSets.resize(source.uvSets.size());
+        for (size_t i = 0; i < source.uvSets.size(); ++i) {
+            m_out.uvSets[i].name = source.uvSets[i].name;
+        }
+    }
+
+    void addFace(int face)
+    {
+        // Topology, and the source face-vertex of every new face-vertex
+        int count = m_source.polygonCounts[face];
+        int start = m_offsets.faces[face];
+        m_out.polygonCounts.push_back(count);
+        for (int fv = start; fv < start + count; ++fv) {
+            m_out.polygonConnects.push_back(remapIndex(m_vertexMap, m_source.polygonConnects[fv], m_nextVertex));
+            m_sourceFaceVertices.push_back(fv);
+        }
+
+        for (size_t i = 0; i < m_source.uvSets.size(); ++i) {
+            const MeshUVSet& sourceSet = m_source.uvSets[i];
+            MeshUVSet& uvSet = m_out.uvSets[i];
+            if (m_uvMaps[i].empty() && !sourceSet.u.empty()) {
+                m_uvMaps[i].assign(sourceSet.u.size(), -1);
+            }
+
+            int uvCount = sourceSet.uvCounts[face];
+            int uvStart = m_offsets.uvSets[i][face];
+            uvSet.uvCounts.push_back(uvCount);
+            for (int uv = uvStart; uv < uvStart + uvCount; ++uv) {
+                uvSet.uvIds.push_back(remapIndex(m_uvMaps[i], sourceSet.uvIds[uv], m_nextUVs[i]));
+            }
+        }
+    }
+
+    void finish()
+    {
+        m_out.points.resize(static_cast<size_t>(m_nextVertex) * 3);
+        for (int vertex = 0; vertex < m_source.vertexCount(); ++vertex) {
+            int newVertex = m_vertexMap[vertex];
+            if (newVertex >= 0) {
+                std::copy(&m_source.points[vertex * 3], &m_source.points[vertex * 3] + 3, &m_out.points[newVertex * 3]);
+            }
+        }
+
+        for (size_t i = 0; i < m_source.uvSets.size(); ++i) {
+            const MeshUVSet& sourceSet = m_source.uvSets[i];
+            MeshUVSet& uvSet = m_out.uvSets[i];
+            uvSet.u.resize(m_nextUVs[i]);
+            uvSet.v.resize(m_nextUVs[i]);
+            for (size_t uv = 0; uv < m_uvMaps[i].size(); ++uv) {
+                int newUV = m_uvMaps[i][uv];
+                if (newUV >= 0) {
+                    uvSet.u[newUV] = sourceSet.u[uv];
+                    uvSet.v[newUV] = sourceSet.v[uv];
+                }
+            }
+        }
+        m_out.currentUVSet = m_source.currentUVSet;
+
+        m_out.colorSets.resize(m_source.colorSets.size());
+        for (size_t i = 0; i < m_source.colorSets.size(); ++i) {
+            const MeshColorSet& sourceSet = m_source.colorSets[i];
+            MeshColorSet& colorSet = m_out.colorSets[i];
+            colorSet.name = sourceSet.name;
+            colorSet.clamped = sourceSet.clamped;
+            colorSet.representation = sourceSet.representation;
+
+            colorSet.rgba.resize(m_sourceFaceVertices.size() * 4);
+            colorSet.assigned.resize(m_sourceFaceVertices.size());
+            for (size_t fv = 0; fv < m_sourceFaceVertices.size(); ++fv) {
+                int sourceFv = m_sourceFaceVertices[fv];
+                std::copy(&sourceSet.rgba[sourceFv * 4], &sourceSet.rgba[sourceFv * 4] + 4, &colorSet.rgba[fv * 4]);
+                colorSet.assigned[fv] = sourceSet.assigned[sourceFv];
+            }
+        }
+        m_out.currentColorSet = m_source.currentColorSet;
+
+        remapEdges(m_source.hardEdges, nullptr, m_vertexMap, m_out.hardEdges, nullptr);
+        remapEdges(m_source.creaseEdges, &m_source.creaseEdgeValues, m_vertexMap,
+                   m_out.creaseEdges, &m_out.creaseEdgeValues);
+
+        for (size_t i = 0; i < m_source.creaseVertices.size(); ++i) {
+            int vertex = m_vertexMap[m_source.creaseVertices[i]];
+            if (vertex >= 0) {
+                m_out.creaseVertices.push_back(vertex);
+                m_out.creaseVertexValues.push_back(m_source.creaseVertexValues[i]);
+            }
+        }
+
+        // Faces are ascending, so both face-vertex lists are too and a merge matches them
+        const std::vector<int>& lockedFaceVertices = m_source.lockedNormalFaceVertices;
+        size_t locked = 0;
+        for (size_t fv = 0; fv < m_sourceFaceVertices.size() && locked < lockedFaceVertices.size(); ++fv) {
+            while (locked < lockedFaceVertices.size() && lockedFaceVertices[locked] < m_sourceFaceVertices[fv]) {
+                ++locked;
+            }
+            if (locked < lockedFaceVertices.size() && lockedFaceVertices[locked] == m_sourceFaceVertices[fv]) {
+                m_out.lockedNormalFaceVertices.push_back(static_cast<int>(fv));
+                const float* normal = &m_source.lockedNormals[locked * 3];
+                m_out.lockedNormals.insert(m_out.lockedNormals.end(), normal, normal + 3);
+            }
+        }
+    }
+
+private:
+    const MeshBuffers& m_source;
+    const SourceOffsets& m_offsets;
+    MeshBuffers& m_out;
+
+    std::vector<int> m_vertexMap;
+    int m_nextVertex;
+    std::vector<std::vector<int>> m_uvMaps;
+    std::vector<int> m_nextUVs;
+    std::vector<int> m_sourceFaceVertices;
+};
+
+void readUVSets(MFnMesh& fnMesh, MeshBuffers& outMesh)
+{
+    MStringArray uvSetNames;
+    fnMesh.getUVSetNames(uvSetNames);
+    outMesh.uvSets.resize(uvSetNames.length());
+
+    for (unsigned int i = 0; i < uvSetNames.length(); ++i) {
+        MeshUVSet& uvSet = outMesh.uvSets[i];
+        uvSet.name = uvSetNames[i];
+
+        MFloatArray u, v;
+        fnMesh.getUVs(u, v, &uvSet.name);
+        copyArray(u, uvSet.u);
+        copyArray(v, uvSet.v);
+
+        MIntArray uvCounts, uvIds;
+        fnMesh.getAssignedUVs(uvCounts, uvIds, &uvSet.name);
+        copyArray(uvCounts, uvSet.uvCounts);
+        copyArray(uvIds, uvSet.uvIds);
+    }
+
+    fnMesh.getCurrentUVSetName(outMesh.currentUVSet);
+}
+
+void readColorSets(MFnMesh& fnMesh, MeshBuffers& outMesh)
+{
+    MStringArray colorSetNames;
+    fnMesh.getColorSetNames(colorSetNames);
+    outMesh.colorSets.resize(colorSetNames.length());
+
+    // Face-vertices without a color come back as the unset color
+    const MColor unsetColor(-1.0f, -1.0f, -1.0f, -1.0f);
+
+    for (unsigned int i = 0; i < colorSetNames.length(); ++i) {
+        MeshColorSet& colorSet = outMesh.colorSets[i];
+        colorSet.name = colorSetNames[i];
+        colorSet.clamped = fnMesh.isColorClamped(colorSet.name);
+        colorSet.representation = static_cast<int>(fnMesh.getColorRepresentation(colorSet.name));
+
+        MColorArray colors;
+        fnMesh.getFaceVertexColors(colors, &colorSet.name, &unsetColor);
+
+        unsigned int count = colors.length();
+        colorSet.rgba.resize(count * 4);
+        colorSet.assigned.resize(count);
+        for (unsigned int fv = 0; fv < count; ++fv) {
+            const MColor& color = colors[fv];
+            colorSet.rgba[fv * 4] = color.r;
+            colorSet.rgba[fv * 4 + 1] = color.g;
+            colorSet.rgba[fv * 4 + 2] = color.b;
+            colorSet.rgba[fv * 4 + 3] = color.a;
+            colorSet.assigned[fv] = !(color == unsetColor);
+        }
+    }
+
+    if (!outMesh.colorSets.empty()) {
+        fnMesh.getCurrentColorSetName(outMesh.currentColorSet);
+    }
+}
+
+void readEdges(MFnMesh& fnMesh, MeshBuffers& outMesh)
+{
+    int numEdges = fnMesh.numEdges();
+    for (int edge = 0; edge < numEdges; ++edge) {
+        if (fnMesh.isEdgeSmooth(edge)) {
+            continue;
+        }
+        int2 vertices;
+        fnMesh.getEdgeVertices(edge, vertices);
+        outMesh.hardEdges.push_back(vertices[0]);
+        outMesh.hardEdges.push_back(vertices[1]);
+    }
+
+    MUintArray edgeIds;
+    MDoubleArray edgeValues;
+    fnMesh.getCreaseEdges(edgeIds, edgeValues);
+    for (unsigned int i = 0; i < edgeIds.length(); ++i) {
+        int2 vertices;
+        fnMesh.getEdgeVertices(static_cast<int>(edgeIds[i]), vertices);
+        outMesh.creaseEdges.push_back(vertices[0]);
+        outMesh.creaseEdges.push_back(vertices[1]);
+        outMesh.creaseEdgeValues.push_back(edgeValues[i]);
+    }
+
+    MUintArray vertexIds;
+    MDoubleArray vertexValues;
+    fnMesh.getCreaseVertices(vertexIds, vertexValues);
+    outMesh.creaseVertices.resize(vertexIds.length());
+    for (unsigned int i = 0; i < vertexIds.length(); ++i) {
+        outMesh.creaseVertices[i] = static_cast<int>(vertexIds[i]);
+    }
+    copyArray(vertexValues, outMesh.creaseVertexValues);
+}
+
+void readLockedNormals(MFnMesh& fnMesh, MeshBuffers& outMesh)
+{
+    int numNormals = fnMesh.numNormals();
+    std::vector<char> locked(numNormals, 0);
+    bool anyLocked = false;
+    for (int normal = 0; normal < numNormals; ++normal) {
+        if (fnMesh.isNormalLocked(normal)) {
+            locked[normal] = 1;
+            anyLocked = true;
+        }
+    }
+    if (!anyLocked) {
+        return;
+    }
+
+    MFloatVectorArray normals;
+    fnMesh.getNormals(normals, MSpace::kObject);
+    MIntArray normalCounts, normalIds;
+    fnMesh.getNormalIds(normalCounts, normalIds);
+
+    for (unsigned int fv = 0; fv < normalIds.length(); ++fv) {
+        int normal = normalIds[fv];
+        if (normal < 0 || normal >= numNormals || !locked[normal]) {
+            continue;
+        }
+        outMesh.lockedNormalFaceVertices.push_back(static_cast<int>(fv));
+        outMesh.lockedNormals.push_back(normals[normal].x);
+        outMesh.lockedNormals.push_back(normals[normal].y);
+        outMesh.lockedNormals.push_back(normals[normal].z);
+    }
+}
+
+void writeUVSets(MFnMesh& fnMesh, const MeshBuffers& mesh)
+{
+    for (size_t i = 0; i < mesh.uvSets.size(); ++i) {
+        const MeshUVSet& uvSet = mesh.uvSets[i];
+        MString name = uvSet.name;
+
+        // A new mesh starts with one UV set; reuse it for the first one
+        if (i == 0) {
+            MString defaultName;
+            fnMesh.getCurrentUVSetName(defaultName);
+            if (defaultName != name) {
+                fnMesh.renameUVSet(defaultName, name);
+            }
+        } else {
+            name = fnMesh.createUVSetWithName(name);
+        }
+
+        MFloatArray u(uvSet.u.data(), static_cast<unsigned int>(uvSet.u.size()));
+        MFloatArray v(uvSet.v.data(), static_cast<unsigned int>(uvSet.v.size()));
+        fnMesh.setUVs(u, v, &name);
+
+        MIntArray uvCounts(uvSet.uvCounts.data(), static_cast<unsigned int>(uvSet.uvCounts.size()));
+        MIntArray uvIds(uvSet.uvIds.data(), static_cast<unsigned int>(uvSet.uvIds.size()));
+        fnMesh.assignUVs(uvCounts, uvIds, &name);
+    }
+
+    if (mesh.currentUVSet.length() > 0) {
+        fnMesh.setCurrentUVSetName(mesh.currentUVSet);
+    }
+}
+
+void writeColorSets(MFnMesh& fnMesh, const MeshBuffers& mesh)
+{
+    for (const MeshColorSet& colorSet : mesh.colorSets) {
+        MFnMesh::MColorRepresentation representation =
+            static_cast<MFnMesh::MColorRepresentation>(colorSet.representation);
+        MString name = fnMesh.createColorSetWithName(colorSet.name, nullptr, colorSet.clamped, representation);
+
+        // One color per assigned face-vertex
+        MColorArray colors;
+        MIntArray colorIds(static_cast<unsigned int>(colorSet.assigned.size()), -1);
+        int nextColor = 0;
+        for (size_t fv = 0; fv < colorSet.assigned.size(); ++fv) {
+            if (!colorSet.assigned[fv]) {
+                continue;
+            }
+            const float* rgba = &colorSet.rgba[fv * 4];
+            colors.append(MColor(rgba[0], rgba[1], rgba[2], rgba[3]));
+            colorIds[static_cast<unsigned int>(fv)] = nextColor++;
+        }
+
+        fnMesh.setColors(colors, &name, representation);
+        fnMesh.assignColors(colorIds, &name);
+    }
+
+    if (mesh.currentColorSet.length() > 0) {
+        fnMesh.setCurrentColorSetName(mesh.currentColorSet);
+    }
+}
+
+void writeEdges(MFnMesh& fnMesh, const MeshBuffers& mesh)
+{
+    std::unordered_set<uint64_t> hardEdges;
+    for (size_t i = 0; i + 1 < mesh.hardEdges.size(); i += 2) {
+        hardEdges.insert(edgeKey(mesh.hardEdges[i], mesh.hardEdges[i + 1]));
+    }
+    std::unordered_map<uint64_t, double> creaseEdges;
+    for (size_t i = 0; i + 1 < mesh.creaseEdges.size(); i += 2) {
+        creaseEdges[edgeKey(mesh.creaseEdges[i], mesh.creaseEdges[i + 1])] = mesh.creaseEdgeValues[i / 2];
+    }
+
+    // Edge numbering is only known once the mesh exists
+    int numEdges = fnMesh.numEdges();
+    MIntArray edgeIds(numEdges);
+    MIntArray smoothings(numEdges);
+    MUintArray creaseIds;
+    MDoubleArray creaseValues;
+    for (int edge = 0; edge < numEdges; ++edge) {
+        int2 vertices;
+        fnMesh.getEdgeVertices(edge, vertices);
+        uint64_t key = edgeKey(vertices[0], vertices[1]);
+
+        edgeIds[edge] = edge;
+        smoothings[edge] = hardEdges.count(key) ? 0 : 1;
+
+        auto creaseIt = creaseEdges.find(key);
+        if (creaseIt != creaseEdges.end()) {
+            creaseIds.append(static_cast<unsigned int>(edge));
+            creaseValues.append(creaseIt->second);
+        }
+    }
+
+    if (numEdges > 0) {
+        fnMesh.setEdgeSmoothings(edgeIds, smoothings);
+        fnMesh.cleanupEdgeSmoothing();
+    }
+    if (creaseIds.length() > 0) {
+        fnMesh.setCreaseEdges(creaseIds, creaseValues);
+    }
+
+    if (!mesh.creaseVertices.empty()) {
+        MUintArray vertexIds;
+        for (int vertex : mesh.creaseVertices) {
+            vertexIds.append(static_cast<unsigned int>(vertex));
+        }
+        MDoubleArray vertexValues(mesh.creaseVertexValues.data(), static_cast<unsigned int>(mesh.creaseVertexValues.size()));
+        fnMesh.setCreaseVertices(vertexIds, vertexValues);
+    }
+}
+
+void writeLockedNormals(MFnMesh& fnMesh, const MeshBuffers& mesh)
+{
+    if (mesh.lockedNormalFaceVertices.empty()) {
+        return;
+    }
+
+    MVectorArray normals;
+    MIntArray faceList;
+    MIntArray vertexList;
+
+    // Locked face-vertices are ascending, so walk the faces alongside them
+    size_t next = 0;
+    int faceStart = 0;
+    for (int face = 0; face < mesh.faceCount() && next < mesh.lockedNormalFaceVertices.size(); ++face) {
+        int faceEnd = faceStart + mesh.polygonCounts[face];
+        while (next < mesh.lockedNormalFaceVertices.size() && mesh.lockedNormalFaceVertices[next] < faceEnd) {
+            int fv = mesh.lockedNormalFaceVertices[next];
+            const float* normal = &mesh.lockedNormals[next * 3];
+            normals.append(MVector(normal[0], normal[1], normal[2]));
+            faceList.append(face);
+            vertexList.append(mesh.polygonConnects[fv]);
+            ++next;
+        }
+        faceStart = faceEnd;
+    }
+
+    fnMesh.setFaceVertexNormals(normals, faceList, vertexList, MSpace::kObject);
+}
+
+} // namespace
+
+void MeshBuffers::clear()
+{
+    points.clear();
+    polygonCounts.clear();
+    polygonConnects.clear();
+    uvSets.clear();
+    currentUVSet.clear();
+    colorSets.clear();
+    currentColorSet.clear();
+    hardEdges.clear();
+    creaseEdges.clear();
+    creaseEdgeValues.clear();
+    creaseVertices.clear();
+    creaseVertexValues.clear();
+    lockedNormalFaceVertices.clear();
+    lockedNormals.clear();
+}
+
+namespace ExtraAttrExtract {
+
+MStatus readMesh(const MDagPath& meshPath, MeshBuffers& outMesh)
+{
+    outMesh.clear();
+
+    MStatus status;
+    MFnMesh fnMesh(meshPath, &status);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    int numVertices = fnMesh.numVertices();
+    const float* rawPoints = fnMesh.getRawPoints(&status);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+    outMesh.points.assign(rawPoints, rawPoints + static_cast<size_t>(numVertices) * 3);
+
+    MIntArray polygonCounts, polygonConnects;
+    status = fnMesh.getVertices(polygonCounts, polygonConnects);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+    copyArray(polygonCounts, outMesh.polygonCounts);
+    copyArray(polygonConnects, outMesh.polygonConnects);
+
+    readUVSets(fnMesh, outMesh);
+    readColorSets(fnMesh, outMesh);
+    readEdges(fnMesh, outMesh);
+    readLockedNormals(fnMesh, outMesh);
+
+    return MS::kSuccess;
+}
+
+void extractFaces(const MeshBuffers& source, const std::vector<int>& faces, MeshBuffers& outMesh)
+{
+    SourceOffsets offsets(source);
+    SubsetBuilder builder(source, offsets, outMesh);
+    for (int face : faces) {
+        builder.addFace(face);
+    }
+    builder.finish();
+}
+
+void partitionFaces(const MeshBuffers& source, const std::vector<int>& faceGroups, int groupCount,
+                    std::vector<MeshBuffers>& outMeshes)
+{
+    outMeshes.resize(groupCount);
+
+    SourceOffsets offsets(source);
+    std::vector<std::unique_ptr<SubsetBuilder>> builders(groupCount);
+    for (int group = 0; group < groupCount; ++group) {
+        builders[group].reset(new SubsetBuilder(source, offsets, outMeshes[group]));
+    }
+
+    // One pass over the faces feeds every group
+    int faceCount = std::min(source.faceCount(), static_cast<int>(faceGroups.size()));
+    for (int face = 0; face < faceCount; ++face) {
+        int group = faceGroups[face];
+        if (group >= 0 && group < groupCount) {
+            builders[group]->addFace(face);
+        }
+    }
+
+    for (auto& builder : builders) {
+        builder->finish();
+    }
+}
+
+void partitionAll(std::vector<PartitionJob>& jobs)
+{
+    std::atomic<size_t> next(0);
+    auto work = [&jobs, &next]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            PartitionJob& job = jobs[i];
+            partitionFaces(job.source, *job.faceGroups, job.groupCount, job.outMeshes);
+        }
+    };
+
+    size_t threadCount = std::min<size_t>(jobs.size(), std::max(1u, std::thread::hardware_concurrency()));
+    if (threadCount <= 1) {
+        work();
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void appendMesh(MeshBuffers& dest, const MeshBuffers& source, const MMatrix& matrix)
+{
+    int vertexOffset = dest.vertexCount();
+    int faceOffset = dest.faceCount();
+    int faceVertexOffset = dest.faceVertexCount();
+
+    // Points are row vectors in Maya: p' = p * M
+    dest.points.reserve(dest.points.size() + source.points.size());
+    for (int vertex = 0; vertex < source.vertexCount(); ++vertex) {
+        double x = source.points[vertex * 3];
+        double y = source.points[vertex * 3 + 1];
+        double z = source.points[vertex * 3 + 2];
+        for (unsigned int axis = 0; axis < 3; ++axis) {
+            dest.points.push_back(static_cast<float>(x * matrix(0, axis) + y * matrix(1, axis) + z * matrix(2, axis) +
+                                                     matrix(3, axis)));
+        }
+    }
+
+    dest.polygonCounts.insert(dest.polygonCounts.end(), source.polygonCounts.begin(), source.polygonCounts.end());
+    dest.polygonConnects.reserve(dest.polygonConnects.size() + source.polygonConnects.size());
+    for (int vertex : source.polygonConnects) {
+        dest.polygonConnects.push_back(vertex + vertexOffset);
+    }
+
+    // UV sets are merged by name; faces without a set get no UVs in it
+    for (const MeshUVSet& sourceSet : source.uvSets) {
+        auto it = std::find_if(dest.uvSets.begin(), dest.uvSets.end(),
+                               [&sourceSet](const MeshUVSet& uvSet) { return uvSet.name == sourceSet.name; });
+        if (it == dest.uvSets.end()) {
+            MeshUVSet uvSet;
+            uvSet.name = sourceSet.name;
+            uvSet.uvCounts.assign(faceOffset, 0);
+            dest.uvSets.push_back(uvSet);
+            it = dest.uvSets.end() - 1;
+        }
+
+        int uvOffset = static_cast<int>(it->u.size());
+        it->u.insert(it->u.end(), sourceSet.u.begin(), sourceSet.u.end());
+        it->v.insert(it->v.end(), sourceSet.v.begin(), sourceSet.v.end());
+        it->uvCounts.insert(it->uvCounts.end(), sourceSet.uvCounts.begin(), sourceSet.uvCounts.end());
+        for (int uv : sourceSet.uvIds) {
+            it->uvIds.push_back(uv + uvOffset);
+        }
+    }
+    for (MeshUVSet& uvSet : dest.uvSets) {
+        uvSet.uvCounts.resize(dest.polygonCounts.size(), 0);
+    }
+    if (dest.currentUVSet.length() == 0) {
+        dest.currentUVSet = source.currentUVSet;
+    }
+
+    // Color sets likewise; face-vertices without a set stay unassigned
+    for (const MeshColorSet& sourceSet : source.colorSets) {
+        auto it = std::find_if(dest.colorSets.begin(), dest.colorSets.end(),
+                               [&sourceSet](const MeshColorSet& colorSet) { return colorSet.name == sourceSet.name; });
+        if (it == dest.colorSets.end()) {
+            MeshColorSet colorSet;
+            colorSet.name = sourceSet.name;
+            colorSet.clamped = sourceSet.clamped;
+            colorSet.representation = sourceSet.representation;
+            colorSet.rgba.assign(static_cast<size_t>(faceVertexOffset) * 4, 0.0f);
+            colorSet.assigned.assign(faceVertexOffset, 0);
+            dest.colorSets.push_back(colorSet);
+            it = dest.colorSets.end() - 1;
+        }
+        it->rgba.insert(it->rgba.end(), sourceSet.rgba.begin(), sourceSet.rgba.end());
+        it->assigned.insert(it->assigned.end(), sourceSet.assigned.begin(), sourceSet.assigned.end());
+    }
+    for (MeshColorSet& colorSet : dest.colorSets) {
+        colorSet.rgba.resize(dest.polygonConnects.size() * 4, 0.0f);
+        colorSet.assigned.resize(dest.polygonConnects.size(), 0);
+    }
+    if (dest.currentColorSet.length() == 0) {
+        dest.currentColorSet = source.currentColorSet;
+    }
+
+    for (int vertex : source.hardEdges) {
+        dest.hardEdges.push_back(vertex + vertexOffset);
+    }
+    for (int vertex : source.creaseEdges) {
+        dest.creaseEdges.push_back(vertex + vertexOffset);
+    }
+    dest.creaseEdgeValues.insert(dest.creaseEdgeValues.end(), source.creaseEdgeValues.begin(), source.creaseEdgeValues.end());
+    for (int vertex : source.creaseVertices) {
+        dest.creaseVertices.push_back(vertex + vertexOffset);
+    }
+    dest.creaseVertexValues.insert(dest.creaseVertexValues.end(), source.creaseVertexValues.begin(),
+                                   source.creaseVertexValues.end());
+
+    // Normals transform by the inverse transpose: n' = n * (M^-1)^T
+    MMatrix inverse = matrix.inverse();
+    for (size_t i = 0; i < source.lockedNormalFaceVertices.size(); ++i) {
+        dest.lockedNormalFaceVertices.push_back(source.lockedNormalFaceVertices[i] + faceVertexOffset);
+
+        const float* normal = &source.lockedNormals[i * 3];
+        double transformed[3];
+        double length = 0.0;
+        for (unsigned int axis = 0; axis < 3; ++axis) {
+            transformed[axis] = normal[0] * inverse(axis, 0) + normal[1] * inverse(axis, 1) + normal[2] * inverse(axis, 2);
+            length += transformed[axis] * transformed[axis];
+        }
+        length = length > 0.0 ? std::sqrt(length) : 1.0;
+        for (unsigned int axis = 0; axis < 3; ++axis) {
+            dest.lockedNormals.push_back(static_cast<float>(transformed[axis] / length));
+        }
+    }
+}
+
+bool hasHoles(const MDagPath& meshPath, const std::vector<int>& faceGroups)
+{
+    MStatus status;
+    MFnMesh fnMesh(meshPath, &status);
+    if (status != MS::kSuccess) {
+        return false;
+    }
+
+    // Triples of (face, hole vertex count, first hole vertex)
+    MIntArray holeInfo;
+    MIntArray holeVertices;
+    int holeCount = fnMesh.getHoles(holeInfo, holeVertices);
+    for (int hole = 0; hole < holeCount; ++hole) {
+        int face = holeInfo[hole * 3];
+        if (face >= 0 && face < static_cast<int>(faceGroups.size()) && faceGroups[face] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+MStatus copyFaces(const MDagPath& meshPath, const std::vector<int>& faceGroups, int group, const MObject& parent,
+                  MObject& outShape)
+{
+    MStatus status;
+    MFnMesh fnMesh;
+    outShape = fnMesh.copy(meshPath.node(), parent, &status);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    // Delete from the last face down so the remaining face indices stay valid
+    for (int face = static_cast<int>(faceGroups.size()) - 1; face >= 0; --face) {
+        if (faceGroups[face] == group) {
+            continue;
+        }
+        status = fnMesh.deleteFace(face);
+        if (status != MS::kSuccess) {
+            return status;
+        }
+    }
+    return MS::kSuccess;
+}
+
+MStatus createMesh(const MeshBuffers& mesh, const MObject& parent, MObject& outShape)
+{
+    MFloatPointArray points(static_cast<unsigned int>(mesh.vertexCount()));
+    for (int vertex = 0; vertex < mesh.vertexCount(); ++vertex) {
+        points.set(static_cast<unsigned int>(vertex),
+                   mesh.points[vertex * 3], mesh.points[vertex * 3 + 1], mesh.points[vertex * 3 + 2]);
+    }
+    MIntArray polygonCounts(mesh.polygonCounts.data(), static_cast<unsigned int>(mesh.polygonCounts.size()));
+    MIntArray polygonConnects(mesh.polygonConnects.data(), static_cast<unsigned int>(mesh.polygonConnects.size()));
+
+    MStatus status;
+    MFnMesh fnMesh;
+    outShape = fnMesh.create(mesh.vertexCount(), mesh.faceCount(), points, polygonCounts, polygonConnects,
+                             parent, &status);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    writeUVSets(fnMesh, mesh);
+    writeColorSets(fnMesh, mesh);
+    writeEdges(fnMesh, mesh);
+    writeLockedNormals(fnMesh, mesh);
+
+    return MS::kSuccess;
+}
+
+MStatus matchPlacement(const MDagPath& sourceShape, const MObject& transform)
+{
+    MStatus status;
+    MDagPath sourceTransform(sourceShape);
+    sourceTransform.pop();
+
+    MFnTransform fnSource(sourceTransform, &status);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+    MFnTransform fnTransform(transform, &status);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    status = fnTransform.set(MTransformationMatrix(sourceTransform.inclusiveMatrix()));
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    // Balance the pivots so setting them does not move the object
+    fnTransform.setRotatePivot(fnSource.rotatePivot(MSpace::kTransform), MSpace::kTransform, true);
+    fnTransform.setScalePivot(fnSource.scalePivot(MSpace::kTransform), MSpace::kTransform, true);
+    return MS::kSuccess;
+}
+
+MStatus copyShaderAssignment(const MeshPartition& partition, int group, const MObject& shape, int faceOffset)
+{
+    // New face indices per shader slot; new faces follow the source order
+    std::vector<MIntArray> slotFaces(partition.shaders.size());
+    int faceCount = faceOffset;
+    for (size_t face = 0; face < partition.faceGroups.size(); ++face) {
+        if (partition.faceGroups[face] != group) {
+            continue;
+        }
+        int slot = partition.faceShaders[face];
+        if (slot >= 0) {
+            slotFaces[slot].append(static_cast<int>(faceCount));
+        }
+        faceCount++;
+    }
+
+    MDagPath shapePath;
+    MStatus status = MDagPath::getAPathTo(shape, shapePath);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+    unsigned int shapeFaceCount = static_cast<unsigned int>(MFnMesh(shapePath).numPolygons());
+
+    for (size_t slot = 0; slot < partition.shaders.size(); ++slot) {
+        if (slotFaces[slot].length() == 0) {
+            continue;
+        }
+
+        MFnSet fnSet(partition.shaders[slot], &status);
+        if (status != MS::kSuccess) {
+            continue;
+        }
+
+        // A single engine takes the whole object, as an assignment made in the UI would
+        if (slotFaces[slot].length() == shapeFaceCount) {
+            fnSet.addMember(shapePath);
+            continue;
+        }
+
+        MFnSingleIndexedComponent fnComponent;
+        MObject component = fnComponent.create(MFn::kMeshPolygonComponent);
+        fnComponent.addElements(slotFaces[slot]);
+        fnSet.addMember(shapePath, component);
+    }
+
+    return MS::kSuccess;
+}
+
+} // namespace ExtraAttrExtract
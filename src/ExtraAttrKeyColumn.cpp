@@ -0,0 +1,531 @@
+#include "ExtraAttrKeyColumn.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EXTRA_ATTR_KEY_COLUMN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Below this many rows a single-threaded sort is faster than splitting
+const size_t kParallelSortThreshold = 65536;
+
+// Rows moved to the tail before the text is rebuilt: at least this many, or this share of the rows
+const size_t kMinTailRows = 64;
+const size_t kTailDivisor = 32;
+
+#ifdef EXTRA_ATTR_KEY_COLUMN_SSE2
+inline int countTrailingZeros(unsigned int mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/**
+ * @brief Find the first occurrence of needle in [haystack, haystack + length)
+ *
+ * Tests 16 candidate positions at once by comparing the first and last
+ * needle bytes, and only compares the middle bytes where both match.
+ *
+ * @return Pointer to the match, or nullptr
+ */
+const char* findBytes(const char* haystack, size_t length, const char* needle, size_t needleLength)
+{
+    if (needleLength == 0) {
+        return haystack;
+    }
+    if (needleLength > length) {
+        return nullptr;
+    }
+    if (needleLength == 1) {
+        return static_cast<const char*>(memchr(haystack, needle[0], length));
+    }
+
+    size_t i = 0;
+
+#ifdef EXTRA_ATTR_KEY_COLUMN_SSE2
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needleLength - 1]);
+
+    for (; i + needleLength - 1 + 16 <= length; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + needleLength - 1));
+        unsigned int mask = static_cast<unsigned int>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+
+        while (mask != 0) {
+            int bit = countTrailingZeros(mask);
+            if (memcmp(haystack + i + bit + 1, needle + 1, needleLength - 2) == 0) {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i + needleLength <= length; ++i) {
+        if (haystack[i] == needle[0] && memcmp(haystack + i + 1, needle + 1, needleLength - 1) == 0) {
+            return haystack + i;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Sort a chunk; an unstable sort is enough when no two elements compare equal
+ */
+template <typename Iterator, typename Less>
+void sortChunk(Iterator first, Iterator last, Less less, bool stable)
+{
+    if (stable) {
+        std::stable_sort(first, last, less);
+    } else {
+        std::sort(first, last, less);
+    }
+}
+
+/**
+ * @brief Sort split into chunks sorted on worker threads and then merged
+ * @param stable Keep equal elements in their input order
+ */
+template <typename Iterator, typename Less>
+void parallelSort(Iterator first, Iterator last, Less less, size_t threadCount, bool stable)
+{
+    size_t count = static_cast<size_t>(last - first);
+    if (count < kParallelSortThreshold || threadCount < 2) {
+        sortChunk(first, last, less, stable);
+        return;
+    }
+
+    size_t chunkCount = std::min(threadCount, count / (kParallelSortThreshold / 4));
+    std::vector<size_t> bounds(chunkCount + 1);
+    for (size_t c = 0; c <= chunkCount; ++c) {
+        bounds[c] = count * c / chunkCount;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(chunkCount);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        workers.emplace_back([first, &bounds, &less, c, stable]() {
+            sortChunk(first + bounds[c], first + bounds[c + 1], less, stable);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Merge neighbouring chunks until one remains
+    for (size_t width = 1; width < chunkCount; width *= 2) {
+        workers.clear();
+        for (size_t c = 0; c + width < chunkCount; c += 2 * width) {
+            Iterator begin = first + bounds[c];
+            Iterator middle = first + bounds[c + width];
+            Iterator end = first + bounds[std::min(c + 2 * width, chunkCount)];
+            workers.emplace_back([begin, middle, end, &less]() {
+                std::inplace_merge(begin, middle, end, less);
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Compare two byte strings, treating runs of digits as numbers
+ *
+ * "item9" sorts before "item10". Numbers equal in value but written with
+ * more leading zeros sort after the shorter form.
+ */
+int compareNatural(const char* a, size_t lengthA, const char* b, size_t lengthB)
+{
+    size_t i = 0;
+    size_t j = 0;
+    int zeroTieBreak = 0;
+
+    while (i < lengthA && j < lengthB) {
+        if (isDigit(a[i]) && isDigit(b[j])) {
+            size_t startA = i;
+            size_t startB = j;
+            while (i < lengthA && a[i] == '0') {
+                ++i;
+            }
+            while (j < lengthB && b[j] == '0') {
+                ++j;
+            }
+
+            size_t digitsA = i;
+            size_t digitsB = j;
+            while (digitsA < lengthA && isDigit(a[digitsA])) {
+                ++digitsA;
+            }
+            while (digitsB < lengthB && isDigit(b[digitsB])) {
+                ++digitsB;
+            }
+
+            // Without leading zeros, the longer run is the larger number
+            if (digitsA - i != digitsB - j) {
+                return (digitsA - i < digitsB - j) ? -1 : 1;
+            }
+            int result = memcmp(a + i, b + j, digitsA - i);
+            if (result != 0) {
+                return result;
+            }
+            if (zeroTieBreak == 0 && (i - startA) != (j - startB)) {
+                zeroTieBreak = ((i - startA) < (j - startB)) ? -1 : 1;
+            }
+
+            i = digitsA;
+            j = digitsB;
+            continue;
+        }
+
+        if (a[i] != b[j]) {
+            return (static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[j])) ? -1 : 1;
+        }
+        ++i;
+        ++j;
+    }
+
+    if (i < lengthA) {
+        return 1;
+    }
+    if (j < lengthB) {
+        return -1;
+    }
+    return zeroTieBreak;
+}
+
+} // namespace
+
+ExtraAttrKeyColumn::ExtraAttrKeyColumn()
+    : m_tailBegin(0)
+    , m_naturalOrder(false)
+{
+}
+
+void ExtraAttrKeyColumn::setNaturalOrder(bool natural)
+{
+    m_naturalOrder = natural;
+}
+
+void ExtraAttrKeyColumn::clear()
+{
+    m_keys.clear();
+    m_text.clear();
+    m_tailRows.clear();
+    m_tailBegin = 0;
+}
+
+void ExtraAttrKeyColumn::reserve(size_t rowCount, size_t textBytes)
+{
+    m_keys.reserve(rowCount);
+    m_text.reserve(textBytes + rowCount);
+}
+
+void ExtraAttrKeyColumn::appendText(const char* text, size_t length)
+{
+    if (!m_tailRows.empty()) {
+        compactText();
+    }
+
+    Key key;
+    key.number = 0.0;
+    key.offset = static_cast<uint32_t>(m_text.size());
+    key.slot = key.offset;
+    key.length = static_cast<uint32_t>(length);
+    key.isText = true;
+    key.moved = false;
+    m_keys.push_back(key);
+
+    m_text.append(text, length);
+    m_text += '\0';
+}
+
+void ExtraAttrKeyColumn::appendNumber(double value)
+{
+    Key key;
+    key.number = value;
+    key.offset = static_cast<uint32_t>(m_text.size());
+    key.slot = key.offset;
+    key.length = 0;
+    key.isText = false;
+    key.moved = false;
+    m_keys.push_back(key);
+}
+
+void ExtraAttrKeyColumn::setText(uint32_t row, const char* text, size_t length)
+{
+    if (row >= m_keys.size()) {
+        return;
+    }
+
+    Key& key = m_keys[row];
+    if (key.isText && length <= key.length) {
+        // Fits in place; pad the rest with separators so it cannot match
+        memcpy(&m_text[key.offset], text, length);
+        memset(&m_text[key.offset + length], '\0', key.length - length);
+        key.length = static_cast<uint32_t>(length);
+        return;
+    }
+
+    // Blank the old text and append the new one; the row keeps its slot for row lookups
+    if (key.isText) {
+        memset(&m_text[key.offset], '\0', key.length);
+    }
+    if (m_tailRows.empty()) {
+        m_tailBegin = static_cast<uint32_t>(m_text.size());
+    }
+    if (!key.moved) {
+        key.moved = true;
+        m_tailRows.push_back(row);
+    }
+
+    key.number = 0.0;
+    key.offset = static_cast<uint32_t>(m_text.size());
+    key.length = static_cast<uint32_t>(length);
+    key.isText = true;
+    m_text.append(text, length);
+    m_text += '\0';
+
+    if (m_tailRows.size() > std::max(kMinTailRows, m_keys.size() / kTailDivisor)) {
+        compactText();
+    }
+}
+
+void ExtraAttrKeyColumn::setNumber(uint32_t row, double value)
+{
+    if (row >= m_keys.size()) {
+        return;
+    }
+
+    Key& key = m_keys[row];
+    if (key.isText) {
+        // Blank the old text so it no longer matches a search
+        memset(&m_text[key.offset], '\0', key.length);
+    }
+    key.number = value;
+    key.length = 0;
+    key.isText = false;
+}
+
+void ExtraAttrKeyColumn::removeRows(uint32_t first, uint32_t count)
+{
+    if (first >= m_keys.size()) {
+        return;
+    }
+    count = std::min(count, static_cast<uint32_t>(m_keys.size()) - first);
+
+    if (!m_tailRows.empty()) {
+        compactText();
+    }
+
+    uint32_t last = first + count;
+    uint32_t textBegin = m_keys[first].offset;
+    uint32_t textEnd = (last < m_keys.size()) ? m_keys[last].offset : static_cast<uint32_t>(m_text.size());
+
+    m_text.erase(textBegin, textEnd - textBegin);
+    m_keys.erase(m_keys.begin() + first, m_keys.begin() + last);
+    for (size_t i = first; i < m_keys.size(); ++i) {
+        m_keys[i].offset -= textEnd - textBegin;
+        m_keys[i].slot = m_keys[i].offset;
+    }
+}
+
+size_t ExtraAttrKeyColumn::size() const
+{
+    return m_keys.size();
+}
+
+void ExtraAttrKeyColumn::findSubstring(const std::string& needle, std::vector<uint32_t>& outRows) const
+{
+    outRows.clear();
+
+    if (needle.empty()) {
+        outRows.resize(m_keys.size());
+        for (uint32_t row = 0; row < outRows.size(); ++row) {
+            outRows[row] = row;
+        }
+        return;
+    }
+
+    // One pass over the rows in place; separators keep a match inside one row
+    const char* begin = m_text.data();
+    const char* end = begin + (m_tailRows.empty() ? m_text.size() : m_tailBegin);
+    const char* p = begin;
+    uint32_t row = 0;
+    uint32_t rowCount = static_cast<uint32_t>(m_keys.size());
+
+    while (p < end) {
+        const char* hit = findBytes(p, static_cast<size_t>(end - p), needle.data(), needle.size());
+        if (!hit) {
+            break;
+        }
+
+        // Slots grow with the row number, so the owning row is found by walking forward
+        uint32_t position = static_cast<uint32_t>(hit - begin);
+        while (row + 1 < rowCount && m_keys[row + 1].slot <= position) {
+            ++row;
+        }
+
+        outRows.push_back(row);
+        p = begin + m_keys[row].offset + m_keys[row].length + 1;
+        ++row;
+        if (row >= rowCount) {
+            break;
+        }
+    }
+
+    // Moved rows are few; test them one by one and merge them into the result
+    if (!m_tailRows.empty()) {
+        size_t inPlaceCount = outRows.size();
+        for (uint32_t tailRow : m_tailRows) {
+            const Key& key = m_keys[tailRow];
+            if (key.isText && findBytes(begin + key.offset, key.length, needle.data(), needle.size())) {
+                outRows.push_back(tailRow);
+            }
+        }
+        std::sort(outRows.begin() + inPlaceCount, outRows.end());
+        std::inplace_merge(outRows.begin(), outRows.begin() + inPlaceCount, outRows.end());
+    }
+}
+
+void ExtraAttrKeyColumn::narrowSubstring(const std::string& needle, const std::vector<uint32_t>& candidates,
+                                         std::vector<uint32_t>& outRows) const
+{
+    outRows.clear();
+
+    for (uint32_t row : candidates) {
+        if (row >= m_keys.size()) {
+            continue;
+        }
+
+        const Key& key = m_keys[row];
+        if (needle.empty() ||
+            (key.isText && findBytes(m_text.data() + key.offset, key.length, needle.data(), needle.size()))) {
+            outRows.push_back(row);
+        }
+    }
+}
+
+int ExtraAttrKeyColumn::compare(uint32_t a, uint32_t b) const
+{
+    const Key& keyA = m_keys[a];
+    const Key& keyB = m_keys[b];
+
+    if (keyA.isText != keyB.isText) {
+        return keyA.isText ? 1 : -1;
+    }
+
+    if (!keyA.isText) {
+        // NaN sorts after every other number so the order stays strict weak
+        bool nanA = std::isnan(keyA.number);
+        bool nanB = std::isnan(keyB.number);
+        if (nanA || nanB) {
+            return (nanA == nanB) ? 0 : nanA ? 1 : -1;
+        }
+        return (keyA.number < keyB.number) ? -1 : (keyB.number < keyA.number) ? 1 : 0;
+    }
+
+    if (m_naturalOrder) {
+        return compareNatural(m_text.data() + keyA.offset, keyA.length, m_text.data() + keyB.offset, keyB.length);
+    }
+
+    int result = memcmp(m_text.data() + keyA.offset, m_text.data() + keyB.offset, std::min(keyA.length, keyB.length));
+    if (result != 0) {
+        return result;
+    }
+    return (keyA.length < keyB.length) ? -1 : (keyB.length < keyA.length) ? 1 : 0;
+}
+
+void ExtraAttrKeyColumn::sortRows(std::vector<uint32_t>& rows, bool descending) const
+{
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    bool allNumbers = true;
+    for (uint32_t row : rows) {
+        if (m_keys[row].isText) {
+            allNumbers = false;
+            break;
+        }
+    }
+
+    if (allNumbers) {
+        // Sort (value, position) pairs so comparisons never touch the key table;
+        // the position keeps equal values in their input order, so no stable sort is needed.
+        // NaN rows are set aside in input order and placed as compare() orders them
+        std::vector<std::pair<double, uint32_t>> pairs;
+        std::vector<uint32_t> nanRows;
+        pairs.reserve(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            double value = m_keys[rows[i]].number;
+            if (std::isnan(value)) {
+                nanRows.push_back(rows[i]);
+            } else {
+                pairs.emplace_back(descending ? -value : value, static_cast<uint32_t>(i));
+            }
+        }
+
+        parallelSort(pairs.begin(), pairs.end(), std::less<std::pair<double, uint32_t>>(), threadCount, false);
+
+        std::vector<uint32_t> sorted;
+        sorted.reserve(rows.size());
+        if (descending) {
+            sorted.insert(sorted.end(), nanRows.begin(), nanRows.end());
+        }
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            sorted.push_back(rows[pairs[i].second]);
+        }
+        if (!descending) {
+            sorted.insert(sorted.end(), nanRows.begin(), nanRows.end());
+        }
+        rows.swap(sorted);
+        return;
+    }
+
+    parallelSort(rows.begin(), rows.end(), [this, descending](uint32_t a, uint32_t b) {
+        return descending ? compare(b, a) < 0 : compare(a, b) < 0;
+    }, threadCount, true);
+}
+
+void ExtraAttrKeyColumn::compactText()
+{
+    std::string rebuilt;
+    rebuilt.reserve(m_text.size());
+
+    for (Key& key : m_keys) {
+        uint32_t offset = static_cast<uint32_t>(rebuilt.size());
+        if (key.isText) {
+            rebuilt.append(m_text, key.offset, key.length);
+            rebuilt += '\0';
+        }
+        key.offset = offset;
+        key.slot = offset;
+        key.moved = false;
+    }
+
+    m_text.swap(rebuilt);
+    m_tailRows.clear();
+    m_tailBegin = 0;
+}
@@ -1,21 +1,94 @@
 #include "ExtraAttrManagerCmd.h"
 #include "ExtraAttrUI.h"
 #include "ExtraAttrScanner.h"
+#include "ExtraAttrScanJob.h"
+#include "ExtraAttrSnapshot.h"
+#include "ExtraAttrStats.h"
+#include "ExtraAttrExtract.h"
+#include "ExtraAttrShadingIndex.h"
+#include "ExtraAttrValueCodec.h"
 #include "MayaUtils.h"
+#include <maya/MAngle.h>
 #include <maya/MArgDatabase.h>
+#include <maya/MDistance.h>
+#include <maya/MFnDagNode.h>
 #include <maya/MFnDependencyNode.h>
 #include <maya/MFnNumericAttribute.h>
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MFnEnumAttribute.h>
 #include <maya/MGlobal.h>
+#include <maya/MObjectHandle.h>
 #include <maya/MPlug.h>
+#include <maya/MSelectionList.h>
 #include <maya/MFnNumericData.h>
+#include <maya/MStringArray.h>
+#include <maya/MDoubleArray.h>
+#include <maya/MTime.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
 
 const char* ExtraAttrManagerCmd::commandName = "exAttrEditor";
 
 // Command flag definitions
 const char* ExtraAttrManagerCmd::kScanFlag = "-s";
 const char* ExtraAttrManagerCmd::kScanFlagLong = "-scan";
+const char* ExtraAttrManagerCmd::kAsyncFlag = "-as";
+const char* ExtraAttrManagerCmd::kAsyncFlagLong = "-async";
+const char* ExtraAttrManagerCmd::kJobStatusFlag = "-js";
+const char* ExtraAttrManagerCmd::kJobStatusFlagLong = "-jobStatus";
+const char* ExtraAttrManagerCmd::kJobWaitFlag = "-jw";
+const char* ExtraAttrManagerCmd::kJobWaitFlagLong = "-jobWait";
+const char* ExtraAttrManagerCmd::kJobCancelFlag = "-jc";
+const char* ExtraAttrManagerCmd::kJobCancelFlagLong = "-jobCancel";
+const char* ExtraAttrManagerCmd::kSnapshotFlag = "-ss";
+const char* ExtraAttrManagerCmd::kSnapshotFlagLong = "-snapshot";
+const char* ExtraAttrManagerCmd::kDiffFlag = "-df";
+const char* ExtraAttrManagerCmd::kDiffFlagLong = "-diff";
+const char* ExtraAttrManagerCmd::kRenameFlag = "-rn";
+const char* ExtraAttrManagerCmd::kRenameFlagLong = "-rename";
+const char* ExtraAttrManagerCmd::kPurgeFlag = "-pg";
+const char* ExtraAttrManagerCmd::kPurgeFlagLong = "-purge";
+const char* ExtraAttrManagerCmd::kNodeTypeFlag = "-nt";
+const char* ExtraAttrManagerCmd::kNodeTypeFlagLong = "-nodeType";
+const char* ExtraAttrManagerCmd::kNamespaceFlag = "-ns";
+const char* ExtraAttrManagerCmd::kNamespaceFlagLong = "-namespace";
+const char* ExtraAttrManagerCmd::kDryRunFlag = "-dr";
+const char* ExtraAttrManagerCmd::kDryRunFlagLong = "-dryRun";
+const char* ExtraAttrManagerCmd::kExtractFlag = "-ex";
+const char* ExtraAttrManagerCmd::kExtractFlagLong = "-extract";
+const char* ExtraAttrManagerCmd::kExtractNameFlag = "-xn";
+const char* ExtraAttrManagerCmd::kExtractNameFlagLong = "-extractName";
+const char* ExtraAttrManagerCmd::kKeepOriginalFlag = "-ko";
+const char* ExtraAttrManagerCmd::kKeepOriginalFlagLong = "-keepOriginal";
+const char* ExtraAttrManagerCmd::kCombineFlag = "-cb";
+const char* ExtraAttrManagerCmd::kCombineFlagLong = "-combine";
+const char* ExtraAttrManagerCmd::kMaterialFacesFlag = "-mf";
+const char* ExtraAttrManagerCmd::kMaterialFacesFlagLong = "-materialFaces";
+const char* ExtraAttrManagerCmd::kStatsFlag = "-st";
+const char* ExtraAttrManagerCmd::kStatsFlagLong = "-stats";
+const char* ExtraAttrManagerCmd::kQueryFlag = "-qr";
+const char* ExtraAttrManagerCmd::kQueryFlagLong = "-query";
+const char* ExtraAttrManagerCmd::kEqualsFlag = "-eq";
+const char* ExtraAttrManagerCmd::kEqualsFlagLong = "-equals";
+const char* ExtraAttrManagerCmd::kWithFlagsFlag = "-wf";
+const char* ExtraAttrManagerCmd::kWithFlagsFlagLong = "-withFlags";
+const char* ExtraAttrManagerCmd::kWithoutFlagsFlag = "-wof";
+const char* ExtraAttrManagerCmd::kWithoutFlagsFlagLong = "-withoutFlags";
+const char* ExtraAttrManagerCmd::kValueIndexFlag = "-vi";
+const char* ExtraAttrManagerCmd::kValueIndexFlagLong = "-valueIndex";
+const char* ExtraAttrManagerCmd::kSearchFlag = "-sr";
+const char* ExtraAttrManagerCmd::kSearchFlagLong = "-search";
+const char* ExtraAttrManagerCmd::kRegexFlag = "-rx";
+const char* ExtraAttrManagerCmd::kRegexFlagLong = "-regex";
+const char* ExtraAttrManagerCmd::kCodecBenchmarkFlag = "-cbm";
+const char* ExtraAttrManagerCmd::kCodecBenchmarkFlagLong = "-codecBenchmark";
 const char* ExtraAttrManagerCmd::kListFlag = "-ls";
 const char* ExtraAttrManagerCmd::kListFlagLong = "-list";
 const char* ExtraAttrManagerCmd::kNodesFlag = "-n";
@@ -52,6 +125,34 @@ MSyntax ExtraAttrManagerCmd::newSyntax()
     MSyntax syntax;
 
     syntax.addFlag(kScanFlag, kScanFlagLong);
+    syntax.addFlag(kAsyncFlag, kAsyncFlagLong);
+    syntax.addFlag(kJobStatusFlag, kJobStatusFlagLong, MSyntax::kLong);
+    syntax.addFlag(kJobWaitFlag, kJobWaitFlagLong, MSyntax::kLong);
+    syntax.addFlag(kJobCancelFlag, kJobCancelFlagLong, MSyntax::kLong);
+    syntax.addFlag(kSnapshotFlag, kSnapshotFlagLong, MSyntax::kString);
+    syntax.addFlag(kDiffFlag, kDiffFlagLong, MSyntax::kString, MSyntax::kString);
+    syntax.addFlag(kRenameFlag, kRenameFlagLong, MSyntax::kString, MSyntax::kString);
+    syntax.addFlag(kPurgeFlag, kPurgeFlagLong, MSyntax::kString);
+    syntax.addFlag(kNodeTypeFlag, kNodeTypeFlagLong, MSyntax::kString);
+    syntax.addFlag(kNamespaceFlag, kNamespaceFlagLong, MSyntax::kString);
+    syntax.addFlag(kDryRunFlag, kDryRunFlagLong);
+    syntax.addFlag(kExtractFlag, kExtractFlagLong, MSyntax::kString);
+    syntax.makeFlagMultiUse(kExtractFlag);
+    syntax.addFlag(kExtractNameFlag, kExtractNameFlagLong, MSyntax::kString);
+    syntax.addFlag(kKeepOriginalFlag, kKeepOriginalFlagLong);
+    syntax.addFlag(kCombineFlag, kCombineFlagLong);
+    syntax.addFlag(kMaterialFacesFlag, kMaterialFacesFlagLong, MSyntax::kString);
+    syntax.makeFlagMultiUse(kMaterialFacesFlag);
+    syntax.addFlag(kStatsFlag, kStatsFlagLong, MSyntax::kString);
+    syntax.addFlag(kQueryFlag, kQueryFlagLong, MSyntax::kString);
+    syntax.addFlag(kEqualsFlag, kEqualsFlagLong, MSyntax::kString);
+    syntax.makeFlagMultiUse(kEqualsFlag);
+    syntax.addFlag(kWithFlagsFlag, kWithFlagsFlagLong, MSyntax::kString);
+    syntax.addFlag(kWithoutFlagsFlag, kWithoutFlagsFlagLong, MSyntax::kString);
+    syntax.addFlag(kValueIndexFlag, kValueIndexFlagLong, MSyntax::kBoolean);
+    syntax.addFlag(kSearchFlag, kSearchFlagLong, MSyntax::kString);
+    syntax.addFlag(kRegexFlag, kRegexFlagLong);
+    syntax.addFlag(kCodecBenchmarkFlag, kCodecBenchmarkFlagLong, MSyntax::kLong);
     syntax.addFlag(kListFlag, kListFlagLong);
     syntax.addFlag(kNodesFlag, kNodesFlagLong, MSyntax::kString);
     syntax.addFlag(kUIFlag, kUIFlagLong);
@@ -81,9 +182,169 @@ MStatus ExtraAttrManagerCmd::doIt(const MArgList& args)
 
     // Scan flag
     if (argData.isFlagSet(kScanFlag)) {
+        if (argData.isFlagSet(kAsyncFlag)) {
+            return doScanAsync();
+        }
         return doScan();
     }
 
+    // Scan job flags
+    if (argData.isFlagSet(kJobStatusFlag)) {
+        int jobId;
+        status = argData.getFlagArgument(kJobStatusFlag, 0, jobId);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid job ID for -jobStatus flag");
+            return status;
+        }
+        return doJobStatus(jobId);
+    }
+
+    if (argData.isFlagSet(kJobWaitFlag)) {
+        int jobId;
+        status = argData.getFlagArgument(kJobWaitFlag, 0, jobId);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid job ID for -jobWait flag");
+            return status;
+        }
+        return doJobWait(jobId);
+    }
+
+    if (argData.isFlagSet(kJobCancelFlag)) {
+        int jobId;
+        status = argData.getFlagArgument(kJobCancelFlag, 0, jobId);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid job ID for -jobCancel flag");
+            return status;
+        }
+        return doJobCancel(jobId);
+    }
+
+    // Stats flag
+    if (argData.isFlagSet(kStatsFlag)) {
+        MString attrName;
+        status = argData.getFlagArgument(kStatsFlag, 0, attrName);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid attribute name for -stats flag");
+            return status;
+        }
+        return doStats(attrName);
+    }
+
+    // Query flag
+    if (argData.isFlagSet(kQueryFlag)) {
+        MString attrName;
+        status = argData.getFlagArgument(kQueryFlag, 0, attrName);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid attribute name for -query flag");
+            return status;
+        }
+
+        std::vector<MString> values;
+        unsigned int useCount = argData.numberOfFlagUses(kEqualsFlag);
+        for (unsigned int i = 0; i < useCount; ++i) {
+            MArgList flagArgs;
+            status = argData.getFlagArgumentList(kEqualsFlag, i, flagArgs);
+            if (status != MS::kSuccess) {
+                MGlobal::displayError("Invalid value for -equals flag");
+                return status;
+            }
+            values.push_back(flagArgs.asString(0));
+        }
+
+        unsigned int requiredFlags = 0;
+        unsigned int excludedFlags = 0;
+        if (argData.isFlagSet(kWithFlagsFlag)) {
+            MString names;
+            status = argData.getFlagArgument(kWithFlagsFlag, 0, names);
+            if (status != MS::kSuccess) {
+                MGlobal::displayError("Invalid argument for -withFlags flag");
+                return status;
+            }
+            if (!MayaUtils::parsePlugFlagNames(names, requiredFlags)) {
+                MGlobal::displayError(MString("Invalid -withFlags names: ") + names);
+                return MS::kInvalidParameter;
+            }
+        }
+        if (argData.isFlagSet(kWithoutFlagsFlag)) {
+            MString names;
+            status = argData.getFlagArgument(kWithoutFlagsFlag, 0, names);
+            if (status != MS::kSuccess) {
+                MGlobal::displayError("Invalid argument for -withoutFlags flag");
+                return status;
+            }
+            if (!MayaUtils::parsePlugFlagNames(names, excludedFlags)) {
+                MGlobal::displayError(MString("Invalid -withoutFlags names: ") + names);
+                return MS::kInvalidParameter;
+            }
+        }
+
+        if (values.empty() && requiredFlags == 0 && excludedFlags == 0) {
+            MGlobal::displayError("-query requires an -equals value or a -withFlags/-withoutFlags filter");
+            return MS::kInvalidParameter;
+        }
+        return doQuery(attrName, values, requiredFlags, excludedFlags);
+    }
+
+    // Value index flag
+    if (argData.isFlagSet(kValueIndexFlag)) {
+        bool enabled;
+        status = argData.getFlagArgument(kValueIndexFlag, 0, enabled);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid argument for -valueIndex flag");
+            return status;
+        }
+        return doValueIndex(enabled);
+    }
+
+    // Search flag
+    if (argData.isFlagSet(kSearchFlag)) {
+        MString pattern;
+        status = argData.getFlagArgument(kSearchFlag, 0, pattern);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid argument for -search flag");
+            return status;
+        }
+        return doSearch(pattern, argData.isFlagSet(kRegexFlag));
+    }
+
+    // Codec benchmark flag
+    if (argData.isFlagSet(kCodecBenchmarkFlag)) {
+        int count;
+        status = argData.getFlagArgument(kCodecBenchmarkFlag, 0, count);
+        if (status != MS::kSuccess || count <= 0) {
+            MGlobal::displayError("Invalid count for -codecBenchmark flag");
+            return MS::kInvalidParameter;
+        }
+        return doCodecBenchmark(count);
+    }
+
+    // Snapshot flag
+    if (argData.isFlagSet(kSnapshotFlag)) {
+        MString name;
+        status = argData.getFlagArgument(kSnapshotFlag, 0, name);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid name for -snapshot flag");
+            return status;
+        }
+        return doSnapshot(name);
+    }
+
+    // Diff flag
+    if (argData.isFlagSet(kDiffFlag)) {
+        MString beforeName, afterName;
+        status = argData.getFlagArgument(kDiffFlag, 0, beforeName);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid first snapshot name for -diff flag");
+            return status;
+        }
+        status = argData.getFlagArgument(kDiffFlag, 1, afterName);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid second snapshot name for -diff flag");
+            return status;
+        }
+        return doDiff(beforeName, afterName);
+    }
+
     // List flag
     if (argData.isFlagSet(kListFlag)) {
         return doList();
@@ -147,6 +408,88 @@ MStatus ExtraAttrManagerCmd::doIt(const MArgList& args)
         return doDelete(nodeName, attrName);
     }
 
+    // Rename flag
+    if (argData.isFlagSet(kRenameFlag)) {
+        MString oldName, newName;
+        status = argData.getFlagArgument(kRenameFlag, 0, oldName);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid attribute name for -rename flag");
+            return status;
+        }
+        status = argData.getFlagArgument(kRenameFlag, 1, newName);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid new attribute name for -rename flag");
+            return status;
+        }
+        return doRename(oldName, newName);
+    }
+
+    // Purge flag
+    if (argData.isFlagSet(kPurgeFlag)) {
+        MString attrName, nodeType, nameSpace;
+        status = argData.getFlagArgument(kPurgeFlag, 0, attrName);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Invalid attribute name for -purge flag");
+            return status;
+        }
+        if (argData.isFlagSet(kNodeTypeFlag)) {
+            status = argData.getFlagArgument(kNodeTypeFlag, 0, nodeType);
+            if (status != MS::kSuccess) {
+                MGlobal::displayError("Invalid node type for -nodeType flag");
+                return status;
+            }
+        }
+        if (argData.isFlagSet(kNamespaceFlag)) {
+            status = argData.getFlagArgument(kNamespaceFlag, 0, nameSpace);
+            if (status != MS::kSuccess) {
+                MGlobal::displayError("Invalid namespace for -namespace flag");
+                return status;
+            }
+        }
+        return doPurge(attrName, nodeType, nameSpace, argData.isFlagSet(kDryRunFlag));
+    }
+
+    // Extract flag
+    if (argData.isFlagSet(kExtractFlag)) {
+        std::vector<MString> materials;
+        unsigned int useCount = argData.numberOfFlagUses(kExtractFlag);
+        for (unsigned int i = 0; i < useCount; ++i) {
+            MArgList flagArgs;
+            status = argData.getFlagArgumentList(kExtractFlag, i, flagArgs);
+            if (status != MS::kSuccess) {
+                MGlobal::displayError("Invalid material name for -extract flag");
+                return status;
+            }
+            materials.push_back(flagArgs.asString(0));
+        }
+
+        MString objectName("extracted");
+        if (argData.isFlagSet(kExtractNameFlag)) {
+            status = argData.getFlagArgument(kExtractNameFlag, 0, objectName);
+            if (status != MS::kSuccess) {
+                MGlobal::displayError("Invalid object name for -extractName flag");
+                return status;
+            }
+        }
+        return doExtract(materials, objectName, argData.isFlagSet(kKeepOriginalFlag), argData.isFlagSet(kCombineFlag));
+    }
+
+    // Material faces flag
+    if (argData.isFlagSet(kMaterialFacesFlag)) {
+        std::vector<MString> materials;
+        unsigned int useCount = argData.numberOfFlagUses(kMaterialFacesFlag);
+        for (unsigned int i = 0; i < useCount; ++i) {
+            MArgList flagArgs;
+            status = argData.getFlagArgumentList(kMaterialFacesFlag, i, flagArgs);
+            if (status != MS::kSuccess) {
+                MGlobal::displayError("Invalid material name for -materialFaces flag");
+                return status;
+            }
+            materials.push_back(flagArgs.asString(0));
+        }
+        return doMaterialFaces(materials);
+    }
+
     // Add flag
     if (argData.isFlagSet(kAddFlag)) {
         MString nodeName, attrName, attrType;
@@ -174,13 +517,54 @@ MStatus ExtraAttrManagerCmd::doIt(const MArgList& args)
 
 MStatus ExtraAttrManagerCmd::redoIt()
 {
-    // Currently few undoable operations, so basically do nothing
+    if (m_undoData.wasExtracted) {
+        return redoExtract();
+    }
+
+    if (!m_undoData.wasRenamed && !m_undoData.wasPurged) {
+        // Other operations are applied directly in doIt()
+        return MS::kSuccess;
+    }
+
+    MStatus status = m_dgModifier.doIt();
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    // Patch the shared index instead of rescanning
+    ExtraAttrScanner& index = ExtraAttrScanner::sharedIndex();
+    if (m_undoData.wasRenamed) {
+        index.renameAttribute(m_undoData.attrName, m_undoData.newAttrName, m_undoData.nodes);
+    } else {
+        index.removeAttributeFromNodes(m_undoData.attrName, m_undoData.nodes);
+    }
+    ExtraAttrUI::notifyIndexChanged();
     return MS::kSuccess;
 }
 
 MStatus ExtraAttrManagerCmd::undoIt()
 {
-    // Undo processing (extensible in the future)
+    if (m_undoData.wasExtracted) {
+        return undoExtract();
+    }
+
+    if (!m_undoData.wasRenamed && !m_undoData.wasPurged) {
+        // Undo processing for direct edits (extensible in the future)
+        return MS::kSuccess;
+    }
+
+    MStatus status = m_dgModifier.undoIt();
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    ExtraAttrScanner& index = ExtraAttrScanner::sharedIndex();
+    if (m_undoData.wasRenamed) {
+        index.renameAttribute(m_undoData.newAttrName, m_undoData.attrName, m_undoData.nodes);
+    } else {
+        index.restoreAttributeOnNodes(m_undoData.attrInfo, m_undoData.nodes);
+    }
+    ExtraAttrUI::notifyIndexChanged();
     return MS::kSuccess;
 }
 
@@ -191,12 +575,14 @@ bool ExtraAttrManagerCmd::isUndoable() const
 
 MStatus ExtraAttrManagerCmd::doScan()
 {
-    ExtraAttrScanner scanner;
+    ExtraAttrScanner& scanner = ExtraAttrScanner::sharedIndex();
     if (!scanner.scanScene()) {
         MGlobal::displayError("Failed to scan scene");
         return MS::kFailure;
     }
 
+    ExtraAttrUI::notifyIndexChanged();
+
     int totalAttrs, totalNodes;
     scanner.getStatistics(totalAttrs, totalNodes);
 
@@ -204,15 +590,949 @@ MStatus ExtraAttrManagerCmd::doScan()
     return MS::kSuccess;
 }
 
-MStatus ExtraAttrManagerCmd::doList()
+MStatus ExtraAttrManagerCmd::doScanAsync()
 {
-    ExtraAttrScanner scanner;
-    if (!scanner.scanScene()) {
-        MGlobal::displayError("Failed to scan scene");
+    int jobId = ExtraAttrScanJobManager::instance().startScan();
+    if (jobId < 0) {
+        MGlobal::displayError("Failed to start scan job");
+        return MS::kFailure;
+    }
+
+    setResult(jobId);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doJobStatus(int jobId)
+{
+    ScanJobState state;
+    size_t processed, total;
+    if (!ExtraAttrScanJobManager::instance().getStatus(jobId, state, processed, total)) {
+        MGlobal::displayError(MString("Scan job not found: ") + jobId);
+        return MS::kFailure;
+    }
+
+    // Result: state, visited nodes, total nodes
+    MStringArray result;
+    result.append(ExtraAttrScanJobManager::stateName(state));
+    result.append(MString() + static_cast<int>(processed));
+    result.append(MString() + static_cast<int>(total));
+
+    setResult(result);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doJobWait(int jobId)
+{
+    ExtraAttrScanJobManager& jobs = ExtraAttrScanJobManager::instance();
+
+    ScanJobState state;
+    size_t processed, total;
+    if (!jobs.getStatus(jobId, state, processed, total)) {
+        MGlobal::displayError(MString("Scan job not found: ") + jobId);
+        return MS::kFailure;
+    }
+
+    if (!jobs.wait(jobId)) {
+        jobs.getStatus(jobId, state, processed, total);
+        MGlobal::displayError(MString("Scan job ") + jobId + " did not complete: " +
+                              ExtraAttrScanJobManager::stateName(state));
+        return MS::kFailure;
+    }
+
+    int totalAttrs, totalNodes;
+    ExtraAttrScanner::sharedIndex().getStatistics(totalAttrs, totalNodes);
+
+    setResult(MString("Scan complete: Found ") + totalAttrs + " extra attributes in " + totalNodes + " nodes");
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doJobCancel(int jobId)
+{
+    ScanJobState state;
+    size_t processed, total;
+    if (!ExtraAttrScanJobManager::instance().getStatus(jobId, state, processed, total)) {
+        MGlobal::displayError(MString("Scan job not found: ") + jobId);
+        return MS::kFailure;
+    }
+
+    setResult(ExtraAttrScanJobManager::instance().cancel(jobId));
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doSnapshot(const MString& name)
+{
+    // A snapshot records the current scene, not the last scan
+    ExtraAttrScanner* scanner = nullptr;
+    MStatus status = getSharedIndex(scanner, true);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    std::shared_ptr<ExtraAttrSnapshot> snapshot = ExtraAttrSnapshot::capture(*scanner);
+    ExtraAttrSnapshot::store(name, snapshot);
+
+    setResult(MString("Snapshot '") + name + "' captured: " +
+              static_cast<int>(snapshot->entryCount()) + " entries");
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doDiff(const MString& beforeName, const MString& afterName)
+{
+    std::shared_ptr<ExtraAttrSnapshot> before = ExtraAttrSnapshot::find(beforeName);
+    if (!before) {
+        MGlobal::displayError(MString("Snapshot not found: ") + beforeName);
+        return MS::kFailure;
+    }
+
+    std::shared_ptr<ExtraAttrSnapshot> after = ExtraAttrSnapshot::find(afterName);
+    if (!after) {
+        MGlobal::displayError(MString("Snapshot not found: ") + afterName);
+        return MS::kFailure;
+    }
+
+    MStringArray result;
+    ExtraAttrSnapshot::diff(*before, *after, result);
+
+    setResult(result);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doRename(const MString& oldName, const MString& newName)
+{
+    if (newName.length() == 0 || newName == oldName) {
+        MGlobal::displayError("New attribute name must differ from the current name");
+        return MS::kFailure;
+    }
+
+    if (!MayaUtils::isValidAttributeName(newName)) {
+        MGlobal::displayError(MString("Invalid attribute name: ") + newName +
+                              " (use letters, digits and underscores, not starting with a digit)");
+        return MS::kFailure;
+    }
+
+    // Rescan so nodes that gained or lost the attribute since the last scan are seen
+    ExtraAttrScanner* scanner = nullptr;
+    MStatus status = getSharedIndex(scanner, true);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    // Visit only the nodes the index records for this attribute
+    const std::vector<MObjectHandle>* nodes = scanner->getNodeList(oldName);
+    if (!nodes) {
+        MGlobal::displayError(MString("Attribute not found in index: ") + oldName);
+        return MS::kFailure;
+    }
+
+    std::vector<MObject> renamedNodes;
+    renamedNodes.reserve(nodes->size());
+    int conflictCount = 0;
+
+    for (const MObjectHandle& handle : *nodes) {
+        if (!handle.isValid()) {
+            continue;
+        }
+
+        MObject node = handle.object();
+        MFnDependencyNode fnDep(node, &status);
+        if (status != MS::kSuccess) {
+            continue;
+        }
+
+        MObject attr = fnDep.attribute(oldName, &status);
+        if (status != MS::kSuccess || attr.isNull()) {
+            continue;
+        }
+
+        if (fnDep.hasAttribute(newName)) {
+            conflictCount++;
+            continue;
+        }
+
+        // Keep a distinct short name, otherwise follow the long name
+        MFnAttribute fnAttr(attr);
+        MString shortName = fnAttr.shortName();
+        if (shortName == oldName) {
+            shortName = newName;
+        }
+
+        status = m_dgModifier.renameAttribute(node, attr, shortName, newName);
+        if (status != MS::kSuccess) {
+            continue;
+        }
+        renamedNodes.push_back(node);
+    }
+
+    if (conflictCount > 0) {
+        MGlobal::displayError(MString("Cannot rename: ") + conflictCount +
+                              " node(s) already have an attribute named " + newName);
+        return MS::kFailure;
+    }
+
+    if (renamedNodes.empty()) {
+        MGlobal::displayError(MString("No nodes with attribute: ") + oldName);
+        return MS::kFailure;
+    }
+
+    m_undoData.attrName = oldName;
+    m_undoData.newAttrName = newName;
+    m_undoData.nodes.swap(renamedNodes);
+    m_undoData.wasRenamed = true;
+    m_isUndoable = true;
+
+    status = redoIt();
+    if (status != MS::kSuccess) {
+        MGlobal::displayError("Failed to rename attribute");
+        m_isUndoable = false;
+        return status;
+    }
+
+    int renamedCount = static_cast<int>(m_undoData.nodes.size());
+    setResult(renamedCount);
+    MGlobal::displayInfo(MString("Renamed ") + oldName + " to " + newName + " on " + renamedCount + " nodes");
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doPurge(const MString& attrName, const MString& nodeType,
+                                     const MString& nameSpace, bool dryRun)
+{
+    // Rescan so both the purge and the dry-run count reflect the current scene
+    ExtraAttrScanner* scanner = nullptr;
+    MStatus status = getSharedIndex(scanner, true);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    const auto& attrMap = scanner->getAttributeInfoMap();
+    auto infoIt = attrMap.find(attrName);
+    const std::vector<MObjectHandle>* nodes = scanner->getNodeList(attrName);
+    if (infoIt == attrMap.end() || !nodes) {
+        MGlobal::displayError(MString("Attribute not found in index: ") + attrName);
+        return MS::kFailure;
+    }
+
+    // Accept "ns", ":ns" and "ns:" alike
+    MString ns = nameSpace;
+    if (ns.length() > 0 && ns.asChar()[0] == ':') {
+        ns = ns.substring(1, ns.length() - 1);
+    }
+    if (ns.length() > 0 && ns.asChar()[ns.length() - 1] == ':') {
+        ns = ns.substring(0, ns.length() - 2);
+    }
+    MString nsPrefix = ns + ":";
+
+    std::vector<MObject> purgedNodes;
+    purgedNodes.reserve(nodes->size());
+    MStringArray result;
+
+    for (const MObjectHandle& handle : *nodes) {
+        if (!handle.isValid()) {
+            continue;
+        }
+
+        MObject node = handle.object();
+        MFnDependencyNode fnDep(node, &status);
+        if (status != MS::kSuccess) {
+            continue;
+        }
+
+        if (nodeType.length() > 0 && fnDep.typeName() != nodeType) {
+            continue;
+        }
+
+        if (ns.length() > 0) {
+            // Include nodes in nested namespaces below the requested one
+            MString parentNs = fnDep.parentNamespace();
+            if (parentNs != ns && strncmp(parentNs.asChar(), nsPrefix.asChar(), nsPrefix.length()) != 0) {
+                continue;
+            }
+        }
+
+        MObject attr = fnDep.attribute(attrName, &status);
+        if (status != MS::kSuccess || attr.isNull()) {
+            continue;
+        }
+
+        if (!dryRun) {
+            status = m_dgModifier.removeAttribute(node, attr);
+            if (status != MS::kSuccess) {
+                continue;
+            }
+        }
+
+        purgedNodes.push_back(node);
+        result.append(fnDep.name());
+    }
+
+    if (dryRun || purgedNodes.empty()) {
+        setResult(result);
+        return MS::kSuccess;
+    }
+
+    m_undoData.attrName = attrName;
+    m_undoData.attrInfo = *infoIt->second;
+    m_undoData.nodes.swap(purgedNodes);
+    m_undoData.wasPurged = true;
+    m_isUndoable = true;
+
+    status = redoIt();
+    if (status != MS::kSuccess) {
+        MGlobal::displayError("Failed to purge attribute");
+        m_isUndoable = false;
+        return status;
+    }
+
+    MGlobal::displayInfo(MString("Purged attribute ") + attrName + " from " + result.length() + " nodes");
+    setResult(result);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doExtract(const std::vector<MString>& materials, const MString& objectName,
+                                       bool keepOriginal, bool combine)
+{
+    MStatus status;
+    std::vector<MObject> shadingNodes;
+    std::vector<MString> groupNames;
+    for (const MString& material : materials) {
+        MSelectionList list;
+        MObject node;
+        if (list.add(material) != MS::kSuccess || list.getDependNode(0, node) != MS::kSuccess) {
+            MGlobal::displayWarning(MString("Node not found: ") + material);
+            continue;
+        }
+        shadingNodes.push_back(node);
+
+        // With several materials each output is named after its material, without namespace
+        MString baseName = MFnDependencyNode(node).name();
+        int colon = baseName.rindex(':');
+        if (colon >= 0) {
+            baseName = baseName.substring(colon + 1, baseName.length() - 1);
+        }
+        groupNames.push_back(objectName + "_" + baseName);
+    }
+
+    std::vector<MeshPartition> partitions;
+    ExtraAttrShading::resolvePartitions(shadingNodes, partitions);
+    if (partitions.empty()) {
+        MGlobal::displayWarning("No polygons found for the given materials");
+        setResult(MStringArray());
+        return MS::kSuccess;
+    }
+
+    // Faces with holes cannot be rebuilt from buffers; their meshes are copied
+    // and trimmed instead, which a combined mesh cannot use
+    std::vector<char> copiedSources(partitions.size(), 0);
+    for (size_t i = 0; i < partitions.size(); ++i) {
+        const MeshPartition& partition = partitions[i];
+        if (partition.geometrySource != static_cast<int>(i)) {
+            continue;
+        }
+        if (ExtraAttrExtract::hasHoles(partition.meshPath, partition.faceGroups)) {
+            if (combine) {
+                MGlobal::displayError(MString("Cannot combine faces with holes: ") + partition.meshPath.fullPathName());
+                return MS::kFailure;
+            }
+            copiedSources[i] = 1;
+        }
+    }
+
+    // One new transform per source mesh instance and material, or a single one
+    // when combining; the shapes are built in redoIt()
+    std::vector<int> outputGroups;
+    if (!combine) {
+        for (const MeshPartition& partition : partitions) {
+            for (size_t group = 0; group < partition.groupSizes.size(); ++group) {
+                if (partition.groupSizes[group] > 0) {
+                    outputGroups.push_back(static_cast<int>(group));
+                }
+            }
+        }
+    }
+
+    size_t transformCount = combine ? 1 : outputGroups.size();
+    for (size_t i = 0; i < transformCount; ++i) {
+        MObject transform = m_dagModifier.createNode("transform", MObject::kNullObj, &status);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Failed to create transform for extracted mesh");
+            return status;
+        }
+
+        // Name separate outputs after their material when several are extracted
+        bool perMaterial = !combine && shadingNodes.size() > 1;
+        m_dagModifier.renameNode(transform, perMaterial ? groupNames[outputGroups[i]] : objectName);
+        m_undoData.transforms.push_back(transform);
+    }
+
+    // Source faces go through polyDelFacet, so construction history is kept.
+    // Instances share their shape, so each shape is edited once, with the
+    // faces extracted from any of its instances
+    if (!keepOriginal) {
+        std::vector<std::vector<char>> shapeFaces(partitions.size());
+        for (size_t i = 0; i < partitions.size(); ++i) {
+            const MeshPartition& partition = partitions[i];
+            if (partition.geometrySource != static_cast<int>(i)) {
+                continue;  // Same faces as an earlier instance
+            }
+
+            std::vector<char>& extracted = shapeFaces[partition.shapeOwner];
+            extracted.resize(partition.faceGroups.size(), 0);
+            for (size_t face = 0; face < partition.faceGroups.size(); ++face) {
+                if (partition.faceGroups[face] >= 0) {
+                    extracted[face] = 1;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < partitions.size(); ++i) {
+            if (partitions[i].shapeOwner != static_cast<int>(i)) {
+                continue;
+            }
+
+            MeshFaceSet faceSet;
+            faceSet.meshPath = partitions[i].meshPath;
+            faceSet.faceCount = static_cast<int>(shapeFaces[i].size());
+            for (int face = 0; face < faceSet.faceCount; ++face) {
+                if (shapeFaces[i][face]) {
+                    faceSet.faces.push_back(face);
+                }
+            }
+
+            MStringArray faceNames;
+            ExtraAttrShading::getFaceRangeNames(faceSet, faceNames);
+
+            MString command("polyDelFacet");
+            for (unsigned int j = 0; j < faceNames.length(); ++j) {
+                command += MString(" \"") + faceNames[j] + "\"";
+            }
+            m_dgModifier.commandToExecute(command);
+        }
+    }
+
+    m_undoData.partitions.swap(partitions);
+    m_undoData.copiedSources.swap(copiedSources);
+    m_undoData.combine = combine;
+    m_undoData.wasExtracted = true;
+    m_isUndoable = true;
+
+    status = redoIt();
+    if (status != MS::kSuccess) {
+        MGlobal::displayError("Failed to extract polygons");
+        m_isUndoable = false;
+        return status;
+    }
+
+    MStringArray result;
+    for (const MObject& transform : m_undoData.transforms) {
+        result.append(MFnDagNode(transform).fullPathName());
+    }
+    MGlobal::displayInfo(MString("Extracted ") + result.length() + " object(s)");
+    setResult(result);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doMaterialFaces(const std::vector<MString>& materials)
+{
+    std::vector<MObject> shadingNodes;
+    for (const MString& material : materials) {
+        MSelectionList list;
+        MObject node;
+        if (list.add(material) != MS::kSuccess || list.getDependNode(0, node) != MS::kSuccess) {
+            MGlobal::displayWarning(MString("Node not found: ") + material);
+            continue;
+        }
+        shadingNodes.push_back(node);
+    }
+
+    std::vector<MeshFaceSet> faceSets;
+    ExtraAttrShadingIndex::sharedIndex().resolveFaces(shadingNodes, faceSets);
+
+    // Runs of consecutive faces come back as one name each
+    MStringArray result;
+    for (const MeshFaceSet& faceSet : faceSets) {
+        ExtraAttrShading::getFaceRangeNames(faceSet, result);
+    }
+
+    setResult(result);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::redoExtract()
+{
+    MStatus status = m_dagModifier.doIt();
+    if (status != MS::kSuccess) {
+        m_dagModifier.undoIt();
+        return status;
+    }
+
+    // Meshes are read on the main thread a batch at a time, split on worker
+    // threads, and written back on the main thread; all before any face is deleted
+    const std::vector<MeshPartition>& partitions = m_undoData.partitions;
+    size_t batchSize = std::max(1u, std::thread::hardware_concurrency());
+    m_undoData.shapes.clear();
+
+    // Instances with the same face groups are read and split once; each of
+    // them then gets the resulting meshes with its own placement
+    std::vector<size_t> sources;
+    std::vector<std::vector<size_t>> instances(partitions.size());
+    std::vector<size_t> firstTransform(partitions.size());
+    size_t transformCount = 0;
+    for (size_t i = 0; i < partitions.size(); ++i) {
+        if (partitions[i].geometrySource == static_cast<int>(i)) {
+            sources.push_back(i);
+        }
+        instances[partitions[i].geometrySource].push_back(i);
+
+        // Transforms were created in partition order, one per non-empty group
+        firstTransform[i] = transformCount;
+        for (int size : partitions[i].groupSizes) {
+            if (size > 0) {
+                ++transformCount;
+            }
+        }
+    }
+
+    // With -combine every group is appended in world space to one mesh
+    struct CombinedGroup {
+        size_t partition;
+        int group;
+        int faceOffset;
+    };
+    MeshBuffers combined;
+    std::vector<CombinedGroup> combinedGroups;
+
+    for (size_t batchStart = 0; batchStart < sources.size(); batchStart += batchSize) {
+        size_t batchEnd = std::min(sources.size(), batchStart + batchSize);
+        std::vector<PartitionJob> jobs(batchEnd - batchStart);
+
+        for (size_t i = batchStart; i < batchEnd; ++i) {
+            const MeshPartition& partition = partitions[sources[i]];
+            PartitionJob& job = jobs[i - batchStart];
+            job.faceGroups = &partition.faceGroups;
+            if (m_undoData.copiedSources[sources[i]]) {
+                continue;  // Copied below; no groups to split
+            }
+            status = ExtraAttrExtract::readMesh(partition.meshPath, job.source);
+            if (status != MS::kSuccess) {
+                MGlobal::displayError(MString("Failed to read mesh: ") + partition.meshPath.fullPathName());
+                removeExtractedObjects();
+                return status;
+            }
+            job.groupCount = static_cast<int>(partition.groupSizes.size());
+        }
+
+        ExtraAttrExtract::partitionAll(jobs);
+
+        for (size_t i = batchStart; i < batchEnd; ++i) {
+            PartitionJob& job = jobs[i - batchStart];
+            bool copied = m_undoData.copiedSources[sources[i]] != 0;
+
+            for (size_t instance : instances[sources[i]]) {
+                const MeshPartition& partition = partitions[instance];
+                size_t nextTransform = firstTransform[instance];
+
+                for (int group = 0; group < static_cast<int>(partition.groupSizes.size()); ++group) {
+                    if (partition.groupSizes[group] == 0) {
+                        continue;
+                    }
+
+                    if (m_undoData.combine) {
+                        combinedGroups.push_back({instance, group, combined.faceCount()});
+                        ExtraAttrExtract::appendMesh(combined, job.outMeshes[group], partition.meshPath.inclusiveMatrix());
+                        continue;
+                    }
+
+                    const MObject& transform = m_undoData.transforms[nextTransform++];
+
+                    MObject shape;
+                    if (copied) {
+                        status = ExtraAttrExtract::copyFaces(partition.meshPath, partition.faceGroups, group,
+                                                             transform, shape);
+                    } else {
+                        status = ExtraAttrExtract::createMesh(job.outMeshes[group], transform, shape);
+                    }
+                    if (!shape.isNull()) {
+                        m_undoData.shapes.push_back(shape);  // A copy may exist even if trimming it failed
+                    }
+                    if (status != MS::kSuccess) {
+                        MGlobal::displayError(MString("Failed to create mesh from: ") + partition.meshPath.fullPathName());
+                        removeExtractedObjects();
+                        return status;
+                    }
+
+                    MFnDagNode fnTransform(transform);
+                    MFnDagNode(shape).setName(fnTransform.name() + "Shape");
+                    ExtraAttrExtract::matchPlacement(partition.meshPath, transform);
+                    ExtraAttrExtract::copyShaderAssignment(partition, group, shape);
+                }
+            }
+
+            // Free each source as soon as its outputs exist
+            job.source.clear();
+            job.outMeshes.clear();
+        }
+    }
+
+    if (m_undoData.combine) {
+        const MObject& transform = m_undoData.transforms[0];
+        MObject shape;
+        status = ExtraAttrExtract::createMesh(combined, transform, shape);
+        if (status != MS::kSuccess) {
+            MGlobal::displayError("Failed to create combined mesh");
+            removeExtractedObjects();
+            return status;
+        }
+        m_undoData.shapes.push_back(shape);
+
+        MFnDagNode fnTransform(transform);
+        MFnDagNode(shape).setName(fnTransform.name() + "Shape");
+        for (const CombinedGroup& entry : combinedGroups) {
+            ExtraAttrExtract::copyShaderAssignment(partitions[entry.partition], entry.group, shape, entry.faceOffset);
+        }
+    }
+
+    // The command is not undoable after a failure, so nothing partial may stay in the scene
+    status = m_dgModifier.doIt();
+    if (status != MS::kSuccess) {
+        m_dgModifier.undoIt();
+        removeExtractedObjects();
+    }
+    return status;
+}
+
+MStatus ExtraAttrManagerCmd::undoExtract()
+{
+    MStatus status = m_dgModifier.undoIt();
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    return removeExtractedObjects();
+}
+
+MStatus ExtraAttrManagerCmd::removeExtractedObjects()
+{
+    // The shapes were made by MFnMesh::create, outside the DAG modifier
+    MDGModifier shapeModifier;
+    for (const MObject& shape : m_undoData.shapes) {
+        shapeModifier.deleteNode(shape);
+    }
+    shapeModifier.doIt();
+    m_undoData.shapes.clear();
+
+    return m_dagModifier.undoIt();
+}
+
+MStatus ExtraAttrManagerCmd::doStats(const MString& attrName)
+{
+    ExtraAttrScanner* scanner = nullptr;
+    MStatus status = getSharedIndex(scanner);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    std::vector<double> values;
+    if (!scanner->getNumericValues(attrName, values)) {
+        MGlobal::displayError(MString("Not an indexed numeric attribute: ") + attrName);
         return MS::kFailure;
     }
 
-    const auto& attrMap = scanner.getAttributeInfoMap();
+    ValueStatistics stats = ExtraAttrStats::computeValueStatistics(values.data(), values.size());
+
+    // Result: count, skipped (inf/NaN) count, min, max, mean, stddev, distinct count,
+    // then one count per histogram bin
+    MDoubleArray result;
+    result.append(static_cast<double>(stats.count));
+    result.append(static_cast<double>(stats.skippedCount));
+    result.append(stats.minValue);
+    result.append(stats.maxValue);
+    result.append(stats.mean);
+    result.append(stats.stddev);
+    result.append(static_cast<double>(stats.distinctCount));
+    for (size_t binCount : stats.histogram) {
+        result.append(static_cast<double>(binCount));
+    }
+
+    MGlobal::displayInfo(MString("Stats for ") + attrName + ": count=" + static_cast<int>(stats.count) +
+                         " min=" + stats.minValue + " max=" + stats.maxValue +
+                         " mean=" + stats.mean + " stddev=" + stats.stddev +
+                         " distinct=" + static_cast<int>(stats.distinctCount));
+    if (stats.skippedCount > 0) {
+        MGlobal::displayWarning(MString("Skipped ") + static_cast<int>(stats.skippedCount) +
+                                " non-finite value(s) of " + attrName);
+    }
+
+    setResult(result);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doQuery(const MString& attrName, const std::vector<MString>& values,
+                                     unsigned int requiredFlags, unsigned int excludedFlags)
+{
+    ExtraAttrScanner* scanner = nullptr;
+    MStatus status = getSharedIndex(scanner);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    // Flags come from the index, so the flag filter reads no plugs
+    std::vector<MObject> flagNodes;
+    bool filterFlags = requiredFlags != 0 || excludedFlags != 0;
+    if (filterFlags && !scanner->findNodesWithPlugFlags(attrName, requiredFlags, excludedFlags, flagNodes)) {
+        MGlobal::displayError(MString("Attribute not found in index: ") + attrName);
+        return MS::kFailure;
+    }
+
+    std::vector<MObject> nodes;
+    if (values.empty()) {
+        nodes.swap(flagNodes);
+    } else {
+        if (!scanner->findNodesWithValues(attrName, values, nodes)) {
+            MGlobal::displayError(MString("Attribute not found in index: ") + attrName);
+            return MS::kFailure;
+        }
+
+        if (filterFlags) {
+            // Keep value matches that also pass the flag filter, bucketed by handle hash
+            std::unordered_multimap<unsigned int, MObject> passed;
+            passed.reserve(flagNodes.size());
+            for (const MObject& node : flagNodes) {
+                passed.emplace(MObjectHandle(node).hashCode(), node);
+            }
+
+            std::vector<MObject> kept;
+            for (const MObject& node : nodes) {
+                auto range = passed.equal_range(MObjectHandle(node).hashCode());
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (it->second == node) {
+                        kept.push_back(node);
+                        break;
+                    }
+                }
+            }
+            nodes.swap(kept);
+        }
+    }
+
+    MStringArray result;
+    for (const MObject& node : nodes) {
+        if (node.isNull()) {
+            continue;
+        }
+        result.append(MFnDependencyNode(node).name());
+    }
+
+    setResult(result);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doValueIndex(bool enabled)
+{
+    ExtraAttrScanner::sharedIndex().setValueIndexEnabled(enabled);
+    MGlobal::displayInfo(MString("Value index ") + (enabled ? "enabled" : "disabled") +
+                         ". Rescan to apply.");
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doSearch(const MString& pattern, bool isRegex)
+{
+    ExtraAttrScanner* scanner = nullptr;
+    MStatus status = getSharedIndex(scanner);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    std::vector<SearchMatch> matches;
+    if (!scanner->search(pattern, isRegex, matches)) {
+        MGlobal::displayError(MString("Invalid regular expression: ") + pattern);
+        return MS::kInvalidParameter;
+    }
+
+    // Result lines: "attribute: <name>", "node: <name>" or "value: <node.attr> = <value>"
+    MStringArray result;
+    for (const SearchMatch& match : matches) {
+        switch (match.kind) {
+            case SearchMatch::kAttribute:
+                result.append(MString("attribute: ") + match.name);
+                break;
+            case SearchMatch::kNode:
+                result.append(MString("node: ") + match.name);
+                break;
+            case SearchMatch::kValue:
+                result.append(MString("value: ") + match.name + " = " + match.valueStr);
+                break;
+        }
+    }
+
+    setResult(result);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doCodecBenchmark(int count)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Values spread over many magnitudes, including ones without a short decimal form
+    std::vector<double> values(static_cast<size_t>(count));
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    for (double& value : values) {
+        value = std::ldexp(mantissa(rng), exponent(rng));
+    }
+
+    // Codec: format into one buffer, then parse it back
+    Clock::time_point start = Clock::now();
+    std::string text;
+    text.reserve(values.size() * 24);
+    ExtraAttrValueCodec::appendDoubles(text, values.data(), values.size(), 1);
+    double codecFormatSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    std::vector<double> parsed;
+    parsed.reserve(values.size());
+    bool parseOk = ExtraAttrValueCodec::parseDoubles(text.c_str(), parsed);
+    double codecParseSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    int mismatches = 0;
+    if (!parseOk || parsed.size() != values.size()) {
+        mismatches = count;
+    } else {
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (parsed[i] != values[i]) {
+                ++mismatches;
+            }
+        }
+    }
+
+    // Other value forms: tuples, float and int arrays, and unit values shown in UI units
+    int vectorMismatches = 0;
+    size_t tupleCount = values.size() - values.size() % 3;
+    text.clear();
+    ExtraAttrValueCodec::appendDoubles(text, values.data(), tupleCount, 3);
+    if (!ExtraAttrValueCodec::parseDoubles(text.c_str(), parsed) || parsed.size() != tupleCount) {
+        vectorMismatches = static_cast<int>(tupleCount / 3);
+    } else {
+        for (size_t i = 0; i < tupleCount; i += 3) {
+            if (parsed[i] != values[i] || parsed[i + 1] != values[i + 1] || parsed[i + 2] != values[i + 2]) {
+                ++vectorMismatches;
+            }
+        }
+    }
+
+    int arrayMismatches = 0;
+    std::vector<float> floatValues(values.begin(), values.end());
+    std::vector<float> parsedFloats;
+    text.clear();
+    ExtraAttrValueCodec::appendFloats(text, floatValues.data(), floatValues.size(), 1);
+    if (!ExtraAttrValueCodec::parseFloats(text.c_str(), parsedFloats) || parsedFloats != floatValues) {
+        ++arrayMismatches;
+    }
+    std::vector<int> intValues(values.size());
+    std::uniform_int_distribution<int> anyInt(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    for (int& value : intValues) {
+        value = anyInt(rng);
+    }
+    std::vector<int> parsedInts;
+    text.clear();
+    ExtraAttrValueCodec::appendInts(text, intValues.data(), intValues.size());
+    if (!ExtraAttrValueCodec::parseInts(text.c_str(), parsedInts) || parsedInts != intValues) {
+        ++arrayMismatches;
+    }
+
+    // Same conversions as getPlugValueAsString and setAttributeValueFromString
+    int unitMismatches = 0;
+    for (double value : values) {
+        double uiValues[3] = {MDistance(value, MDistance::internalUnit()).asUnits(MDistance::uiUnit()),
+                              MAngle(value, MAngle::internalUnit()).asUnits(MAngle::uiUnit()),
+                              MTime(value, MTime::kSeconds).as(MTime::uiUnit())};
+        for (double& uiValue : uiValues) {
+            std::string unitText;
+            ExtraAttrValueCodec::appendDouble(unitText, uiValue);
+            ExtraAttrValueCodec::parseDouble(unitText.c_str(), uiValue);
+        }
+
+        double internalValues[3] = {MDistance(uiValues[0], MDistance::uiUnit()).asUnits(MDistance::internalUnit()),
+                                    MAngle(uiValues[1], MAngle::uiUnit()).asUnits(MAngle::internalUnit()),
+                                    MTime(uiValues[2], MTime::uiUnit()).as(MTime::kSeconds)};
+        for (double internalValue : internalValues) {
+            if (internalValue != value) {
+                ++unitMismatches;
+            }
+        }
+    }
+
+    // Previous path: MString concatenation and MString::asDouble
+    start = Clock::now();
+    MStringArray legacyText;
+    for (double value : values) {
+        legacyText.append(MString() + value);
+    }
+    double legacyFormatSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    int legacyMismatches = 0;
+    for (unsigned int i = 0; i < legacyText.length(); ++i) {
+        if (legacyText[i].asDouble() != values[i]) {
+            ++legacyMismatches;
+        }
+    }
+    double legacyParseSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    auto perSecond = [count](double seconds) {
+        return seconds > 0.0 ? count / seconds : 0.0;
+    };
+
+    // Result: values/s for codec format, codec parse, MString format, MString parse, then mismatch counts
+    // for codec scalars, MString scalars, vectors, arrays (one per array type) and unit values (one per unit type)
+    MDoubleArray result;
+    result.append(perSecond(codecFormatSeconds));
+    result.append(perSecond(codecParseSeconds));
+    result.append(perSecond(legacyFormatSeconds));
+    result.append(perSecond(legacyParseSeconds));
+    result.append(static_cast<double>(mismatches));
+    result.append(static_cast<double>(legacyMismatches));
+    result.append(static_cast<double>(vectorMismatches));
+    result.append(static_cast<double>(arrayMismatches));
+    result.append(static_cast<double>(unitMismatches));
+
+    MGlobal::displayInfo(MString("Codec: format ") + perSecond(codecFormatSeconds) + " values/s, parse " +
+                         perSecond(codecParseSeconds) + " values/s, " + mismatches + " round-trip mismatches");
+    MGlobal::displayInfo(MString("MString: format ") + perSecond(legacyFormatSeconds) + " values/s, parse " +
+                         perSecond(legacyParseSeconds) + " values/s, " + legacyMismatches + " round-trip mismatches");
+    MGlobal::displayInfo(MString("Codec: ") + vectorMismatches + " vector, " + arrayMismatches + " array, " +
+                         unitMismatches + " unit value (UI unit conversion) round-trip mismatches");
+
+    setResult(result);
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::getSharedIndex(ExtraAttrScanner*& outScanner, bool rescan)
+{
+    ExtraAttrScanner& scanner = ExtraAttrScanner::sharedIndex();
+
+    // The index is dropped when the scene changes, so a missing scan is made on first use
+    if (rescan || !scanner.hasScanResults()) {
+        if (!scanner.scanScene()) {
+            MGlobal::displayError("Failed to scan scene");
+            return MS::kFailure;
+        }
+        ExtraAttrUI::notifyIndexChanged();
+    }
+
+    outScanner = &scanner;
+    return MS::kSuccess;
+}
+
+MStatus ExtraAttrManagerCmd::doList()
+{
+    // Attributes added or removed outside this command are not tracked, so list from a fresh scan
+    ExtraAttrScanner* scanner = nullptr;
+    MStatus status = getSharedIndex(scanner, true);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    const auto& attrMap = scanner->getAttributeInfoMap();
 
     MStringArray result;
     for (const auto& pair : attrMap) {
@@ -226,13 +1546,13 @@ MStatus ExtraAttrManagerCmd::doList()
 
 MStatus ExtraAttrManagerCmd::doGetNodes(const MString& attrName)
 {
-    ExtraAttrScanner scanner;
-    if (!scanner.scanScene()) {
-        MGlobal::displayError("Failed to scan scene");
-        return MS::kFailure;
+    ExtraAttrScanner* scanner = nullptr;
+    MStatus status = getSharedIndex(scanner, true);
+    if (status != MS::kSuccess) {
+        return status;
     }
 
-    std::vector<NodeAttributeValue> nodeValues = scanner.getNodesWithAttribute(attrName);
+    std::vector<NodeAttributeValue> nodeValues = scanner->getNodesWithAttribute(attrName);
 
     MStringArray result;
     for (const auto& nodeValue : nodeValues) {
@@ -411,6 +1731,32 @@ MStatus ExtraAttrManagerCmd::doHelp()
         "\n"
         "Flags:\n"
         "  -scan/-s                         : Scan scene for extra attributes\n"
+        "  -async/-as                       : With -scan, scan in idle time and return a job ID\n"
+        "  -jobStatus/-js <id>              : Get state and progress of a scan job\n"
+        "  -jobWait/-jw <id>                : Finish a scan job and publish its results\n"
+        "  -jobCancel/-jc <id>              : Cancel a scan job\n"
+        "  -snapshot/-ss <name>             : Capture a hashed snapshot of the index\n"
+        "  -diff/-df <a> <b>                : List added (+), removed (-) and changed (~) entries\n"
+        "  -rename/-rn <old> <new>          : Rename attribute on all nodes (undoable)\n"
+        "  -purge/-pg <attr>                : Remove attribute from all nodes (undoable)\n"
+        "  -nodeType/-nt <type>             : With -purge, only nodes of this type\n"
+        "  -namespace/-ns <ns>              : With -purge, only nodes in this namespace\n"
+        "  -dryRun/-dr                      : With -purge, list affected nodes only\n"
+        "  -extract/-ex <material>          : Extract faces of a material, one object per mesh and material (repeatable, undoable)\n"
+        "  -extractName/-xn <name>          : With -extract, name of the new objects\n"
+        "  -keepOriginal/-ko                : With -extract, keep the source faces\n"
+        "  -combine/-cb                     : With -extract, write all faces to one mesh\n"
+        "  -materialFaces/-mf <material>    : Get the faces of a material as range names (repeatable)\n"
+        "  -stats/-st <attr>                : Get count, skipped, min, max, mean, stddev, distinct, histogram\n"
+        "  -query/-qr <attr>                : Get nodes whose value matches an -equals value\n"
+        "  -equals/-eq <value>              : With -query, accepted value (repeatable)\n"
+        "  -withFlags/-wf <names>           : With -query, only occurrences with all these flags\n"
+        "  -withoutFlags/-wof <names>       : With -query, only occurrences with none of these flags\n"
+        "                                     (connected, animated, locked, keyable, default; as of the last scan)\n"
+        "  -valueIndex/-vi <on|off>         : Toggle the inverted value index (default off; next scan)\n"
+        "  -search/-sr <text>               : Search attribute/node names and string values\n"
+        "  -regex/-rx                       : With -search, text is a regular expression\n"
+        "  -codecBenchmark/-cbm <count>     : Measure value format/parse throughput and round trips\n"
         "  -list/-ls                        : List all extra attributes\n"
         "  -nodes/-n <attrName>             : Get nodes with specific attribute\n"
         "  -ui/-showUI                      : Show UI window\n"
@@ -422,6 +1768,18 @@ MStatus ExtraAttrManagerCmd::doHelp()
         "\n"
         "Examples:\n"
         "  exAttrManager -scan;\n"
+        "  exAttrManager -scan -async;\n"
+        "  exAttrManager -jobWait 1;\n"
+        "  exAttrManager -snapshot \"before\";\n"
+        "  exAttrManager -diff \"before\" \"after\";\n"
+        "  exAttrManager -rename \"oldAttr\" \"newAttr\";\n"
+        "  exAttrManager -purge \"legacyAttr\" -namespace \"char\" -dryRun;\n"
+        "  exAttrManager -extract \"blinn1\" -extractName \"extracted\";\n"
+        "  exAttrManager -materialFaces \"blinn1\";\n"
+        "  exAttrManager -stats \"lodLevel\";\n"
+        "  exAttrManager -query \"assetType\" -equals \"prop\" -equals \"set\";\n"
+        "  exAttrManager -query \"assetType\" -withoutFlags \"locked default\";\n"
+        "  exAttrManager -search \"geo_LOD[0-9]\" -regex;\n"
         "  exAttrManager -list;\n"
         "  exAttrManager -nodes \"myCustomAttr\";\n"
         "  exAttrManager -ui;\n"
@@ -3,6 +3,9 @@
 #include <maya/MStatus.h>
 #include "ExtraAttrManagerCmd.h"
 #include "ExtraAttrUI.h"
+#include "ExtraAttrScanJob.h"
+#include "ExtraAttrShadingIndex.h"
+#include "MayaUtils.h"
 
 /**
  * @brief Plugin initialization function
@@ -27,6 +30,9 @@ MStatus initializePlugin(MObject obj)
         return status;
     }
 
+    // Drop the shared index whenever the scene is replaced
+    ExtraAttrScanJobManager::instance().installSceneCallbacks();
+
     // Use Python to add menu with deferred execution
     // Define the function first, then schedule it to run when Maya UI is ready
     MString pythonScript =
@@ -114,6 +120,16 @@ MStatus uninitializePlugin(MObject obj)
         "    mc.deleteUI('ExtraAttrEditorMenuItem')\n";
     MGlobal::executePythonCommand(removePythonScript);
 
+    // Stop background scan jobs before the idle and scene callback code is unloaded
+    ExtraAttrScanJobManager::instance().shutdown();
+
+    // Remove the shared index's value callbacks before their code is unloaded
+    ExtraAttrScanner::sharedIndex().clearCache();
+    MayaUtils::clearEnumFieldTables();
+
+    // Remove the shading index's callbacks for the same reason
+    ExtraAttrShadingIndex::sharedIndex().clear();
+
     // Cleanup UI singleton
     ExtraAttrUI::destroyInstance();
 
@@ -1,8 +1,254 @@
 #include "ExtraAttrModel.h"
+#include "ExtraAttrProxyModel.h"
+#include "ExtraAttrValueCodec.h"
+#include "MayaUtils.h"
+#include <QByteArray>
+#include <QMultiHash>
 #include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Above this many separate removed runs, a model reset is cheaper than row signals
+const int kMaxRemovedRuns = 256;
+
+// Compact the string pool once it holds this many times more strings than the rows reference
+const size_t kCompactFactor = 2;
+
+// Never compact pools smaller than this
+const size_t kCompactMinStrings = 1024;
+
+// Row change notifications, bound to a model's protected begin/end functions
+struct RowNotifier {
+    std::function<void(int, int)> beginRemove;
+    std::function<void()> endRemove;
+    std::function<void(int, int)> beginInsert;
+    std::function<void()> endInsert;
+    std::function<void(int, int)> changed;
+};
+
+/**
+ * @brief Update rows in place from a new row table, matching rows by key
+ *
+ * Removed rows are taken out in contiguous runs, rows whose displayed data
+ * changed are reported in contiguous runs, and new rows are appended in one
+ * block, so a refresh that edits a few rows only touches those rows.
+ *
+ * @param keyOf Returns the key of a row: keyOf(table, row)
+ * @param sameData Compares displayed data: sameData(rows, row, newRows, newRow)
+ * @return false if the change is too scattered; the caller should reset instead
+ */
+template <typename Table, typename KeyFn, typename SameDataFn>
+bool applyKeyedDiff(Table& rows, const Table& newRows, KeyFn keyOf, SameDataFn sameData, const RowNotifier& notifier)
+{
+    using Key = decltype(keyOf(newRows, 0));
+
+    QMultiHash<Key, int> newIndex;
+    newIndex.reserve(newRows.size());
+    for (int j = 0; j < newRows.size(); ++j) {
+        newIndex.insert(keyOf(newRows, j), j);
+    }
+
+    // Match each current row to an unused new row with the same key
+    std::vector<int> target(static_cast<size_t>(rows.size()), -1);
+    std::vector<char> used(static_cast<size_t>(newRows.size()), 0);
+    int removedRuns = 0;
+    for (int i = 0; i < rows.size(); ++i) {
+        const Key key = keyOf(rows, i);
+        for (auto it = newIndex.find(key); it != newIndex.end() && it.key() == key; ++it) {
+            if (!used[it.value()]) {
+                target[i] = it.value();
+                used[it.value()] = 1;
+                break;
+            }
+        }
+        if (target[i] < 0 && (i == 0 || target[i - 1] >= 0)) {
+            ++removedRuns;
+        }
+    }
+
+    if (removedRuns > kMaxRemovedRuns) {
+        return false;
+    }
+
+    // Remove unmatched rows bottom-up so earlier indices stay valid
+    for (int i = rows.size() - 1; i >= 0;) {
+        if (target[i] >= 0) {
+            --i;
+            continue;
+        }
+
+        int last = i;
+        while (i >= 0 && target[i] < 0) {
+            --i;
+        }
+        int first = i + 1;
+
+        notifier.beginRemove(first, last);
+        rows.erase(first, last);
+        target.erase(target.begin() + first, target.begin() + last + 1);
+        notifier.endRemove();
+    }
+
+    // Refresh matched rows and report changed runs
+    int changedStart = -1;
+    for (int i = 0; i < rows.size(); ++i) {
+        bool changed = !sameData(rows, i, newRows, target[i]);
+        rows.assign(i, newRows, target[i]);
+
+        if (changed && changedStart < 0) {
+            changedStart = i;
+        } else if (!changed && changedStart >= 0) {
+            notifier.changed(changedStart, i - 1);
+            changedStart = -1;
+        }
+    }
+    if (changedStart >= 0) {
+        notifier.changed(changedStart, rows.size() - 1);
+    }
+
+    // Append new rows in one block
+    int insertCount = 0;
+    for (char isUsed : used) {
+        if (!isUsed) {
+            ++insertCount;
+        }
+    }
+    if (insertCount > 0) {
+        notifier.beginInsert(rows.size(), rows.size() + insertCount - 1);
+        for (int j = 0; j < newRows.size(); ++j) {
+            if (!used[j]) {
+                rows.append(newRows, j);
+            }
+        }
+        notifier.endInsert();
+    }
+
+    return true;
+}
+
+bool isMeshStatColumn(int column)
+{
+    return column >= NodeAttributeModel::COL_FACES && column <= NodeAttributeModel::COL_AREA;
+}
+
+// Value of a mesh statistics column, used for sorting
+double meshStatValue(const MaterialMeshStats& stats, int column)
+{
+    switch (column) {
+        case NodeAttributeModel::COL_FACES:
+            return stats.faceCount;
+        case NodeAttributeModel::COL_TRIANGLES:
+            return stats.triangleCount;
+        case NodeAttributeModel::COL_VERTICES:
+            return stats.vertexCount;
+        default:
+            return stats.surfaceArea;
+    }
+}
+
+QVariant meshStatDisplay(const MaterialMeshStats& stats, int column)
+{
+    if (column == NodeAttributeModel::COL_AREA) {
+        return QString::number(stats.surfaceArea, 'f', 2);
+    }
+    return static_cast<int>(meshStatValue(stats, column));
+}
+
+// Names of the set plug flags, in a fixed order
+QString plugFlagsDisplay(unsigned int flags)
+{
+    static const struct {
+        unsigned int flag;
+        const char* name;
+    } kNames[] = {
+        {MayaUtils::kPlugConnected, "connected"},
+        {MayaUtils::kPlugAnimated, "animated"},
+        {MayaUtils::kPlugLocked, "locked"},
+        {MayaUtils::kPlugKeyable, "keyable"},
+        {MayaUtils::kPlugDefault, "default"},
+    };
+
+    QString text;
+    for (const auto& entry : kNames) {
+        if (flags & entry.flag) {
+            if (!text.isEmpty()) {
+                text += ' ';
+            }
+            text += entry.name;
+        }
+    }
+    return text;
+}
+
+bool sameMeshStats(const MaterialMeshStats& a, const MaterialMeshStats& b)
+{
+    return a.faceCount == b.faceCount && a.triangleCount == b.triangleCount && a.vertexCount == b.vertexCount &&
+           a.surfaceArea == b.surfaceArea;
+}
+
+template <typename T>
+void eraseRange(std::vector<T>& column, int first, int last)
+{
+    column.erase(column.begin() + first, column.begin() + last + 1);
+}
+
+} // namespace
 
 // ========== ExtraAttrModel ==========
 
+int ExtraAttrModel::AttributeColumns::size() const
+{
+    return static_cast<int>(names.size());
+}
+
+void ExtraAttrModel::AttributeColumns::reserve(size_t rowCount)
+{
+    names.reserve(rowCount);
+    typeNames.reserve(rowCount);
+    usageCounts.reserve(rowCount);
+    isArray.reserve(rowCount);
+    infos.reserve(rowCount);
+}
+
+void ExtraAttrModel::AttributeColumns::clear()
+{
+    names.clear();
+    typeNames.clear();
+    usageCounts.clear();
+    isArray.clear();
+    infos.clear();
+}
+
+void ExtraAttrModel::AttributeColumns::append(const AttributeColumns& source, int sourceRow)
+{
+    names.push_back(source.names[sourceRow]);
+    typeNames.push_back(source.typeNames[sourceRow]);
+    usageCounts.push_back(source.usageCounts[sourceRow]);
+    isArray.push_back(source.isArray[sourceRow]);
+    infos.push_back(source.infos[sourceRow]);
+}
+
+void ExtraAttrModel::AttributeColumns::assign(int row, const AttributeColumns& source, int sourceRow)
+{
+    names[row] = source.names[sourceRow];
+    typeNames[row] = source.typeNames[sourceRow];
+    usageCounts[row] = source.usageCounts[sourceRow];
+    isArray[row] = source.isArray[sourceRow];
+    infos[row] = source.infos[sourceRow];
+}
+
+void ExtraAttrModel::AttributeColumns::erase(int first, int last)
+{
+    eraseRange(names, first, last);
+    eraseRange(typeNames, first, last);
+    eraseRange(usageCounts, first, last);
+    eraseRange(isArray, first, last);
+    eraseRange(infos, first, last);
+}
+
 ExtraAttrModel::ExtraAttrModel(QObject* parent)
     : QAbstractTableModel(parent)
 {
@@ -34,18 +280,18 @@ QVariant ExtraAttrModel::data(const QModelIndex& index, int role) const
         return QVariant();
     }
 
-    const AttributeRow& row = m_rows[index.row()];
+    int row = index.row();
 
     if (role == Qt::DisplayRole) {
         switch (index.column()) {
             case COL_ATTR_NAME:
-                return row.name;
+                return string(m_rows.names[row]);
             case COL_TYPE:
-                return row.typeName;
+                return string(m_rows.typeNames[row]);
             case COL_USAGE_COUNT:
-                return row.usageCount;
+                return m_rows.usageCounts[row];
             case COL_IS_ARRAY:
-                return row.isArray ? "Yes" : "No";
+                return m_rows.isArray[row] ? "Yes" : "No";
             default:
                 return QVariant();
         }
@@ -84,29 +330,51 @@ QVariant ExtraAttrModel::headerData(int section, Qt::Orientation orientation, in
 
 void ExtraAttrModel::loadFromScanner(const ExtraAttrScanner& scanner)
 {
-    beginResetModel();
-
-    m_rows.clear();
+    // New rows share the pool with the current ones, so equal IDs mean equal text
+    AttributeColumns newRows;
 
     const auto& attrMap = scanner.getAttributeInfoMap();
+    newRows.reserve(attrMap.size());
     for (const auto& pair : attrMap) {
-        AttributeRow row;
-        row.name = QString::fromUtf8(pair.first.asChar());
-        row.typeName = QString::fromUtf8(pair.second->typeName.asChar());
-        row.usageCount = pair.second->usageCount;
-        row.isArray = pair.second->isArray;
-        row.info = pair.second;
+        newRows.names.push_back(m_strings.intern(pair.first.asChar()));
+        newRows.typeNames.push_back(m_strings.intern(pair.second->typeName.asChar()));
+        newRows.usageCounts.push_back(pair.second->usageCount);
+        newRows.isArray.push_back(pair.second->isArray ? 1 : 0);
+        newRows.infos.push_back(pair.second);
+    }
 
-        m_rows.append(row);
+    RowNotifier notifier;
+    notifier.beginRemove = [this](int first, int last) { beginRemoveRows(QModelIndex(), first, last); };
+    notifier.endRemove = [this]() { endRemoveRows(); };
+    notifier.beginInsert = [this](int first, int last) { beginInsertRows(QModelIndex(), first, last); };
+    notifier.endInsert = [this]() { endInsertRows(); };
+    notifier.changed = [this](int first, int last) {
+        emit dataChanged(index(first, 0), index(last, COL_COUNT - 1));
+    };
+
+    // The info pointer is refreshed on every kept row; only displayed fields count as a change
+    bool applied = applyKeyedDiff(
+        m_rows, newRows, [](const AttributeColumns& rows, int row) { return rows.names[row]; },
+        [](const AttributeColumns& a, int rowA, const AttributeColumns& b, int rowB) {
+            return a.typeNames[rowA] == b.typeNames[rowB] && a.usageCounts[rowA] == b.usageCounts[rowB] &&
+                   a.isArray[rowA] == b.isArray[rowB];
+        },
+        notifier);
+
+    if (!applied) {
+        beginResetModel();
+        m_rows = std::move(newRows);
+        endResetModel();
     }
 
-    endResetModel();
+    compactStrings();
 }
 
 void ExtraAttrModel::clear()
 {
     beginResetModel();
     m_rows.clear();
+    m_strings.clear();
     endResetModel();
 }
 
@@ -115,7 +383,7 @@ QString ExtraAttrModel::getAttributeName(int row) const
     if (row < 0 || row >= m_rows.size()) {
         return QString();
     }
-    return m_rows[row].name;
+    return string(m_rows.names[row]);
 }
 
 std::shared_ptr<AttributeInfo> ExtraAttrModel::getAttributeInfo(int row) const
@@ -123,45 +391,101 @@ std::shared_ptr<AttributeInfo> ExtraAttrModel::getAttributeInfo(int row) const
     if (row < 0 || row >= m_rows.size()) {
         return nullptr;
     }
-    return m_rows[row].info;
+    return m_rows.infos[row];
 }
 
-void ExtraAttrModel::sort(int column, Qt::SortOrder order)
+QString ExtraAttrModel::string(uint32_t id) const
 {
-    if (m_rows.isEmpty()) {
+    return QString::fromUtf8(m_strings.text(id), static_cast<qsizetype>(m_strings.length(id)));
+}
+
+void ExtraAttrModel::compactStrings()
+{
+    size_t referenced = m_rows.names.size() + m_rows.typeNames.size();
+    if (m_strings.size() < kCompactMinStrings || m_strings.size() <= referenced * kCompactFactor) {
         return;
     }
 
-    emit layoutAboutToBeChanged();
+    // Only IDs change, so views see the same data and need no signal
+    m_strings.compact({&m_rows.names, &m_rows.typeNames});
+}
 
-    std::sort(m_rows.begin(), m_rows.end(), [column, order](const AttributeRow& a, const AttributeRow& b) {
-        bool result = false;
+// ========== NodeAttributeModel ==========
 
-        switch (column) {
-            case COL_ATTR_NAME:
-                result = a.name < b.name;
-                break;
-            case COL_TYPE:
-                result = a.typeName < b.typeName;
-                break;
-            case COL_USAGE_COUNT:
-                result = a.usageCount < b.usageCount;
-                break;
-            case COL_IS_ARRAY:
-                result = a.isArray < b.isArray;
-                break;
-            default:
-                result = a.name < b.name;
-                break;
-        }
+int NodeAttributeModel::NodeColumns::size() const
+{
+    return static_cast<int>(nodeNames.size());
+}
+
+void NodeAttributeModel::NodeColumns::reserve(size_t rowCount)
+{
+    nodeNames.reserve(rowCount);
+    nodeTypes.reserve(rowCount);
+    values.reserve(rowCount);
+    sortNumbers.reserve(rowCount);
+    hasSortNumber.reserve(rowCount);
+    typeFlags.reserve(rowCount);
+    isDriven.reserve(rowCount);
+    plugFlags.reserve(rowCount);
+    meshStats.reserve(rowCount);
+    hasMeshStats.reserve(rowCount);
+}
 
-        return (order == Qt::AscendingOrder) ? result : !result;
-    });
+void NodeAttributeModel::NodeColumns::clear()
+{
+    nodeNames.clear();
+    nodeTypes.clear();
+    values.clear();
+    sortNumbers.clear();
+    hasSortNumber.clear();
+    typeFlags.clear();
+    isDriven.clear();
+    plugFlags.clear();
+    meshStats.clear();
+    hasMeshStats.clear();
+}
 
-    emit layoutChanged();
+void NodeAttributeModel::NodeColumns::append(const NodeColumns& source, int sourceRow)
+{
+    nodeNames.push_back(source.nodeNames[sourceRow]);
+    nodeTypes.push_back(source.nodeTypes[sourceRow]);
+    values.push_back(source.values[sourceRow]);
+    sortNumbers.push_back(source.sortNumbers[sourceRow]);
+    hasSortNumber.push_back(source.hasSortNumber[sourceRow]);
+    typeFlags.push_back(source.typeFlags[sourceRow]);
+    isDriven.push_back(source.isDriven[sourceRow]);
+    plugFlags.push_back(source.plugFlags[sourceRow]);
+    meshStats.push_back(source.meshStats[sourceRow]);
+    hasMeshStats.push_back(source.hasMeshStats[sourceRow]);
 }
 
-// ========== NodeAttributeModel ==========
+void NodeAttributeModel::NodeColumns::assign(int row, const NodeColumns& source, int sourceRow)
+{
+    nodeNames[row] = source.nodeNames[sourceRow];
+    nodeTypes[row] = source.nodeTypes[sourceRow];
+    values[row] = source.values[sourceRow];
+    sortNumbers[row] = source.sortNumbers[sourceRow];
+    hasSortNumber[row] = source.hasSortNumber[sourceRow];
+    typeFlags[row] = source.typeFlags[sourceRow];
+    isDriven[row] = source.isDriven[sourceRow];
+    plugFlags[row] = source.plugFlags[sourceRow];
+    meshStats[row] = source.meshStats[sourceRow];
+    hasMeshStats[row] = source.hasMeshStats[sourceRow];
+}
+
+void NodeAttributeModel::NodeColumns::erase(int first, int last)
+{
+    eraseRange(nodeNames, first, last);
+    eraseRange(nodeTypes, first, last);
+    eraseRange(values, first, last);
+    eraseRange(sortNumbers, first, last);
+    eraseRange(hasSortNumber, first, last);
+    eraseRange(typeFlags, first, last);
+    eraseRange(isDriven, first, last);
+    eraseRange(plugFlags, first, last);
+    eraseRange(meshStats, first, last);
+    eraseRange(hasMeshStats, first, last);
+}
 
 NodeAttributeModel::NodeAttributeModel(QObject* parent)
     : QAbstractTableModel(parent)
@@ -194,19 +518,49 @@ QVariant NodeAttributeModel::data(const QModelIndex& index, int role) const
         return QVariant();
     }
 
-    const NodeRow& row = m_rows[index.row()];
+    int row = index.row();
 
     if (role == Qt::DisplayRole || role == Qt::EditRole) {
         switch (index.column()) {
             case COL_NODE_NAME:
-                return row.nodeName;
+                return string(m_rows.nodeNames[row]);
             case COL_NODE_TYPE:
-                return row.nodeType;
+                return string(m_rows.nodeTypes[row]);
             case COL_VALUE:
-                return row.value;
+                if (m_rows.isDriven[row]) {
+                    return role == Qt::DisplayRole ? QVariant("(driven)") : QVariant();
+                }
+                return string(m_rows.values[row]);
+            case COL_FACES:
+            case COL_TRIANGLES:
+            case COL_VERTICES:
+            case COL_AREA:
+                return m_rows.hasMeshStats[row] ? meshStatDisplay(m_rows.meshStats[row], index.column()) : QVariant();
+            case COL_FLAGS:
+                return plugFlagsDisplay(m_rows.plugFlags[row]);
             default:
                 return QVariant();
         }
+    } else if (role == ExtraAttrProxyModel::SortKeyRole) {
+        // Scalar values sort by number; everything else falls back to the text
+        if (index.column() == COL_VALUE && m_rows.hasSortNumber[row]) {
+            return m_rows.sortNumbers[row];
+        }
+        if (isMeshStatColumn(index.column())) {
+            // Rows without statistics sort before every shading node
+            return m_rows.hasMeshStats[row] ? meshStatValue(m_rows.meshStats[row], index.column()) : -1.0;
+        }
+        if (index.column() == COL_FLAGS) {
+            return static_cast<int>(m_rows.plugFlags[row]);
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        if (isMeshStatColumn(index.column())) {
+            return Qt::AlignCenter;
+        }
+    } else if (role == Qt::ToolTipRole) {
+        if (index.column() == COL_VALUE && m_rows.isDriven[row]) {
+            return "Driven by a connection; not read to avoid evaluating upstream nodes";
+        }
     }
 
     return QVariant();
@@ -226,6 +580,16 @@ QVariant NodeAttributeModel::headerData(int section, Qt::Orientation orientation
                 return "Node Type";
             case COL_VALUE:
                 return "Value";
+            case COL_FACES:
+                return "Faces";
+            case COL_TRIANGLES:
+                return "Triangles";
+            case COL_VERTICES:
+                return "Vertices";
+            case COL_AREA:
+                return "Area";
+            case COL_FLAGS:
+                return "Flags";
             default:
                 return QVariant();
         }
@@ -240,8 +604,8 @@ Qt::ItemFlags NodeAttributeModel::flags(const QModelIndex& index) const
         return Qt::NoItemFlags;
     }
 
-    // Only Value column is editable
-    if (index.column() == COL_VALUE) {
+    // Only Value column is editable, and only where the value is not driven
+    if (index.column() == COL_VALUE && !m_rows.isDriven[index.row()]) {
         return QAbstractTableModel::flags(index) | Qt::ItemIsEditable;
     }
 
@@ -259,10 +623,21 @@ bool NodeAttributeModel::setData(const QModelIndex& index, const QVariant& value
     }
 
     // Update data
-    m_rows[index.row()].value = value.toString();
+    int row = index.row();
+    QByteArray text = value.toString().toUtf8();
+    m_rows.values[row] = m_strings.intern(text.constData(), static_cast<size_t>(text.size()));
+
+    // Keep the numeric sort key in step where the text is a plain number or bool
+    if (m_rows.hasSortNumber[row]) {
+        bool boolValue = false;
+        if (!ExtraAttrValueCodec::parseDouble(text.constData(), m_rows.sortNumbers[row]) &&
+            ExtraAttrValueCodec::parseBool(text.constData(), boolValue)) {
+            m_rows.sortNumbers[row] = boolValue ? 1.0 : 0.0;
+        }
+    }
 
     // Emit signal to trigger Maya API update
-    emit valueChanged(m_rows[index.row()].nodeName, m_currentAttrName, value.toString());
+    emit valueChanged(string(m_rows.nodeNames[row]), m_currentAttrName, value.toString());
     emit dataChanged(index, index);
 
     return true;
@@ -270,21 +645,61 @@ bool NodeAttributeModel::setData(const QModelIndex& index, const QVariant& value
 
 void NodeAttributeModel::setNodeValues(const QString& attrName, const std::vector<NodeAttributeValue>& nodeValues)
 {
-    beginResetModel();
+    // Another attribute shares nothing with the current rows, so it starts a fresh pool
+    bool sameAttribute = (attrName == m_currentAttrName);
+    ExtraAttrStringPool freshStrings;
+    ExtraAttrStringPool& strings = sameAttribute ? m_strings : freshStrings;
 
-    m_currentAttrName = attrName;
-    m_rows.clear();
+    NodeColumns newRows;
+    newRows.reserve(nodeValues.size());
+    strings.reserve(strings.size() + nodeValues.size());
 
     for (const auto& nodeValue : nodeValues) {
-        NodeRow row;
-        row.nodeName = QString::fromUtf8(nodeValue.nodeName.asChar());
-        row.nodeType = QString::fromUtf8(nodeValue.nodeType.asChar());
-        row.value = QString::fromUtf8(nodeValue.valueStr.asChar());
+        newRows.nodeNames.push_back(strings.intern(nodeValue.nodeName.asChar()));
+        newRows.nodeTypes.push_back(strings.intern(nodeValue.nodeType.asChar()));
+        newRows.values.push_back(strings.intern(nodeValue.valueStr.asChar()));
+        newRows.sortNumbers.push_back(nodeValue.sortNumber);
+        newRows.hasSortNumber.push_back(nodeValue.hasSortNumber ? 1 : 0);
+        newRows.typeFlags.push_back(static_cast<uint8_t>(nodeValue.typeFlags));
+        newRows.isDriven.push_back(nodeValue.isDriven ? 1 : 0);
+        newRows.plugFlags.push_back(static_cast<uint8_t>(nodeValue.plugFlags));
+        newRows.meshStats.push_back(nodeValue.meshStats);
+        newRows.hasMeshStats.push_back(nodeValue.hasMeshStats ? 1 : 0);
+    }
 
-        m_rows.append(row);
+    bool applied = false;
+    if (sameAttribute) {
+        RowNotifier notifier;
+        notifier.beginRemove = [this](int first, int last) { beginRemoveRows(QModelIndex(), first, last); };
+        notifier.endRemove = [this]() { endRemoveRows(); };
+        notifier.beginInsert = [this](int first, int last) { beginInsertRows(QModelIndex(), first, last); };
+        notifier.endInsert = [this]() { endInsertRows(); };
+        notifier.changed = [this](int first, int last) {
+            emit dataChanged(index(first, 0), index(last, COL_COUNT - 1));
+        };
+
+        applied = applyKeyedDiff(
+            m_rows, newRows, [](const NodeColumns& rows, int row) { return rows.nodeNames[row]; },
+            [](const NodeColumns& a, int rowA, const NodeColumns& b, int rowB) {
+                return a.nodeTypes[rowA] == b.nodeTypes[rowB] && a.values[rowA] == b.values[rowB] &&
+                       a.isDriven[rowA] == b.isDriven[rowB] && a.plugFlags[rowA] == b.plugFlags[rowB] &&
+                       a.hasMeshStats[rowA] == b.hasMeshStats[rowB] &&
+                       sameMeshStats(a.meshStats[rowA], b.meshStats[rowB]);
+            },
+            notifier);
     }
 
-    endResetModel();
+    if (!applied) {
+        beginResetModel();
+        m_currentAttrName = attrName;
+        if (!sameAttribute) {
+            m_strings = std::move(freshStrings);
+        }
+        m_rows = std::move(newRows);
+        endResetModel();
+    }
+
+    compactStrings();
 }
 
 void NodeAttributeModel::clear()
@@ -292,6 +707,7 @@ void NodeAttributeModel::clear()
     beginResetModel();
     m_currentAttrName.clear();
     m_rows.clear();
+    m_strings.clear();
     endResetModel();
 }
 
@@ -300,42 +716,58 @@ QString NodeAttributeModel::getNodeName(int row) const
     if (row < 0 || row >= m_rows.size()) {
         return QString();
     }
-    return m_rows[row].nodeName;
+    return string(m_rows.nodeNames[row]);
 }
 
-QString NodeAttributeModel::getCurrentAttributeName() const
+unsigned int NodeAttributeModel::getNodeTypeFlags(int row) const
 {
-    return m_currentAttrName;
+    if (row < 0 || row >= m_rows.size()) {
+        return 0;
+    }
+    return m_rows.typeFlags[row];
 }
 
-void NodeAttributeModel::sort(int column, Qt::SortOrder order)
+bool NodeAttributeModel::isDrivenRow(int row) const
 {
-    if (m_rows.isEmpty()) {
+    if (row < 0 || row >= m_rows.size()) {
+        return false;
+    }
+    return m_rows.isDriven[row] != 0;
+}
+
+void NodeAttributeModel::setEvaluatedValue(int row, const QString& value, double sortNumber, bool hasSortNumber)
+{
+    if (row < 0 || row >= m_rows.size()) {
         return;
     }
 
-    emit layoutAboutToBeChanged();
+    QByteArray text = value.toUtf8();
+    m_rows.values[row] = m_strings.intern(text.constData(), static_cast<size_t>(text.size()));
+    m_rows.sortNumbers[row] = sortNumber;
+    m_rows.hasSortNumber[row] = hasSortNumber ? 1 : 0;
+    m_rows.isDriven[row] = 0;
+
+    QModelIndex valueIndex = index(row, COL_VALUE);
+    emit dataChanged(valueIndex, valueIndex);
+}
 
-    std::sort(m_rows.begin(), m_rows.end(), [column, order](const NodeRow& a, const NodeRow& b) {
-        bool result = false;
+QString NodeAttributeModel::getCurrentAttributeName() const
+{
+    return m_currentAttrName;
+}
 
-        switch (column) {
-            case COL_NODE_NAME:
-                result = a.nodeName < b.nodeName;
-                break;
-            case COL_NODE_TYPE:
-                result = a.nodeType < b.nodeType;
-                break;
-            case COL_VALUE:
-                result = a.value < b.value;
-                break;
-            default:
-                result = a.nodeName < b.nodeName;
-                break;
-        }
+QString NodeAttributeModel::string(uint32_t id) const
+{
+    return QString::fromUtf8(m_strings.text(id), static_cast<qsizetype>(m_strings.length(id)));
+}
 
-        return (order == Qt::AscendingOrder) ? result : !result;
-    });
+void NodeAttributeModel::compactStrings()
+{
+    size_t referenced = m_rows.nodeNames.size() + m_rows.nodeTypes.size() + m_rows.values.size();
+    if (m_strings.size() < kCompactMinStrings || m_strings.size() <= referenced * kCompactFactor) {
+        return;
+    }
 
-    emit layoutChanged();
+    // Only IDs change, so views see the same data and need no signal
+    m_strings.compact({&m_rows.nodeNames, &m_rows.nodeTypes, &m_rows.values});
 }
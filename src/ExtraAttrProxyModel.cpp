@@ -0,0 +1,756 @@
+#include "ExtraAttrProxyModel.h"
+#include <QByteArray>
+#include <QMetaObject>
+#include <QVariant>
+#include <algorithm>
+
+namespace {
+
+// Above this share of the rows, rebuilding keys from the source beats per-row updates
+const int kBulkUpdateDivisor = 4;
+
+// Above this share of the rows, a full sort beats moving rows one by one
+const int kResortDivisor = 16;
+
+// From this many rows, search and sort changes run on a worker thread
+const int kWorkerRowThreshold = 20000;
+
+bool isNumber(const QVariant& value)
+{
+    switch (value.typeId()) {
+        case QMetaType::Bool:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::Long:
+        case QMetaType::ULong:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Float:
+        case QMetaType::Double:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+ExtraAttrProxyModel::ExtraAttrProxyModel(QObject* parent)
+    : QAbstractProxyModel(parent)
+    , m_filterColumn(0)
+    , m_sortColumn(-1)
+    , m_sortOrder(Qt::AscendingOrder)
+    , m_filterKeysValid(false)
+    , m_sortKeysValid(false)
+    , m_matchedValid(false)
+    , m_sortedValid(false)
+    , m_generation(0)
+    , m_refreshQueued(false)
+    , m_stopWorker(false)
+{
+}
+
+ExtraAttrProxyModel::~ExtraAttrProxyModel()
+{
+    stopWorker();
+}
+
+void ExtraAttrProxyModel::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    beginResetModel();
+
+    for (const QMetaObject::Connection& connection : m_sourceConnections) {
+        disconnect(connection);
+    }
+    m_sourceConnections.clear();
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+
+    if (sourceModel) {
+        m_sourceConnections = {
+            connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this,
+                    &ExtraAttrProxyModel::onSourceAboutToBeReset),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &ExtraAttrProxyModel::onSourceReset),
+            // A source-side sort gives no row mapping, so treat it like a reset
+            connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this,
+                    &ExtraAttrProxyModel::onSourceAboutToBeReset),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &ExtraAttrProxyModel::onSourceReset),
+            connect(sourceModel, &QAbstractItemModel::dataChanged, this, &ExtraAttrProxyModel::onSourceDataChanged),
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &ExtraAttrProxyModel::onSourceRowsInserted),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &ExtraAttrProxyModel::onSourceRowsRemoved),
+            connect(sourceModel, &QAbstractItemModel::headerDataChanged, this,
+                    &ExtraAttrProxyModel::onSourceHeaderDataChanged),
+        };
+    }
+
+    std::shared_ptr<Pass> pass = resetMapping();
+
+    endResetModel();
+
+    if (pass) {
+        startPass(pass);
+    }
+}
+
+QModelIndex ExtraAttrProxyModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (parent.isValid() || row < 0 || row >= rowCount() || column < 0 || column >= columnCount()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex ExtraAttrProxyModel::parent(const QModelIndex& child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int ExtraAttrProxyModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(m_proxyToSource.size());
+}
+
+int ExtraAttrProxyModel::columnCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !sourceModel()) {
+        return 0;
+    }
+    return sourceModel()->columnCount();
+}
+
+QModelIndex ExtraAttrProxyModel::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel() || proxyIndex.row() >= static_cast<int>(m_proxyToSource.size())) {
+        return QModelIndex();
+    }
+    return sourceModel()->index(m_proxyToSource[proxyIndex.row()], proxyIndex.column());
+}
+
+QModelIndex ExtraAttrProxyModel::mapFromSource(const QModelIndex& sourceIndex) const
+{
+    if (!sourceIndex.isValid() || sourceIndex.row() >= static_cast<int>(m_sourceToProxy.size())) {
+        return QModelIndex();
+    }
+
+    int proxyRow = m_sourceToProxy[sourceIndex.row()];
+    if (proxyRow < 0) {
+        return QModelIndex();
+    }
+    return createIndex(proxyRow, sourceIndex.column());
+}
+
+void ExtraAttrProxyModel::sort(int column, Qt::SortOrder order)
+{
+    if (column == m_sortColumn && order == m_sortOrder) {
+        return;
+    }
+
+    if (column != m_sortColumn) {
+        m_sortKeysValid = false;
+    }
+    m_sortColumn = column;
+    m_sortOrder = order;
+    m_sortedValid = false;
+
+    refresh();
+}
+
+void ExtraAttrProxyModel::setFilterKeyColumn(int column)
+{
+    if (column == m_filterColumn) {
+        return;
+    }
+
+    m_filterColumn = column;
+    m_filterKeysValid = false;
+    m_matchedValid = false;
+
+    if (!m_foldedSearchText.empty()) {
+        refresh();
+    }
+}
+
+int ExtraAttrProxyModel::filterKeyColumn() const
+{
+    return m_filterColumn;
+}
+
+void ExtraAttrProxyModel::setSearchText(const QString& text)
+{
+    std::string folded = text.toCaseFolded().toUtf8().toStdString();
+    if (folded == m_foldedSearchText) {
+        return;
+    }
+
+    m_foldedSearchText = folded;
+    refresh();
+}
+
+void ExtraAttrProxyModel::onSourceAboutToBeReset()
+{
+    beginResetModel();
+}
+
+void ExtraAttrProxyModel::onSourceReset()
+{
+    std::shared_ptr<Pass> pass = resetMapping();
+
+    endResetModel();
+
+    if (pass) {
+        startPass(pass);
+    }
+}
+
+void ExtraAttrProxyModel::onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid() || topLeft.parent().isValid()) {
+        return;
+    }
+
+    int first = topLeft.row();
+    int last = bottomRight.row();
+    int rowCount = sourceModel()->rowCount();
+    bool bulk = (last - first + 1) > rowCount / kBulkUpdateDivisor;
+
+    // Edits outside the key columns cannot change the mapping
+    bool filterChanged = m_filterColumn >= topLeft.column() && m_filterColumn <= bottomRight.column();
+    bool sortChanged = m_sortColumn >= topLeft.column() && m_sortColumn <= bottomRight.column();
+
+    if (filterChanged) {
+        if (m_filterKeysValid) {
+            if (bulk) {
+                m_filterKeysValid = false;
+            } else {
+                ExtraAttrKeyColumn& keys = writableKeys(m_filterKeys);
+                for (int row = first; row <= last; ++row) {
+                    updateKey(keys, row, m_filterColumn, true);
+                }
+            }
+        }
+        m_matchedValid = false;
+    }
+
+    if (sortChanged && m_sortKeysValid) {
+        if (bulk) {
+            m_sortKeysValid = false;
+            m_sortedValid = false;
+        } else {
+            ExtraAttrKeyColumn& keys = writableKeys(m_sortKeys);
+            std::vector<uint32_t> changedRows;
+            for (int row = first; row <= last; ++row) {
+                updateKey(keys, row, m_sortColumn, false);
+                changedRows.push_back(static_cast<uint32_t>(row));
+            }
+            resortRows(changedRows);
+        }
+    }
+
+    if ((filterChanged && !m_foldedSearchText.empty()) || sortChanged) {
+        scheduleRefresh();
+    }
+
+    // Repaint the changed cells wherever they are shown now
+    int proxyFirst = -1;
+    int proxyLast = -1;
+    for (int row = first; row <= last && row < static_cast<int>(m_sourceToProxy.size()); ++row) {
+        int proxyRow = m_sourceToProxy[row];
+        if (proxyRow >= 0) {
+            proxyFirst = (proxyFirst < 0) ? proxyRow : std::min(proxyFirst, proxyRow);
+            proxyLast = std::max(proxyLast, proxyRow);
+        }
+    }
+    if (proxyFirst >= 0) {
+        emit dataChanged(index(proxyFirst, topLeft.column()), index(proxyLast, bottomRight.column()));
+    }
+}
+
+void ExtraAttrProxyModel::onSourceRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    int count = last - first + 1;
+    int rowCount = sourceModel()->rowCount();
+    bool append = (first == rowCount - count);
+
+    // Appended rows extend the keys; inserting in the middle renumbers everything
+    if (m_filterKeysValid) {
+        if (append && static_cast<int>(m_filterKeys->size()) == first) {
+            ExtraAttrKeyColumn& keys = writableKeys(m_filterKeys);
+            for (int row = first; row <= last; ++row) {
+                appendKey(keys, row, m_filterColumn, true);
+            }
+        } else {
+            m_filterKeysValid = false;
+        }
+    }
+    m_matchedValid = false;
+
+    if (m_sortKeysValid) {
+        if (append && static_cast<int>(m_sortKeys->size()) == first) {
+            ExtraAttrKeyColumn& keys = writableKeys(m_sortKeys);
+            std::vector<uint32_t> newRows;
+            for (int row = first; row <= last; ++row) {
+                appendKey(keys, row, m_sortColumn, false);
+                newRows.push_back(static_cast<uint32_t>(row));
+            }
+            resortRows(newRows);
+        } else {
+            m_sortKeysValid = false;
+            m_sortedValid = false;
+        }
+    }
+
+    refresh([first, count](int row) { return (row >= first) ? row + count : row; });
+}
+
+void ExtraAttrProxyModel::onSourceRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    uint32_t count = static_cast<uint32_t>(last - first + 1);
+
+    if (m_filterKeysValid) {
+        writableKeys(m_filterKeys).removeRows(static_cast<uint32_t>(first), count);
+    }
+    m_matchedValid = false;
+
+    if (m_sortKeysValid) {
+        writableKeys(m_sortKeys).removeRows(static_cast<uint32_t>(first), count);
+    }
+
+    if (m_sortedValid) {
+        // Drop the removed rows and renumber the rows after them
+        auto removed = [first, last](uint32_t row) {
+            return static_cast<int>(row) >= first && static_cast<int>(row) <= last;
+        };
+        m_sortedRows.erase(std::remove_if(m_sortedRows.begin(), m_sortedRows.end(), removed), m_sortedRows.end());
+        for (uint32_t& row : m_sortedRows) {
+            if (static_cast<int>(row) > last) {
+                row -= count;
+            }
+        }
+    }
+
+    refresh([first, last, count](int row) {
+        if (row < first) {
+            return row;
+        }
+        return (row > last) ? row - static_cast<int>(count) : -1;
+    });
+}
+
+void ExtraAttrProxyModel::onSourceHeaderDataChanged(Qt::Orientation orientation, int first, int last)
+{
+    // Vertical header sections follow proxy rows, which the source does not know
+    if (orientation == Qt::Horizontal) {
+        emit headerDataChanged(orientation, first, last);
+    }
+}
+
+QVariant ExtraAttrProxyModel::keyValue(int row, int column, bool foldCase) const
+{
+    QModelIndex index = sourceModel()->index(row, column);
+    if (!foldCase) {
+        QVariant sortKey = sourceModel()->data(index, SortKeyRole);
+        if (sortKey.isValid()) {
+            return sortKey;
+        }
+    }
+    return sourceModel()->data(index, Qt::DisplayRole);
+}
+
+void ExtraAttrProxyModel::appendKey(ExtraAttrKeyColumn& keys, int row, int column, bool foldCase) const
+{
+    QVariant value = keyValue(row, column, foldCase);
+
+    if (!foldCase && isNumber(value)) {
+        keys.appendNumber(value.toDouble());
+        return;
+    }
+
+    QByteArray bytes = (foldCase ? value.toString().toCaseFolded() : value.toString()).toUtf8();
+    keys.appendText(bytes.constData(), static_cast<size_t>(bytes.size()));
+}
+
+void ExtraAttrProxyModel::updateKey(ExtraAttrKeyColumn& keys, int row, int column, bool foldCase) const
+{
+    QVariant value = keyValue(row, column, foldCase);
+
+    if (!foldCase && isNumber(value)) {
+        keys.setNumber(static_cast<uint32_t>(row), value.toDouble());
+        return;
+    }
+
+    QByteArray bytes = (foldCase ? value.toString().toCaseFolded() : value.toString()).toUtf8();
+    keys.setText(static_cast<uint32_t>(row), bytes.constData(), static_cast<size_t>(bytes.size()));
+}
+
+std::shared_ptr<ExtraAttrKeyColumn> ExtraAttrProxyModel::buildKeys(int column, bool foldCase) const
+{
+    // A fresh column, so passes still reading the old one are unaffected
+    std::shared_ptr<ExtraAttrKeyColumn> keys = std::make_shared<ExtraAttrKeyColumn>();
+    keys->setNaturalOrder(!foldCase);
+    if (!sourceModel()) {
+        return keys;
+    }
+
+    int rowCount = sourceModel()->rowCount();
+    keys->reserve(static_cast<size_t>(rowCount));
+    for (int row = 0; row < rowCount; ++row) {
+        appendKey(*keys, row, column, foldCase);
+    }
+    return keys;
+}
+
+void ExtraAttrProxyModel::ensureKeys()
+{
+    // Source data can only be read on this thread, so keys are built before a pass starts
+    if (!m_foldedSearchText.empty() && !m_filterKeysValid) {
+        m_filterKeys = buildKeys(m_filterColumn, true);
+        m_filterKeysValid = true;
+        m_matchedValid = false;
+    }
+
+    if (m_sortColumn >= 0 && !m_sortKeysValid) {
+        m_sortKeys = buildKeys(m_sortColumn, false);
+        m_sortKeysValid = true;
+        m_sortedValid = false;
+    }
+}
+
+ExtraAttrKeyColumn& ExtraAttrProxyModel::writableKeys(std::shared_ptr<ExtraAttrKeyColumn>& keys)
+{
+    if (keys.use_count() > 1) {
+        keys = std::make_shared<ExtraAttrKeyColumn>(*keys);
+    }
+    return *keys;
+}
+
+void ExtraAttrProxyModel::resortRows(const std::vector<uint32_t>& rows)
+{
+    if (!m_sortedValid) {
+        return;
+    }
+
+    if (rows.size() > m_sortKeys->size() / kResortDivisor) {
+        m_sortedValid = false;
+        return;
+    }
+
+    // Take the rows out, then insert each one at its sorted position
+    std::vector<char> moving(m_sortKeys->size(), 0);
+    for (uint32_t row : rows) {
+        moving[row] = 1;
+    }
+    m_sortedRows.erase(std::remove_if(m_sortedRows.begin(), m_sortedRows.end(),
+                                      [&moving](uint32_t row) { return moving[row] != 0; }),
+                       m_sortedRows.end());
+
+    const ExtraAttrKeyColumn& keys = *m_sortKeys;
+    bool descending = (m_sortOrder == Qt::DescendingOrder);
+    for (uint32_t row : rows) {
+        auto position = std::upper_bound(m_sortedRows.begin(), m_sortedRows.end(), row,
+                                         [&keys, descending](uint32_t a, uint32_t b) {
+                                             return descending ? keys.compare(b, a) < 0 : keys.compare(a, b) < 0;
+                                         });
+        m_sortedRows.insert(position, row);
+    }
+}
+
+std::shared_ptr<ExtraAttrProxyModel::Pass> ExtraAttrProxyModel::createPass()
+{
+    ensureKeys();
+
+    if (m_activePass) {
+        m_activePass->cancelled = true;
+    }
+
+    std::shared_ptr<Pass> pass = std::make_shared<Pass>();
+    pass->generation = ++m_generation;
+    pass->cancelled = false;
+    pass->rowCount = sourceModel() ? sourceModel()->rowCount() : 0;
+    pass->matchedValid = false;
+    pass->descending = (m_sortOrder == Qt::DescendingOrder);
+    pass->sortedValid = false;
+
+    if (!m_foldedSearchText.empty()) {
+        pass->filterKeys = m_filterKeys;
+        pass->searchText = m_foldedSearchText;
+        if (m_matchedValid) {
+            pass->matchedRows = m_matchedRows;
+            pass->matchedText = m_matchedText;
+            pass->matchedValid = true;
+        }
+    }
+
+    if (m_sortColumn >= 0) {
+        pass->sortKeys = m_sortKeys;
+        if (m_sortedValid) {
+            pass->sortedRows = m_sortedRows;
+            pass->sortedValid = true;
+        }
+    }
+
+    m_activePass = pass;
+    return pass;
+}
+
+void ExtraAttrProxyModel::runPass(Pass& pass)
+{
+    if (pass.filterKeys && !(pass.matchedValid && pass.matchedText == pass.searchText)) {
+        // Rows containing the new text also contain any part of it, so narrow the last result
+        std::vector<uint32_t> matches;
+        if (pass.matchedValid && pass.searchText.find(pass.matchedText) != std::string::npos) {
+            pass.filterKeys->narrowSubstring(pass.searchText, pass.matchedRows, matches);
+        } else {
+            pass.filterKeys->findSubstring(pass.searchText, matches);
+        }
+
+        pass.matchedRows.swap(matches);
+        pass.matchedText = pass.searchText;
+        pass.matchedValid = true;
+    }
+
+    if (pass.cancelled) {
+        return;
+    }
+
+    if (pass.sortKeys && !pass.sortedValid) {
+        pass.sortedRows.resize(pass.sortKeys->size());
+        for (uint32_t row = 0; row < pass.sortedRows.size(); ++row) {
+            pass.sortedRows[row] = row;
+        }
+        pass.sortKeys->sortRows(pass.sortedRows, pass.descending);
+        pass.sortedValid = true;
+    }
+
+    if (pass.cancelled) {
+        return;
+    }
+
+    // Combine matches and sort order into the proxy-to-source mapping
+    std::vector<int>& mapping = pass.proxyToSource;
+    mapping.clear();
+
+    bool filtered = static_cast<bool>(pass.filterKeys);
+    if (pass.sortKeys) {
+        std::vector<char> accepted;
+        if (filtered) {
+            accepted.assign(static_cast<size_t>(pass.rowCount), 0);
+            for (uint32_t row : pass.matchedRows) {
+                accepted[row] = 1;
+            }
+        }
+
+        mapping.reserve(filtered ? pass.matchedRows.size() : pass.sortedRows.size());
+        for (uint32_t row : pass.sortedRows) {
+            if (!filtered || accepted[row]) {
+                mapping.push_back(static_cast<int>(row));
+            }
+        }
+    } else if (filtered) {
+        mapping.assign(pass.matchedRows.begin(), pass.matchedRows.end());
+    } else {
+        mapping.resize(static_cast<size_t>(pass.rowCount));
+        for (int row = 0; row < pass.rowCount; ++row) {
+            mapping[row] = row;
+        }
+    }
+}
+
+void ExtraAttrProxyModel::startPass(const std::shared_ptr<Pass>& pass)
+{
+    std::lock_guard<std::mutex> lock(m_workerMutex);
+    if (!m_worker.joinable()) {
+        m_worker = std::thread([this]() { workerLoop(); });
+    }
+    m_queuedPass = pass;
+    m_workerWake.notify_one();
+}
+
+void ExtraAttrProxyModel::workerLoop()
+{
+    for (;;) {
+        std::shared_ptr<Pass> pass;
+        {
+            std::unique_lock<std::mutex> lock(m_workerMutex);
+            m_workerWake.wait(lock, [this]() { return m_stopWorker || m_queuedPass; });
+            if (m_stopWorker) {
+                return;
+            }
+            pass.swap(m_queuedPass);
+        }
+
+        if (pass->cancelled) {
+            continue;
+        }
+
+        runPass(*pass);
+        if (!pass->cancelled) {
+            // Queued to the proxy's thread; dropped if the proxy is destroyed first
+            QMetaObject::invokeMethod(this, [this, pass]() { onPassFinished(pass); }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void ExtraAttrProxyModel::stopWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_workerMutex);
+        m_stopWorker = true;
+        m_queuedPass.reset();
+        if (m_activePass) {
+            m_activePass->cancelled = true;
+        }
+        m_workerWake.notify_one();
+    }
+
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+void ExtraAttrProxyModel::onPassFinished(const std::shared_ptr<Pass>& pass)
+{
+    if (pass->generation != m_generation) {
+        return;
+    }
+
+    adoptPassResults(*pass);
+    applyMapping(pass->proxyToSource, nullptr);
+    m_activePass.reset();
+}
+
+void ExtraAttrProxyModel::adoptPassResults(Pass& pass)
+{
+    if (pass.filterKeys) {
+        m_matchedRows.swap(pass.matchedRows);
+        m_matchedText = pass.matchedText;
+        m_matchedValid = pass.matchedValid;
+    }
+
+    if (pass.sortKeys) {
+        m_sortedRows.swap(pass.sortedRows);
+        m_sortedValid = pass.sortedValid;
+    }
+}
+
+std::shared_ptr<ExtraAttrProxyModel::Pass> ExtraAttrProxyModel::resetMapping()
+{
+    m_filterKeysValid = false;
+    m_sortKeysValid = false;
+    m_matchedValid = false;
+    m_sortedValid = false;
+
+    std::shared_ptr<Pass> pass = createPass();
+
+    if (pass->rowCount >= kWorkerRowThreshold && (pass->filterKeys || pass->sortKeys)) {
+        // Show the rows in source order now; the pass filters and sorts them shortly after
+        m_proxyToSource.resize(static_cast<size_t>(pass->rowCount));
+        for (int row = 0; row < pass->rowCount; ++row) {
+            m_proxyToSource[row] = row;
+        }
+        rebuildSourceToProxy();
+        return pass;
+    }
+
+    runPass(*pass);
+    adoptPassResults(*pass);
+    m_proxyToSource.swap(pass->proxyToSource);
+    rebuildSourceToProxy();
+    m_activePass.reset();
+    return nullptr;
+}
+
+void ExtraAttrProxyModel::rebuildSourceToProxy()
+{
+    int rowCount = sourceModel() ? sourceModel()->rowCount() : 0;
+    m_sourceToProxy.assign(static_cast<size_t>(rowCount), -1);
+    for (size_t proxyRow = 0; proxyRow < m_proxyToSource.size(); ++proxyRow) {
+        m_sourceToProxy[m_proxyToSource[proxyRow]] = static_cast<int>(proxyRow);
+    }
+}
+
+bool ExtraAttrProxyModel::applyMapping(std::vector<int>& proxyToSource, const std::function<int(int)>& remapSourceRow)
+{
+    if (!remapSourceRow && proxyToSource == m_proxyToSource) {
+        return false;
+    }
+
+    emit layoutAboutToBeChanged();
+
+    // Remember which source row each persistent index (selection, current item) points at
+    const QModelIndexList from = persistentIndexList();
+    std::vector<int> sourceRows(static_cast<size_t>(from.size()), -1);
+    for (int i = 0; i < from.size(); ++i) {
+        int proxyRow = from[i].row();
+        if (proxyRow >= 0 && proxyRow < static_cast<int>(m_proxyToSource.size())) {
+            int sourceRow = m_proxyToSource[proxyRow];
+            sourceRows[i] = remapSourceRow ? remapSourceRow(sourceRow) : sourceRow;
+        }
+    }
+
+    m_proxyToSource.swap(proxyToSource);
+    rebuildSourceToProxy();
+
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (int i = 0; i < from.size(); ++i) {
+        int sourceRow = sourceRows[i];
+        int proxyRow = (sourceRow >= 0 && sourceRow < static_cast<int>(m_sourceToProxy.size()))
+                           ? m_sourceToProxy[sourceRow]
+                           : -1;
+        to.append(proxyRow >= 0 ? createIndex(proxyRow, from[i].column()) : QModelIndex());
+    }
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged();
+    return true;
+}
+
+void ExtraAttrProxyModel::refresh(const std::function<int(int)>& remapSourceRow)
+{
+    m_refreshQueued = false;
+
+    std::shared_ptr<Pass> pass = createPass();
+
+    // Row changes must be mapped before returning; small tables are fast enough anyway
+    if (remapSourceRow || pass->rowCount < kWorkerRowThreshold) {
+        runPass(*pass);
+        adoptPassResults(*pass);
+        applyMapping(pass->proxyToSource, remapSourceRow);
+        m_activePass.reset();
+        return;
+    }
+
+    startPass(pass);
+}
+
+void ExtraAttrProxyModel::scheduleRefresh()
+{
+    if (m_refreshQueued) {
+        return;
+    }
+
+    m_refreshQueued = true;
+    QMetaObject::invokeMethod(
+        this,
+        [this]() {
+            // Cleared if a direct refresh ran in the meantime
+            if (m_refreshQueued) {
+                refresh();
+            }
+        },
+        Qt::QueuedConnection);
+}
@@ -0,0 +1,245 @@
+#include "ExtraAttrScanJob.h"
+#include "ExtraAttrUI.h"
+#include "MayaUtils.h"
+#include <maya/MEventMessage.h>
+#include <maya/MGlobal.h>
+#include <maya/MSceneMessage.h>
+#include <chrono>
+
+namespace {
+
+// Number of nodes visited between time budget checks
+const unsigned int kNodesPerStep = 512;
+
+// Time spent scanning per idle event, small enough to keep the UI responsive
+const std::chrono::milliseconds kIdleTimeBudget(10);
+
+} // namespace
+
+ExtraAttrScanJobManager::ExtraAttrScanJobManager()
+    : m_nextJobId(1)
+    , m_idleCallbackId(0)
+    , m_hasIdleCallback(false)
+{
+}
+
+ExtraAttrScanJobManager::~ExtraAttrScanJobManager()
+{
+}
+
+ExtraAttrScanJobManager& ExtraAttrScanJobManager::instance()
+{
+    static ExtraAttrScanJobManager s_instance;
+    return s_instance;
+}
+
+int ExtraAttrScanJobManager::startScan()
+{
+    int jobId = m_nextJobId++;
+    ScanJob& job = m_jobs[jobId];
+    job.scanner.reset(new ExtraAttrScanner());
+    job.scanner->setValueIndexEnabled(ExtraAttrScanner::sharedIndex().isValueIndexEnabled());
+
+    updateIdleCallback();
+    return jobId;
+}
+
+bool ExtraAttrScanJobManager::getStatus(int jobId, ScanJobState& state, size_t& processed, size_t& total) const
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) {
+        return false;
+    }
+
+    state = it->second.state;
+    processed = it->second.processed;
+    total = it->second.total;
+    return true;
+}
+
+bool ExtraAttrScanJobManager::wait(int jobId)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) {
+        return false;
+    }
+
+    // Finish earlier jobs first so results are published in start order
+    for (auto jobIt = nextActiveJob(); jobIt != m_jobs.end() && jobIt->first <= jobId; jobIt = nextActiveJob()) {
+        while (!stepJob(jobIt->first, jobIt->second)) {
+        }
+    }
+
+    updateIdleCallback();
+    return it->second.state == ScanJobState::kDone;
+}
+
+bool ExtraAttrScanJobManager::cancel(int jobId)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) {
+        return false;
+    }
+
+    ScanJob& job = it->second;
+    if (job.state != ScanJobState::kPending && job.state != ScanJobState::kRunning) {
+        return false;
+    }
+
+    job.state = ScanJobState::kCancelled;
+    job.scanner.reset();
+
+    updateIdleCallback();
+    return true;
+}
+
+void ExtraAttrScanJobManager::installSceneCallbacks()
+{
+    if (m_sceneCallbackIds.length() > 0) {
+        return;
+    }
+
+    const MSceneMessage::Message messages[] = {
+        MSceneMessage::kBeforeNew, MSceneMessage::kBeforeOpen, MSceneMessage::kBeforeImport};
+
+    MStatus status;
+    for (MSceneMessage::Message message : messages) {
+        MCallbackId callbackId = MSceneMessage::addCallback(message, sceneChangingCallback, this, &status);
+        if (status == MS::kSuccess) {
+            m_sceneCallbackIds.append(callbackId);
+        }
+    }
+}
+
+void ExtraAttrScanJobManager::shutdown()
+{
+    cancelAll();
+
+    if (m_sceneCallbackIds.length() > 0) {
+        MMessage::removeCallbacks(m_sceneCallbackIds);
+        m_sceneCallbackIds.clear();
+    }
+}
+
+void ExtraAttrScanJobManager::cancelAll()
+{
+    for (auto& pair : m_jobs) {
+        if (pair.second.state == ScanJobState::kPending || pair.second.state == ScanJobState::kRunning) {
+            pair.second.state = ScanJobState::kCancelled;
+        }
+        pair.second.scanner.reset();
+    }
+
+    updateIdleCallback();
+}
+
+MString ExtraAttrScanJobManager::stateName(ScanJobState state)
+{
+    switch (state) {
+        case ScanJobState::kPending: return "pending";
+        case ScanJobState::kRunning: return "running";
+        case ScanJobState::kDone: return "done";
+        case ScanJobState::kCancelled: return "cancelled";
+        case ScanJobState::kFailed: return "failed";
+        default: return "unknown";
+    }
+}
+
+void ExtraAttrScanJobManager::idleCallback(void* clientData)
+{
+    static_cast<ExtraAttrScanJobManager*>(clientData)->processIdle();
+}
+
+void ExtraAttrScanJobManager::sceneChangingCallback(void* clientData)
+{
+    // Unfinished jobs hold nodes of the old scene; the index is rebuilt on next use
+    static_cast<ExtraAttrScanJobManager*>(clientData)->cancelAll();
+    ExtraAttrScanner::sharedIndex().clearCache();
+    MayaUtils::clearEnumFieldTables();
+    ExtraAttrUI::notifyIndexChanged();
+}
+
+void ExtraAttrScanJobManager::processIdle()
+{
+    auto deadline = std::chrono::steady_clock::now() + kIdleTimeBudget;
+
+    auto it = nextActiveJob();
+    while (it != m_jobs.end() && std::chrono::steady_clock::now() < deadline) {
+        if (stepJob(it->first, it->second)) {
+            it = nextActiveJob();
+        }
+    }
+
+    updateIdleCallback();
+}
+
+bool ExtraAttrScanJobManager::stepJob(int jobId, ScanJob& job)
+{
+    if (job.state == ScanJobState::kPending) {
+        // Collect nodes when the job actually starts, not when it is queued
+        if (!job.scanner->beginIncrementalScan()) {
+            job.state = ScanJobState::kFailed;
+            job.scanner.reset();
+            return true;
+        }
+        job.state = ScanJobState::kRunning;
+    }
+
+    if (job.state != ScanJobState::kRunning) {
+        return true;
+    }
+
+    bool finished = job.scanner->scanStep(kNodesPerStep);
+    job.scanner->getScanProgress(job.processed, job.total);
+
+    if (!finished) {
+        return false;
+    }
+
+    int totalAttrs, totalNodes;
+    job.scanner->getStatistics(totalAttrs, totalNodes);
+    job.processed = job.total = static_cast<size_t>(totalNodes);
+
+    publish(job);
+
+    MGlobal::displayInfo(MString("Scan job ") + jobId + " complete. Found " +
+                         totalAttrs + " extra attributes in " + totalNodes + " nodes.");
+    return true;
+}
+
+void ExtraAttrScanJobManager::publish(ScanJob& job)
+{
+    ExtraAttrScanner::sharedIndex().swap(*job.scanner);
+    job.scanner.reset();
+    job.state = ScanJobState::kDone;
+
+    ExtraAttrUI::notifyIndexChanged();
+}
+
+void ExtraAttrScanJobManager::updateIdleCallback()
+{
+    bool hasWork = nextActiveJob() != m_jobs.end();
+
+    if (hasWork && !m_hasIdleCallback) {
+        MStatus status;
+        m_idleCallbackId = MEventMessage::addEventCallback("idle", idleCallback, this, &status);
+        m_hasIdleCallback = (status == MS::kSuccess);
+        if (!m_hasIdleCallback) {
+            MGlobal::displayError("Failed to register idle callback for scan jobs");
+        }
+    } else if (!hasWork && m_hasIdleCallback) {
+        // Idle events fire continuously while a callback is registered
+        MMessage::removeCallback(m_idleCallbackId);
+        m_hasIdleCallback = false;
+    }
+}
+
+std::map<int, ExtraAttrScanJobManager::ScanJob>::iterator ExtraAttrScanJobManager::nextActiveJob()
+{
+    for (auto it = m_jobs.begin(); it != m_jobs.end(); ++it) {
+        if (it->second.state == ScanJobState::kPending || it->second.state == ScanJobState::kRunning) {
+            return it;
+        }
+    }
+    return m_jobs.end();
+}
@@ -1,4 +1,6 @@
 #include "ExtraAttrScanner.h"
+#include "ExtraAttrShadingIndex.h"
+#include "MayaUtils.h"
 #include <maya/MItDependencyNodes.h>
 #include <maya/MFnDependencyNode.h>
 #include <maya/MFnNumericAttribute.h>
@@ -8,10 +10,20 @@
 #include <maya/MFnCompoundAttribute.h>
 #include <maya/MFnUnitAttribute.h>
 #include <maya/MPlug.h>
+#include <maya/MAngle.h>
+#include <maya/MDistance.h>
+#include <maya/MTime.h>
 #include <maya/MGlobal.h>
+#include <algorithm>
+#include <unordered_map>
 
-ExtraAttrScanner::ExtraAttrScanner()
+ExtraAttrScanner::ExtraAttrScanner(bool watchValueChanges)
     : m_totalNodesScanned(0)
+    , m_hasScanResults(false)
+    , m_nextPendingNode(0)
+    , m_valueIndexEnabled(false)
+    , m_watchValueChanges(watchValueChanges)
+    , m_searchIndexValid(false)
 {
 }
 
@@ -20,10 +32,37 @@ ExtraAttrScanner::~ExtraAttrScanner()
     clearCache();
 }
 
+ExtraAttrScanner& ExtraAttrScanner::sharedIndex()
+{
+    static ExtraAttrScanner s_sharedIndex(true);
+    return s_sharedIndex;
+}
+
 bool ExtraAttrScanner::scanScene()
+{
+    if (!beginIncrementalScan()) {
+        return false;
+    }
+
+    // Visit every collected node in a single step
+    scanStep(static_cast<unsigned int>(m_pendingNodes.size()));
+
+    MGlobal::displayInfo(MString("Scan complete. Found ") +
+                         m_attributeInfoMap.size() +
+                         " extra attributes in " +
+                         m_totalNodesScanned + " nodes.");
+
+    return true;
+}
+
+bool ExtraAttrScanner::beginIncrementalScan()
 {
     clearCache();
 
+    // A full scan re-reads enum definitions and type classifications, picking up edits and plug-in reloads
+    MayaUtils::clearEnumFieldTables();
+    MayaUtils::clearNodeTypeFlags();
+
     MStatus status;
     MItDependencyNodes nodeIt(MFn::kInvalid, &status);
     if (status != MS::kSuccess) {
@@ -31,25 +70,74 @@ bool ExtraAttrScanner::scanScene()
         return false;
     }
 
-    // Iterate through all nodes
+    // Collect handles first so the scene can change between steps
     for (; !nodeIt.isDone(); nodeIt.next()) {
         MObject node = nodeIt.thisNode(&status);
         if (status != MS::kSuccess) {
             continue;
         }
 
-        scanNode(node);
+        m_pendingNodes.push_back(MObjectHandle(node));
+    }
+
+    return true;
+}
+
+bool ExtraAttrScanner::scanStep(unsigned int maxNodes)
+{
+    size_t end = std::min(m_pendingNodes.size(), m_nextPendingNode + maxNodes);
+
+    for (; m_nextPendingNode < end; ++m_nextPendingNode) {
+        const MObjectHandle& handle = m_pendingNodes[m_nextPendingNode];
+
+        // Skip nodes deleted since the scan started
+        if (!handle.isValid()) {
+            continue;
+        }
+
+        scanNode(handle.object());
         m_totalNodesScanned++;
     }
 
-    MGlobal::displayInfo(MString("Scan complete. Found ") +
-                         m_attributeInfoMap.size() +
-                         " extra attributes in " +
-                         m_totalNodesScanned + " nodes.");
+    if (m_nextPendingNode < m_pendingNodes.size()) {
+        return false;
+    }
+
+    m_pendingNodes.clear();
+    m_pendingNodes.shrink_to_fit();
+    m_nextPendingNode = 0;
+    m_searchIndexValid = false;
+    m_hasScanResults = true;
 
+    installValueCallbacks();
     return true;
 }
 
+void ExtraAttrScanner::getScanProgress(size_t& processed, size_t& total) const
+{
+    processed = m_nextPendingNode;
+    total = m_pendingNodes.size();
+}
+
+void ExtraAttrScanner::swap(ExtraAttrScanner& other)
+{
+    m_attributeInfoMap.swap(other.m_attributeInfoMap);
+    m_attrToNodesMap.swap(other.m_attrToNodesMap);
+    m_attrToFlagsMap.swap(other.m_attrToFlagsMap);
+    std::swap(m_totalNodesScanned, other.m_totalNodesScanned);
+    std::swap(m_hasScanResults, other.m_hasScanResults);
+    m_pendingNodes.swap(other.m_pendingNodes);
+    std::swap(m_nextPendingNode, other.m_nextPendingNode);
+    m_valueIndexMap.swap(other.m_valueIndexMap);
+    m_nodeTable.swap(other.m_nodeTable);
+    m_searchIndexValid = false;
+    other.m_searchIndexValid = false;
+
+    // Callbacks point at their owning scanner, so each side re-registers for its new data
+    installValueCallbacks();
+    other.installValueCallbacks();
+}
+
 void ExtraAttrScanner::scanNode(const MObject& depNode)
 {
     if (depNode.isNull()) {
@@ -68,6 +156,9 @@ void ExtraAttrScanner::scanNode(const MObject& depNode)
         return;
     }
 
+    // Assigned when the node first gets an entry in the value index
+    uint32_t nodeId = UINT32_MAX;
+
     for (unsigned int i = 0; i < attrCount; ++i) {
         MObject attr = fnDep.attribute(i, &status);
         if (status != MS::kSuccess || attr.isNull()) {
@@ -101,13 +192,36 @@ void ExtraAttrScanner::scanNode(const MObject& depNode)
             attrInfo->isArray = fnAttr.isArray(&status);
             attrInfo->usageCount = 1;
 
-            m_attributeInfoMap[attrName] = attrInfo;
-            m_attrToNodesMap[attrName] = std::vector<MObject>();
-            m_attrToNodesMap[attrName].push_back(depNode);
+            it = m_attributeInfoMap.emplace(attrName, attrInfo).first;
+            m_attrToNodesMap[attrName] = std::vector<MObjectHandle>();
+            m_attrToNodesMap[attrName].push_back(MObjectHandle(depNode));
         } else {
             // Increase usage count for existing Extra Attribute
             it->second->usageCount++;
-            m_attrToNodesMap[attrName].push_back(depNode);
+            m_attrToNodesMap[attrName].push_back(MObjectHandle(depNode));
+        }
+
+        // Record the plug state alongside the node, from plug queries that read no value
+        MPlug plug = fnDep.findPlug(attr, &status);
+        unsigned int plugFlags = (status == MS::kSuccess) ? MayaUtils::getPlugFlags(plug) : 0;
+        m_attrToFlagsMap[attrName].push_back(static_cast<uint8_t>(plugFlags));
+
+        // Add the value to the inverted index
+        if (m_valueIndexEnabled && isValueIndexedType(it->second->typeName)) {
+            if (nodeId == UINT32_MAX) {
+                nodeId = static_cast<uint32_t>(m_nodeTable.size());
+                m_nodeTable.push_back(MObjectHandle(depNode));
+            }
+
+            // Reading a driven value would evaluate its upstream nodes during the scan
+            ValueIndex& valueIndex = m_valueIndexMap[attrName];
+            if (!plug.isNull() && MayaUtils::isPlugDriven(plug)) {
+                valueIndex.drivenNodes.push_back(nodeId);
+            } else {
+                MString value = getAttributeValueAsString(depNode, attr);
+                valueIndex.postings[value.asChar()].push_back(nodeId);
+                valueIndex.nodeValues[nodeId] = value.asChar();
+            }
         }
     }
 }
@@ -222,68 +336,7 @@ MString ExtraAttrScanner::getAttributeValueAsString(const MObject& node, const M
     }
 
     // Get value according to attribute type
-    MFn::Type apiType = attr.apiType();
-
-    switch (apiType) {
-        case MFn::kNumericAttribute: {
-            MFnNumericAttribute fnNum(attr);
-            MFnNumericData::Type numType = fnNum.unitType();
-            switch (numType) {
-                case MFnNumericData::kBoolean: {
-                    bool value;
-                    plug.getValue(value);
-                    return value ? "true" : "false";
-                }
-                case MFnNumericData::kInt: {
-                    int value;
-                    plug.getValue(value);
-                    return MString() + value;
-                }
-                case MFnNumericData::kFloat: {
-                    float value;
-                    plug.getValue(value);
-                    return MString() + value;
-                }
-                case MFnNumericData::kDouble: {
-                    double value;
-                    plug.getValue(value);
-                    return MString() + value;
-                }
-                case MFnNumericData::kShort: {
-                    short value;
-                    plug.getValue(value);
-                    return MString() + value;
-                }
-                default:
-                    return plug.asString(&status);
-            }
-        }
-        case MFn::kTypedAttribute: {
-            MFnTypedAttribute fnTyped(attr);
-            MFnData::Type dataType = fnTyped.attrType();
-            if (dataType == MFnData::kString) {
-                MString value;
-                plug.getValue(value);
-                return value;
-            }
-            return plug.asString(&status);
-        }
-        case MFn::kEnumAttribute: {
-            MFnEnumAttribute fnEnum(attr);
-            short value;
-            plug.getValue(value);
-
-            // Convert enum value to string name
-            MString fieldName = fnEnum.fieldName(value, &status);
-            if (status == MS::kSuccess && fieldName.length() > 0) {
-                return fieldName;
-            }
-            // Return numeric value if field name cannot be obtained
-            return MString() + value;
-        }
-        default:
-            return plug.asString(&status);
-    }
+    return MayaUtils::getPlugValueAsString(plug, attr);
 }
 
 const std::map<MString, std::shared_ptr<AttributeInfo>, MStringLess>&
@@ -292,7 +345,7 @@ ExtraAttrScanner::getAttributeInfoMap() const
     return m_attributeInfoMap;
 }
 
-std::vector<NodeAttributeValue> ExtraAttrScanner::getNodesWithAttribute(const MString& attrName) const
+std::vector<NodeAttributeValue> ExtraAttrScanner::getNodesWithAttribute(const MString& attrName, unsigned int readFlags) const
 {
     std::vector<NodeAttributeValue> result;
 
@@ -307,12 +360,21 @@ std::vector<NodeAttributeValue> ExtraAttrScanner::getNodesWithAttribute(const MS
         return result;
     }
 
+    // Shading rows get their mesh statistics in one batch at the end
+    std::vector<size_t> shadingRows;
+    std::vector<MObject> shadingNodes;
+
+    const std::vector<uint8_t>* plugFlags = getPlugFlagList(attrName);
+
     // Collect information for each node
     MStatus status;
-    for (const MObject& node : it->second) {
-        if (node.isNull()) {
+    for (size_t i = 0; i < it->second.size(); ++i) {
+        // Skip nodes deleted since the scan
+        const MObjectHandle& handle = it->second[i];
+        if (!handle.isValid()) {
             continue;
         }
+        MObject node = handle.object();
 
         MFnDependencyNode fnDep(node, &status);
         if (status != MS::kSuccess) {
@@ -323,24 +385,637 @@ std::vector<NodeAttributeValue> ExtraAttrScanner::getNodesWithAttribute(const MS
         nodeValue.nodeObj = node;
         nodeValue.nodeName = fnDep.name(&status);
         nodeValue.nodeType = fnDep.typeName(&status);
+        nodeValue.typeFlags = MayaUtils::getNodeTypeFlags(fnDep);
+        nodeValue.plugFlags = plugFlags ? (*plugFlags)[i] : 0;
+        if ((readFlags & kReadMeshStats) && (nodeValue.typeFlags & MayaUtils::kNodeTypeShading)) {
+            shadingRows.push_back(result.size());
+            shadingNodes.push_back(node);
+        }
 
-        // Get attribute value
+        // Get attribute value and its sort key from one plug lookup
         MObject attr = fnDep.attribute(attrName, &status);
         if (status == MS::kSuccess && !attr.isNull()) {
-            nodeValue.valueStr = getAttributeValueAsString(node, attr);
+            MPlug plug = fnDep.findPlug(attr, &status);
+            if (status == MS::kSuccess) {
+                // Read live so the flags agree with the driven state below
+                nodeValue.plugFlags = MayaUtils::getPlugFlags(plug);
+            }
+            if (status == MS::kSuccess && (readFlags & kSkipDrivenValues) && MayaUtils::isPlugDriven(plug)) {
+                nodeValue.isDriven = true;
+            } else if (status == MS::kSuccess) {
+                nodeValue.valueStr = MayaUtils::getPlugValueAsString(plug, attr);
+                nodeValue.hasSortNumber = MayaUtils::getPlugSortNumber(plug, attr, nodeValue.sortNumber);
+            }
         }
 
         result.push_back(nodeValue);
     }
 
+    if (!shadingNodes.empty()) {
+        std::vector<MaterialMeshStats> stats;
+        ExtraAttrShadingIndex::sharedIndex().computeMeshStats(shadingNodes, stats);
+        for (size_t i = 0; i < shadingRows.size(); ++i) {
+            result[shadingRows[i]].hasMeshStats = true;
+            result[shadingRows[i]].meshStats = stats[i];
+        }
+    }
+
     return result;
 }
 
+bool ExtraAttrScanner::getNumericValues(const MString& attrName, std::vector<double>& outValues,
+                                        unsigned int readFlags) const
+{
+    outValues.clear();
+
+    auto it = m_attrToNodesMap.find(attrName);
+    auto attrIt = m_attributeInfoMap.find(attrName);
+    if (it == m_attrToNodesMap.end() || attrIt == m_attributeInfoMap.end()) {
+        return false;
+    }
+
+    // Only scalar types have a single numeric value per node
+    const MString& typeName = attrIt->second->typeName;
+    bool isScalar = typeName == "bool" || typeName == "int" || typeName == "short" ||
+                    typeName == "float" || typeName == "double" || typeName == "enum";
+    bool isAngle = typeName == "angle";
+    bool isDistance = typeName == "distance";
+    bool isTime = typeName == "time";
+    if (!isScalar && !isAngle && !isDistance && !isTime) {
+        return false;
+    }
+
+    outValues.reserve(it->second.size());
+
+    MStatus status;
+    for (const MObjectHandle& handle : it->second) {
+        if (!handle.isValid()) {
+            continue;
+        }
+
+        MFnDependencyNode fnDep(handle.object(), &status);
+        if (status != MS::kSuccess) {
+            continue;
+        }
+
+        MPlug plug = fnDep.findPlug(attrName, false, &status);
+        if (status != MS::kSuccess) {
+            continue;
+        }
+        if ((readFlags & kSkipDrivenValues) && MayaUtils::isPlugDriven(plug)) {
+            continue;
+        }
+
+        // Read unit attributes in UI units so they match what the user sees
+        if (isAngle) {
+            outValues.push_back(plug.asMAngle().asUnits(MAngle::uiUnit()));
+        } else if (isDistance) {
+            outValues.push_back(plug.asMDistance().asUnits(MDistance::uiUnit()));
+        } else if (isTime) {
+            outValues.push_back(plug.asMTime().as(MTime::uiUnit()));
+        } else {
+            outValues.push_back(plug.asDouble());
+        }
+    }
+
+    return true;
+}
+
+void ExtraAttrScanner::setValueIndexEnabled(bool enabled)
+{
+    m_valueIndexEnabled = enabled;
+}
+
+bool ExtraAttrScanner::isValueIndexEnabled() const
+{
+    return m_valueIndexEnabled;
+}
+
+bool ExtraAttrScanner::findNodesWithValues(const MString& attrName, const std::vector<MString>& values,
+                                           std::vector<MObject>& outNodes) const
+{
+    outNodes.clear();
+
+    if (m_attributeInfoMap.find(attrName) == m_attributeInfoMap.end()) {
+        return false;
+    }
+
+    auto indexIt = m_valueIndexMap.find(attrName);
+    if (indexIt != m_valueIndexMap.end()) {
+        // Postings lookup: cost is proportional to the result
+        for (const MString& value : values) {
+            auto postingIt = indexIt->second.postings.find(value.asChar());
+            if (postingIt == indexIt->second.postings.end()) {
+                continue;
+            }
+            for (uint32_t nodeId : postingIt->second) {
+                const MObjectHandle& handle = m_nodeTable[nodeId];
+                if (handle.isValid()) {
+                    outNodes.push_back(handle.object());
+                }
+            }
+        }
+
+        // Driven values are only read when asked for
+        for (uint32_t nodeId : indexIt->second.drivenNodes) {
+            const MObjectHandle& handle = m_nodeTable[nodeId];
+            if (!handle.isValid()) {
+                continue;
+            }
+            MObject node = handle.object();
+            MFnDependencyNode fnDep(node);
+            MString value = getAttributeValueAsString(node, fnDep.attribute(attrName));
+            for (const MString& acceptedValue : values) {
+                if (value == acceptedValue) {
+                    outNodes.push_back(node);
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    // No value index for this attribute: read and compare every value
+    std::vector<NodeAttributeValue> nodeValues = getNodesWithAttribute(attrName);
+    for (const auto& nodeValue : nodeValues) {
+        for (const MString& value : values) {
+            if (nodeValue.valueStr == value) {
+                outNodes.push_back(nodeValue.nodeObj);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool ExtraAttrScanner::isValueIndexedType(const MString& typeName)
+{
+    return typeName == "string" || typeName == "enum" || typeName == "bool" ||
+           typeName == "int" || typeName == "short";
+}
+
+void ExtraAttrScanner::updateValuePosting(const MString& attrName, uint32_t nodeId, const std::string& newValue)
+{
+    auto indexIt = m_valueIndexMap.find(attrName);
+    if (indexIt == m_valueIndexMap.end()) {
+        return;
+    }
+
+    ValueIndex& valueIndex = indexIt->second;
+    auto valueIt = valueIndex.nodeValues.find(nodeId);
+    if (valueIt == valueIndex.nodeValues.end() || valueIt->second == newValue) {
+        return;
+    }
+
+    // Remove from the old posting list (order within a list does not matter)
+    auto oldPostingIt = valueIndex.postings.find(valueIt->second);
+    if (oldPostingIt != valueIndex.postings.end()) {
+        std::vector<uint32_t>& ids = oldPostingIt->second;
+        auto idIt = std::find(ids.begin(), ids.end(), nodeId);
+        if (idIt != ids.end()) {
+            *idIt = ids.back();
+            ids.pop_back();
+        }
+        if (ids.empty()) {
+            valueIndex.postings.erase(oldPostingIt);
+        }
+    }
+
+    valueIndex.postings[newValue].push_back(nodeId);
+    valueIt->second = newValue;
+}
+
+void ExtraAttrScanner::setValueDriven(const MString& attrName, uint32_t nodeId, bool driven, const std::string& value)
+{
+    auto indexIt = m_valueIndexMap.find(attrName);
+    if (indexIt == m_valueIndexMap.end()) {
+        return;
+    }
+
+    ValueIndex& valueIndex = indexIt->second;
+    auto drivenIt = std::find(valueIndex.drivenNodes.begin(), valueIndex.drivenNodes.end(), nodeId);
+    auto valueIt = valueIndex.nodeValues.find(nodeId);
+
+    if (driven) {
+        if (valueIt != valueIndex.nodeValues.end()) {
+            auto postingIt = valueIndex.postings.find(valueIt->second);
+            if (postingIt != valueIndex.postings.end()) {
+                std::vector<uint32_t>& ids = postingIt->second;
+                auto idIt = std::find(ids.begin(), ids.end(), nodeId);
+                if (idIt != ids.end()) {
+                    *idIt = ids.back();
+                    ids.pop_back();
+                }
+                if (ids.empty()) {
+                    valueIndex.postings.erase(postingIt);
+                }
+            }
+            valueIndex.nodeValues.erase(valueIt);
+        }
+        if (drivenIt == valueIndex.drivenNodes.end()) {
+            valueIndex.drivenNodes.push_back(nodeId);
+        }
+    } else {
+        if (drivenIt != valueIndex.drivenNodes.end()) {
+            *drivenIt = valueIndex.drivenNodes.back();
+            valueIndex.drivenNodes.pop_back();
+        }
+        if (valueIt == valueIndex.nodeValues.end()) {
+            valueIndex.postings[value].push_back(nodeId);
+            valueIndex.nodeValues[nodeId] = value;
+        } else {
+            updateValuePosting(attrName, nodeId, value);
+        }
+    }
+}
+
+void ExtraAttrScanner::installValueCallbacks()
+{
+    removeValueCallbacks();
+
+    if (!m_watchValueChanges || m_valueIndexMap.empty()) {
+        return;
+    }
+
+    // Reserve up front: callbacks keep pointers into this vector
+    m_nodeWatches.reserve(m_nodeTable.size());
+
+    MStatus status;
+    for (uint32_t nodeId = 0; nodeId < m_nodeTable.size(); ++nodeId) {
+        const MObjectHandle& handle = m_nodeTable[nodeId];
+        if (!handle.isValid()) {
+            continue;
+        }
+        MObject node = handle.object();
+
+        m_nodeWatches.push_back(NodeWatch{this, nodeId});
+        MCallbackId callbackId = MNodeMessage::addAttributeChangedCallback(
+            node, attributeChangedCallback, &m_nodeWatches.back(), &status);
+        if (status == MS::kSuccess) {
+            m_valueCallbackIds.append(callbackId);
+        }
+    }
+}
+
+void ExtraAttrScanner::removeValueCallbacks()
+{
+    if (m_valueCallbackIds.length() > 0) {
+        MMessage::removeCallbacks(m_valueCallbackIds);
+        m_valueCallbackIds.clear();
+    }
+    m_nodeWatches.clear();
+}
+
+void ExtraAttrScanner::attributeChangedCallback(MNodeMessage::AttributeMessage msg, MPlug& plug,
+                                                MPlug& otherPlug, void* clientData)
+{
+    (void)otherPlug;
+
+    // Releases the table early; lookups validate cached tables without these callbacks
+    if (msg & (MNodeMessage::kAttributeAdded | MNodeMessage::kAttributeRemoved)) {
+        MayaUtils::invalidateEnumFieldTable(plug.attribute());
+    }
+
+    // Connections only matter on the driven side
+    bool connectionChanged = (msg & (MNodeMessage::kConnectionMade | MNodeMessage::kConnectionBroken)) &&
+                             (msg & MNodeMessage::kIncomingDirection);
+    if (!(msg & MNodeMessage::kAttributeSet) && !connectionChanged) {
+        return;
+    }
+
+    NodeWatch* watch = static_cast<NodeWatch*>(clientData);
+    ExtraAttrScanner* scanner = watch->scanner;
+
+    MObject attr = plug.attribute();
+    MString attrName = MFnAttribute(attr).name();
+    if (scanner->m_valueIndexMap.find(attrName) == scanner->m_valueIndexMap.end()) {
+        return;
+    }
+
+    if (connectionChanged) {
+        // A newly driven plug is read live, so its value is not read here
+        bool driven = (msg & MNodeMessage::kConnectionMade) != 0;
+        MString value = driven ? MString() : scanner->getAttributeValueAsString(plug.node(), attr);
+        scanner->setValueDriven(attrName, watch->nodeId, driven, value.asChar());
+    } else {
+        MString value = scanner->getAttributeValueAsString(plug.node(), attr);
+        scanner->updateValuePosting(attrName, watch->nodeId, value.asChar());
+    }
+
+    // String values are part of the search index
+    if (attr.hasFn(MFn::kTypedAttribute)) {
+        scanner->m_searchIndexValid = false;
+    }
+}
+
+bool ExtraAttrScanner::search(const MString& pattern, bool isRegex, std::vector<SearchMatch>& outMatches)
+{
+    outMatches.clear();
+
+    if (!m_searchIndexValid) {
+        buildSearchIndex();
+    }
+
+    std::vector<uint32_t> ids;
+    if (isRegex) {
+        if (!m_searchIndex.findRegex(pattern.asChar(), ids)) {
+            return false;
+        }
+    } else {
+        m_searchIndex.findSubstring(pattern.asChar(), ids);
+    }
+
+    outMatches.reserve(ids.size());
+    for (uint32_t id : ids) {
+        outMatches.push_back(m_searchEntries[id]);
+    }
+    return true;
+}
+
+void ExtraAttrScanner::buildSearchIndex()
+{
+    m_searchIndex.clear();
+    m_searchEntries.clear();
+
+    std::unordered_map<unsigned int, std::vector<MObject>> seenNodes;
+
+    for (const auto& pair : m_attributeInfoMap) {
+        SearchMatch attrEntry;
+        attrEntry.kind = SearchMatch::kAttribute;
+        attrEntry.name = pair.first;
+        m_searchIndex.add(pair.first.asChar());
+        m_searchEntries.push_back(attrEntry);
+
+        auto nodesIt = m_attrToNodesMap.find(pair.first);
+        if (nodesIt == m_attrToNodesMap.end()) {
+            continue;
+        }
+
+        bool isString = (pair.second->typeName == "string");
+
+        for (const MObjectHandle& handle : nodesIt->second) {
+            if (!handle.isValid()) {
+                continue;
+            }
+
+            MObject node = handle.object();
+            MFnDependencyNode fnDep(node);
+            MString nodeName = fnDep.name();
+
+            // Each node is indexed once, however many attributes it has
+            std::vector<MObject>& bucket = seenNodes[MObjectHandle(node).hashCode()];
+            if (std::find(bucket.begin(), bucket.end(), node) == bucket.end()) {
+                bucket.push_back(node);
+
+                SearchMatch nodeEntry;
+                nodeEntry.kind = SearchMatch::kNode;
+                nodeEntry.name = nodeName;
+                m_searchIndex.add(nodeName.asChar());
+                m_searchEntries.push_back(nodeEntry);
+            }
+
+            if (isString) {
+                MObject attr = fnDep.attribute(pair.first);
+                if (attr.isNull()) {
+                    continue;
+                }
+
+                SearchMatch valueEntry;
+                valueEntry.kind = SearchMatch::kValue;
+                valueEntry.name = nodeName + "." + pair.first;
+                valueEntry.valueStr = getAttributeValueAsString(node, attr);
+                m_searchIndex.add(valueEntry.valueStr.asChar());
+                m_searchEntries.push_back(valueEntry);
+            }
+        }
+    }
+
+    m_searchIndexValid = true;
+}
+
+const std::vector<MObjectHandle>* ExtraAttrScanner::getNodeList(const MString& attrName) const
+{
+    auto it = m_attrToNodesMap.find(attrName);
+    if (it == m_attrToNodesMap.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+const std::vector<uint8_t>* ExtraAttrScanner::getPlugFlagList(const MString& attrName) const
+{
+    auto it = m_attrToFlagsMap.find(attrName);
+    if (it == m_attrToFlagsMap.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+bool ExtraAttrScanner::findNodesWithPlugFlags(const MString& attrName, unsigned int requiredFlags,
+                                              unsigned int excludedFlags, std::vector<MObject>& outNodes) const
+{
+    outNodes.clear();
+
+    const std::vector<MObjectHandle>* nodes = getNodeList(attrName);
+    const std::vector<uint8_t>* plugFlags = getPlugFlagList(attrName);
+    if (!nodes || !plugFlags) {
+        return false;
+    }
+
+    for (size_t i = 0; i < nodes->size(); ++i) {
+        unsigned int flags = (*plugFlags)[i];
+        if ((flags & requiredFlags) == requiredFlags && (flags & excludedFlags) == 0 && (*nodes)[i].isValid()) {
+            outNodes.push_back((*nodes)[i].object());
+        }
+    }
+    return true;
+}
+
+void ExtraAttrScanner::renameAttribute(const MString& oldName, const MString& newName,
+                                       const std::vector<MObject>& nodes)
+{
+    auto infoIt = m_attributeInfoMap.find(oldName);
+    if (infoIt == m_attributeInfoMap.end()) {
+        return;
+    }
+
+    std::shared_ptr<AttributeInfo> oldInfo = infoIt->second;
+
+    // The value index can follow a whole-attribute rename to an unused name;
+    // partial moves and merges fall back to linear lookups for both names
+    auto valueIt = m_valueIndexMap.find(oldName);
+    if (valueIt != m_valueIndexMap.end()) {
+        const std::vector<MObjectHandle>* oldNodes = getNodeList(oldName);
+        bool wholeMove = oldNodes && nodes.size() >= oldNodes->size() &&
+                         m_attributeInfoMap.find(newName) == m_attributeInfoMap.end();
+        if (wholeMove) {
+            m_valueIndexMap[newName].postings.swap(valueIt->second.postings);
+            m_valueIndexMap[newName].nodeValues.swap(valueIt->second.nodeValues);
+            m_valueIndexMap[newName].drivenNodes.swap(valueIt->second.drivenNodes);
+        } else {
+            m_valueIndexMap.erase(newName);
+        }
+        m_valueIndexMap.erase(oldName);
+    } else {
+        m_valueIndexMap.erase(newName);
+    }
+
+    std::vector<uint8_t> movedFlags;
+    std::vector<MObjectHandle> movedNodes = extractNodes(oldName, nodes, movedFlags);
+    m_searchIndexValid = false;
+    if (movedNodes.empty()) {
+        return;
+    }
+
+    auto newIt = m_attributeInfoMap.find(newName);
+    if (newIt == m_attributeInfoMap.end()) {
+        auto newInfo = std::make_shared<AttributeInfo>(*oldInfo);
+        newInfo->name = newName;
+        newInfo->usageCount = 0;
+        newIt = m_attributeInfoMap.emplace(newName, newInfo).first;
+    }
+
+    // Merge into the new name, which other nodes may already use
+    newIt->second->usageCount += static_cast<int>(movedNodes.size());
+    std::vector<MObjectHandle>& newNodes = m_attrToNodesMap[newName];
+    newNodes.insert(newNodes.end(), movedNodes.begin(), movedNodes.end());
+    std::vector<uint8_t>& newFlags = m_attrToFlagsMap[newName];
+    newFlags.insert(newFlags.end(), movedFlags.begin(), movedFlags.end());
+}
+
+void ExtraAttrScanner::removeAttributeFromNodes(const MString& attrName, const std::vector<MObject>& nodes)
+{
+    m_valueIndexMap.erase(attrName);
+    std::vector<uint8_t> removedFlags;
+    extractNodes(attrName, nodes, removedFlags);
+    m_searchIndexValid = false;
+}
+
+void ExtraAttrScanner::restoreAttributeOnNodes(const AttributeInfo& info, const std::vector<MObject>& nodes)
+{
+    if (nodes.empty()) {
+        return;
+    }
+
+    // Restored nodes are not in the value index; lookups fall back to reading values
+    m_valueIndexMap.erase(info.name);
+    m_searchIndexValid = false;
+
+    auto infoIt = m_attributeInfoMap.find(info.name);
+    if (infoIt == m_attributeInfoMap.end()) {
+        auto attrInfo = std::make_shared<AttributeInfo>(info);
+        attrInfo->usageCount = 0;
+        infoIt = m_attributeInfoMap.emplace(info.name, attrInfo).first;
+    }
+
+    infoIt->second->usageCount += static_cast<int>(nodes.size());
+    std::vector<MObjectHandle>& attrNodes = m_attrToNodesMap[info.name];
+    for (const MObject& node : nodes) {
+        attrNodes.push_back(MObjectHandle(node));
+    }
+
+    // Restored plugs start over from their current state
+    std::vector<uint8_t>& attrFlags = m_attrToFlagsMap[info.name];
+    MStatus status;
+    for (const MObject& node : nodes) {
+        unsigned int plugFlags = 0;
+        MFnDependencyNode fnDep(node, &status);
+        if (status == MS::kSuccess) {
+            MPlug plug = fnDep.findPlug(info.name, false, &status);
+            if (status == MS::kSuccess) {
+                plugFlags = MayaUtils::getPlugFlags(plug);
+            }
+        }
+        attrFlags.push_back(static_cast<uint8_t>(plugFlags));
+    }
+}
+
+std::vector<MObjectHandle> ExtraAttrScanner::extractNodes(const MString& attrName, const std::vector<MObject>& nodes,
+                                                          std::vector<uint8_t>& outFlags)
+{
+    std::vector<MObjectHandle> extracted;
+    outFlags.clear();
+
+    auto nodesIt = m_attrToNodesMap.find(attrName);
+    auto flagsIt = m_attrToFlagsMap.find(attrName);
+    auto infoIt = m_attributeInfoMap.find(attrName);
+    if (nodesIt == m_attrToNodesMap.end() || flagsIt == m_attrToFlagsMap.end() ||
+        infoIt == m_attributeInfoMap.end()) {
+        return extracted;
+    }
+
+    std::vector<MObjectHandle>& attrNodes = nodesIt->second;
+    std::vector<uint8_t>& attrFlags = flagsIt->second;
+
+    if (nodes.size() >= attrNodes.size()) {
+        // Whole attribute is affected (the usual case for scene-wide operations)
+        extracted.swap(attrNodes);
+        outFlags.swap(attrFlags);
+    } else {
+        // Bucket the nodes to remove by handle hash so the pass stays linear
+        std::unordered_multimap<unsigned int, MObject> toRemove;
+        toRemove.reserve(nodes.size());
+        for (const MObject& node : nodes) {
+            toRemove.emplace(MObjectHandle(node).hashCode(), node);
+        }
+
+        std::vector<MObjectHandle> kept;
+        std::vector<uint8_t> keptFlags;
+        kept.reserve(attrNodes.size() - nodes.size());
+        keptFlags.reserve(attrNodes.size() - nodes.size());
+        for (size_t i = 0; i < attrNodes.size(); ++i) {
+            const MObjectHandle& node = attrNodes[i];
+            bool matched = false;
+            auto range = toRemove.equal_range(node.hashCode());
+            for (auto it = range.first; it != range.second; ++it) {
+                if (node.isValid() && it->second == node.objectRef()) {
+                    matched = true;
+                    break;
+                }
+            }
+
+            if (matched) {
+                extracted.push_back(node);
+                outFlags.push_back(attrFlags[i]);
+            } else {
+                kept.push_back(node);
+                keptFlags.push_back(attrFlags[i]);
+            }
+        }
+        attrNodes.swap(kept);
+        attrFlags.swap(keptFlags);
+    }
+
+    infoIt->second->usageCount -= static_cast<int>(extracted.size());
+    if (attrNodes.empty()) {
+        m_attrToNodesMap.erase(nodesIt);
+        m_attrToFlagsMap.erase(flagsIt);
+        m_attributeInfoMap.erase(infoIt);
+    }
+
+    return extracted;
+}
+
 void ExtraAttrScanner::clearCache()
 {
     m_attributeInfoMap.clear();
     m_attrToNodesMap.clear();
+    m_attrToFlagsMap.clear();
     m_totalNodesScanned = 0;
+    m_hasScanResults = false;
+    m_pendingNodes.clear();
+    m_nextPendingNode = 0;
+    removeValueCallbacks();
+    m_valueIndexMap.clear();
+    m_nodeTable.clear();
+    m_searchIndex.clear();
+    m_searchEntries.clear();
+    m_searchIndexValid = false;
+}
+
+bool ExtraAttrScanner::hasScanResults() const
+{
+    return m_hasScanResults;
 }
 
 void ExtraAttrScanner::getStatistics(int& totalAttrs, int& totalNodes) const
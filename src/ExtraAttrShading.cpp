@@ -0,0 +1,377 @@
+#include "ExtraAttrShading.h"
+#include <maya/MFnDagNode.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MFnMesh.h>
+#include <maya/MFnSet.h>
+#include <maya/MFnSingleIndexedComponent.h>
+#include <maya/MIntArray.h>
+#include <maya/MObjectArray.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MPlug.h>
+#include <maya/MPlugArray.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// Append a node unless the list already holds it
+void appendUnique(std::vector<MObject>& nodes, const MObject& node)
+{
+    MObjectHandle handle(node);
+    for (const MObject& existing : nodes) {
+        if (MObjectHandle(existing) == handle) {
+            return;
+        }
+    }
+    nodes.push_back(node);
+}
+
+bool isRenderableMesh(const MDagPath& path)
+{
+    if (!path.node().hasFn(MFn::kMesh)) {
+        return false;
+    }
+
+    // Intermediate objects (deformer inputs) are never shaded
+    MFnDagNode fnDag(path);
+    return !fnDag.isIntermediateObject();
+}
+
+// Add a mesh path unless a path with the same full name was already added
+void appendMesh(const MDagPath& path, std::unordered_set<std::string>& seen, std::vector<MDagPath>& outMeshes)
+{
+    if (seen.insert(path.fullPathName().asChar()).second) {
+        outMeshes.push_back(path);
+    }
+}
+
+// Get the members of a shading engine, or an empty list if it is not a set
+MSelectionList getSetMembers(const MObject& engine)
+{
+    MSelectionList members;
+    MStatus status;
+    MFnSet fnSet(engine, &status);
+    if (status == MS::kSuccess) {
+        fnSet.getMembers(members, false);
+    }
+    return members;
+}
+
+} // namespace
+
+namespace ExtraAttrShading {
+
+void findShadingEngines(const std::vector<MObject>& shadingNodes, std::vector<MObject>& outEngines)
+{
+    outEngines.clear();
+
+    MStatus status;
+    for (const MObject& node : shadingNodes) {
+        if (node.isNull()) {
+            continue;
+        }
+
+        if (node.hasFn(MFn::kShadingEngine)) {
+            appendUnique(outEngines, node);
+            continue;
+        }
+
+        MFnDependencyNode fnDep(node, &status);
+        if (status != MS::kSuccess) {
+            continue;
+        }
+
+        // Follow every outgoing connection one step downstream
+        MPlugArray plugs;
+        fnDep.getConnections(plugs);
+        for (unsigned int i = 0; i < plugs.length(); ++i) {
+            MPlugArray destinations;
+            plugs[i].connectedTo(destinations, false, true);
+            for (unsigned int j = 0; j < destinations.length(); ++j) {
+                MObject destination = destinations[j].node();
+                if (destination.hasFn(MFn::kShadingEngine)) {
+                    appendUnique(outEngines, destination);
+                }
+            }
+        }
+    }
+}
+
+void findMemberMeshes(const std::vector<MObject>& engines, std::vector<MDagPath>& outMeshes)
+{
+    outMeshes.clear();
+    std::unordered_set<std::string> seen;
+
+    for (const MObject& engine : engines) {
+        MSelectionList members = getSetMembers(engine);
+
+        for (unsigned int i = 0; i < members.length(); ++i) {
+            MDagPath path;
+            MObject component;
+            if (members.getDagPath(i, path, component) != MS::kSuccess) {
+                continue;
+            }
+
+            if (isRenderableMesh(path)) {
+                appendMesh(path, seen, outMeshes);
+                continue;
+            }
+
+            // A transform member stands for its mesh shapes
+            unsigned int shapeCount = 0;
+            path.numberOfShapesDirectlyBelow(shapeCount);
+            for (unsigned int shape = 0; shape < shapeCount; ++shape) {
+                MDagPath shapePath(path);
+                if (shapePath.extendToShapeDirectlyBelow(shape) == MS::kSuccess && isRenderableMesh(shapePath)) {
+                    appendMesh(shapePath, seen, outMeshes);
+                }
+            }
+        }
+    }
+}
+
+MStatus getAssignedFaces(const MDagPath& meshPath, const std::vector<MObject>& engines, MeshFaceSet& outFaceSet)
+{
+    MeshPartition partition;
+    MStatus status = getFacePartition(meshPath, std::vector<std::vector<MObject>>(1, engines), partition);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    getPartitionFaces(partition, 0, outFaceSet);
+    return MS::kSuccess;
+}
+
+MStatus getFacePartition(const MDagPath& meshPath, const std::vector<std::vector<MObject>>& engineGroups,
+                         MeshPartition& outPartition)
+{
+    MStatus status;
+    MFnMesh fnMesh(meshPath, &status);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    // One shader slot per engine connected to this instance, and a slot index per face
+    MObjectArray shaders;
+    MIntArray shaderIndices;
+    status = fnMesh.getConnectedShaders(meshPath.instanceNumber(), shaders, shaderIndices);
+    if (status != MS::kSuccess) {
+        return status;
+    }
+
+    outPartition.meshPath = meshPath;
+    outPartition.shaders.clear();
+    outPartition.groupSizes.assign(engineGroups.size(), 0);
+
+    std::vector<int> slotGroups(shaders.length(), -1);
+    bool anyGrouped = false;
+    for (unsigned int slot = 0; slot < shaders.length(); ++slot) {
+        outPartition.shaders.push_back(shaders[slot]);
+
+        MObjectHandle shader(shaders[slot]);
+        for (size_t group = 0; group < engineGroups.size() && slotGroups[slot] < 0; ++group) {
+            for (const MObject& engine : engineGroups[group]) {
+                if (MObjectHandle(engine) == shader) {
+                    slotGroups[slot] = static_cast<int>(group);
+                    anyGrouped = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    unsigned int faceCount = shaderIndices.length();
+    outPartition.faceShaders.resize(faceCount);
+    if (faceCount > 0) {
+        shaderIndices.get(outPartition.faceShaders.data());
+    }
+    outPartition.faceGroups.assign(faceCount, -1);
+    if (!anyGrouped) {
+        return MS::kSuccess;
+    }
+
+    for (unsigned int face = 0; face < faceCount; ++face) {
+        int slot = outPartition.faceShaders[face];
+        int group = slot >= 0 ? slotGroups[slot] : -1;
+        if (group >= 0) {
+            outPartition.faceGroups[face] = group;
+            outPartition.groupSizes[group]++;
+        }
+    }
+
+    return MS::kSuccess;
+}
+
+void getPartitionFaces(const MeshPartition& partition, int group, MeshFaceSet& outFaceSet)
+{
+    outFaceSet.meshPath = partition.meshPath;
+    outFaceSet.faces.clear();
+    outFaceSet.faceCount = static_cast<int>(partition.faceGroups.size());
+
+    for (size_t face = 0; face < partition.faceGroups.size(); ++face) {
+        int faceGroup = partition.faceGroups[face];
+        if (faceGroup >= 0 && (group < 0 || faceGroup == group)) {
+            outFaceSet.faces.push_back(static_cast<int>(face));
+        }
+    }
+    outFaceSet.allFaces = (outFaceSet.faceCount > 0 && static_cast<int>(outFaceSet.faces.size()) == outFaceSet.faceCount);
+}
+
+void resolvePartitions(const std::vector<MObject>& shadingNodes, std::vector<MeshPartition>& outPartitions)
+{
+    outPartitions.clear();
+
+    std::vector<std::vector<MObject>> engineGroups(shadingNodes.size());
+    std::vector<MObject> allEngines;
+    for (size_t i = 0; i < shadingNodes.size(); ++i) {
+        findShadingEngines(std::vector<MObject>(1, shadingNodes[i]), engineGroups[i]);
+        for (const MObject& engine : engineGroups[i]) {
+            appendUnique(allEngines, engine);
+        }
+    }
+    if (allEngines.empty()) {
+        return;
+    }
+
+    std::vector<MDagPath> meshes;
+    findMemberMeshes(allEngines, meshes);
+
+    for (const MDagPath& meshPath : meshes) {
+        MeshPartition partition;
+        if (getFacePartition(meshPath, engineGroups, partition) != MS::kSuccess) {
+            continue;
+        }
+        for (int size : partition.groupSizes) {
+            if (size > 0) {
+                outPartitions.push_back(std::move(partition));
+                break;
+            }
+        }
+    }
+
+    // Link instances to the first partition on the same shape node, and to the
+    // first one with the same per-face grouping (which gives the same meshes)
+    std::unordered_multimap<unsigned int, int> shapeLookup;
+    std::vector<std::vector<int>> ownerSources(outPartitions.size());
+    for (size_t i = 0; i < outPartitions.size(); ++i) {
+        MeshPartition& partition = outPartitions[i];
+        MObjectHandle shape(partition.meshPath.node());
+        partition.shapeOwner = static_cast<int>(i);
+        partition.geometrySource = static_cast<int>(i);
+
+        auto range = shapeLookup.equal_range(shape.hashCode());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (MObjectHandle(outPartitions[it->second].meshPath.node()) == shape) {
+                partition.shapeOwner = it->second;
+                break;
+            }
+        }
+        if (partition.shapeOwner == static_cast<int>(i)) {
+            shapeLookup.emplace(shape.hashCode(), static_cast<int>(i));
+        }
+
+        std::vector<int>& sources = ownerSources[partition.shapeOwner];
+        for (int source : sources) {
+            if (outPartitions[source].faceGroups == partition.faceGroups) {
+                partition.geometrySource = source;
+                break;
+            }
+        }
+        if (partition.geometrySource == static_cast<int>(i)) {
+            sources.push_back(static_cast<int>(i));
+        }
+    }
+}
+
+void resolveFaces(const std::vector<MObject>& shadingNodes, std::vector<MeshFaceSet>& outFaceSets)
+{
+    outFaceSets.clear();
+
+    std::vector<MObject> engines;
+    findShadingEngines(shadingNodes, engines);
+    if (engines.empty()) {
+        return;
+    }
+
+    std::vector<MDagPath> meshes;
+    findMemberMeshes(engines, meshes);
+
+    for (const MDagPath& meshPath : meshes) {
+        MeshFaceSet faceSet;
+        if (getAssignedFaces(meshPath, engines, faceSet) == MS::kSuccess && !faceSet.faces.empty()) {
+            outFaceSets.push_back(std::move(faceSet));
+        }
+    }
+}
+
+void resolveObjects(const std::vector<MObject>& shadingNodes, MSelectionList& outObjects)
+{
+    std::vector<MObject> engines;
+    findShadingEngines(shadingNodes, engines);
+
+    for (const MObject& engine : engines) {
+        MSelectionList members = getSetMembers(engine);
+
+        for (unsigned int i = 0; i < members.length(); ++i) {
+            MDagPath path;
+            MObject component;
+            if (members.getDagPath(i, path, component) != MS::kSuccess) {
+                continue;
+            }
+
+            // Shapes and their components are shown through the parent transform
+            if (path.node().hasFn(MFn::kShape)) {
+                path.pop();
+            }
+            outObjects.add(path, MObject::kNullObj, true);
+        }
+    }
+}
+
+MObject createFaceComponent(const MeshFaceSet& faceSet)
+{
+    MFnSingleIndexedComponent fnComponent;
+    MObject component = fnComponent.create(MFn::kMeshPolygonComponent);
+
+    if (faceSet.allFaces) {
+        fnComponent.setCompleteData(faceSet.faceCount);
+    } else {
+        MIntArray elements(faceSet.faces.data(), static_cast<unsigned int>(faceSet.faces.size()));
+        fnComponent.addElements(elements);
+    }
+
+    return component;
+}
+
+void addFaceSets(const std::vector<MeshFaceSet>& faceSets, MSelectionList& outList)
+{
+    for (const MeshFaceSet& faceSet : faceSets) {
+        outList.add(faceSet.meshPath, createFaceComponent(faceSet), true);
+    }
+}
+
+void getFaceRangeNames(const MeshFaceSet& faceSet, MStringArray& outNames)
+{
+    const std::vector<int>& faces = faceSet.faces;
+    const std::string prefix = std::string(faceSet.meshPath.fullPathName().asChar()) + ".f[";
+
+    std::string name;
+    for (size_t first = 0; first < faces.size();) {
+        size_t last = first;
+        while (last + 1 < faces.size() && faces[last + 1] == faces[last] + 1) {
+            ++last;
+        }
+
+        name = prefix + std::to_string(faces[first]);
+        if (last > first) {
+            name += ":" + std::to_string(faces[last]);
+        }
+        name += "]";
+        outNames.append(MString(name.c_str()));
+
+        first = last + 1;
+    }
+}
+
+} // namespace ExtraAttrShading
@@ -0,0 +1,579 @@
+#include "ExtraAttrShadingIndex.h"
+#include <maya/MDGMessage.h>
+#include <maya/MFnMesh.h>
+#include <maya/MIntArray.h>
+#include <maya/MItDependencyNodes.h>
+#include <maya/MMatrix.h>
+#include <maya/MObjectArray.h>
+#include <maya/MObjectSetMessage.h>
+#include <maya/MSceneMessage.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <thread>
+
+namespace {
+
+const int kBitsPerWord = 64;
+
+size_t wordCount(int faceCount)
+{
+    return static_cast<size_t>((faceCount + kBitsPerWord - 1) / kBitsPerWord);
+}
+
+// Append the indices of the set bits in ascending order
+void appendSetBits(const std::vector<uint64_t>& bits, int faceCount, std::vector<int>& outFaces)
+{
+    for (size_t word = 0; word < bits.size(); ++word) {
+        if (bits[word] == 0) {
+            continue;
+        }
+        int first = static_cast<int>(word) * kBitsPerWord;
+        int last = std::min(first + kBitsPerWord, faceCount);
+        for (int face = first; face < last; ++face) {
+            if ((bits[word] >> (face - first)) & 1) {
+                outFaces.push_back(face);
+            }
+        }
+    }
+}
+
+// Points and face-vertex lists of one mesh shape, copied on the main thread
+struct RawMesh {
+    std::vector<float> points;          // xyz per vertex
+    std::vector<int> polygonCounts;     // Vertices per face
+    std::vector<int> polygonConnects;   // Vertex per face-vertex
+    std::vector<int> faceOffsets;       // First face-vertex of each face
+};
+
+// Faces of one mesh instance for one shading node, measured on a worker thread
+struct MeasureTask {
+    size_t node;                        // Index of the shading node
+    size_t mesh;                        // Index of the shape's RawMesh
+    MMatrix matrix;                     // Object to world
+    std::vector<uint64_t> bits;         // Faces to measure
+    MaterialMeshStats stats;
+};
+
+bool readRawMesh(const MDagPath& meshPath, RawMesh& outMesh)
+{
+    MStatus status;
+    MFnMesh fnMesh(meshPath, &status);
+    if (status != MS::kSuccess) {
+        return false;
+    }
+
+    int vertexCount = fnMesh.numVertices();
+    const float* rawPoints = fnMesh.getRawPoints(&status);
+    if (status != MS::kSuccess || (rawPoints == nullptr && vertexCount > 0)) {
+        return false;
+    }
+    outMesh.points.assign(rawPoints, rawPoints + vertexCount * 3);
+
+    MIntArray polygonCounts;
+    MIntArray polygonConnects;
+    if (fnMesh.getVertices(polygonCounts, polygonConnects) != MS::kSuccess) {
+        return false;
+    }
+    outMesh.polygonCounts.resize(polygonCounts.length());
+    outMesh.polygonConnects.resize(polygonConnects.length());
+    if (polygonCounts.length() > 0) {
+        polygonCounts.get(outMesh.polygonCounts.data());
+    }
+    if (polygonConnects.length() > 0) {
+        polygonConnects.get(outMesh.polygonConnects.data());
+    }
+
+    outMesh.faceOffsets.resize(outMesh.polygonCounts.size());
+    int offset = 0;
+    for (size_t face = 0; face < outMesh.polygonCounts.size(); ++face) {
+        outMesh.faceOffsets[face] = offset;
+        offset += outMesh.polygonCounts[face];
+    }
+    return true;
+}
+
+void measureFaces(const RawMesh& mesh, MeasureTask& task)
+{
+    const MMatrix& matrix = task.matrix;
+    const int faceCount = static_cast<int>(mesh.polygonCounts.size());
+    std::vector<char> usedVertices(mesh.points.size() / 3, 0);
+
+    // Points are row vectors in Maya: p' = p * M
+    auto worldPoint = [&mesh, &matrix](int vertex, double* out) {
+        double x = mesh.points[vertex * 3];
+        double y = mesh.points[vertex * 3 + 1];
+        double z = mesh.points[vertex * 3 + 2];
+        for (unsigned int axis = 0; axis < 3; ++axis) {
+            out[axis] = x * matrix(0, axis) + y * matrix(1, axis) + z * matrix(2, axis) + matrix(3, axis);
+        }
+    };
+
+    for (size_t word = 0; word < task.bits.size(); ++word) {
+        if (task.bits[word] == 0) {
+            continue;
+        }
+        int first = static_cast<int>(word) * kBitsPerWord;
+        int last = std::min(first + kBitsPerWord, faceCount);
+        for (int face = first; face < last; ++face) {
+            if (!((task.bits[word] >> (face - first)) & 1)) {
+                continue;
+            }
+
+            int count = mesh.polygonCounts[face];
+            const int* vertices = mesh.polygonConnects.data() + mesh.faceOffsets[face];
+            task.stats.faceCount++;
+            task.stats.triangleCount += std::max(0, count - 2);
+
+            // Newell normal of the polygon; its length is twice the area
+            double normal[3] = {0.0, 0.0, 0.0};
+            double previous[3];
+            double current[3];
+            worldPoint(vertices[count - 1], previous);
+            for (int i = 0; i < count; ++i) {
+                worldPoint(vertices[i], current);
+                normal[0] += (previous[1] - current[1]) * (previous[2] + current[2]);
+                normal[1] += (previous[2] - current[2]) * (previous[0] + current[0]);
+                normal[2] += (previous[0] - current[0]) * (previous[1] + current[1]);
+                std::copy(current, current + 3, previous);
+
+                if (!usedVertices[vertices[i]]) {
+                    usedVertices[vertices[i]] = 1;
+                    task.stats.vertexCount++;
+                }
+            }
+            task.stats.surfaceArea +=
+                0.5 * std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        }
+    }
+}
+
+// Run measureFaces for every task, spread over worker threads
+void measureAll(const std::vector<RawMesh>& meshes, std::vector<MeasureTask>& tasks)
+{
+    std::atomic<size_t> next(0);
+    auto work = [&meshes, &tasks, &next]() {
+        for (size_t i = next++; i < tasks.size(); i = next++) {
+            measureFaces(meshes[tasks[i].mesh], tasks[i]);
+        }
+    };
+
+    size_t threadCount = std::min<size_t>(tasks.size(), std::max(1u, std::thread::hardware_concurrency()));
+    if (threadCount <= 1) {
+        work();
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+ExtraAttrShadingIndex::ExtraAttrShadingIndex()
+    : m_valid(false)
+{
+}
+
+ExtraAttrShadingIndex::~ExtraAttrShadingIndex()
+{
+    clear();
+}
+
+ExtraAttrShadingIndex& ExtraAttrShadingIndex::sharedIndex()
+{
+    static ExtraAttrShadingIndex s_sharedIndex;
+    return s_sharedIndex;
+}
+
+void ExtraAttrShadingIndex::resolveFaces(const std::vector<MObject>& shadingNodes, std::vector<MeshFaceSet>& outFaceSets)
+{
+    outFaceSets.clear();
+
+    std::vector<MObject> engines;
+    ExtraAttrShading::findShadingEngines(shadingNodes, engines);
+
+    std::vector<InstanceFaces> instances;
+    collectFaces(engines, instances);
+
+    outFaceSets.resize(instances.size());
+    for (size_t i = 0; i < instances.size(); ++i) {
+        MeshFaceSet& faceSet = outFaceSets[i];
+        faceSet.meshPath = instances[i].meshPath;
+        faceSet.faceCount = instances[i].faceCount;
+        appendSetBits(instances[i].bits, faceSet.faceCount, faceSet.faces);
+        faceSet.allFaces = (faceSet.faceCount > 0 && static_cast<int>(faceSet.faces.size()) == faceSet.faceCount);
+    }
+}
+
+void ExtraAttrShadingIndex::computeMeshStats(const std::vector<MObject>& shadingNodes,
+                                             std::vector<MaterialMeshStats>& outStats)
+{
+    outStats.assign(shadingNodes.size(), MaterialMeshStats());
+
+    // Merged bitsets are copies, so later engine refreshes cannot invalidate them
+    std::vector<std::vector<InstanceFaces>> nodeInstances(shadingNodes.size());
+    std::vector<MObjectHandle> nodeEngines(shadingNodes.size());  // Single engine whose cache to fill
+    for (size_t node = 0; node < shadingNodes.size(); ++node) {
+        std::vector<MObject> engines;
+        ExtraAttrShading::findShadingEngines(std::vector<MObject>(1, shadingNodes[node]), engines);
+
+        // Vertices shared between engines are counted once, so only single-engine nodes use the cache
+        if (engines.size() == 1) {
+            EngineEntry* entry = getEngine(engines[0]);
+            if (entry == nullptr) {
+                continue;
+            }
+            if (hasCurrentStats(*entry)) {
+                outStats[node] = entry->stats;
+                continue;
+            }
+            nodeEngines[node] = entry->engine;
+        }
+        collectFaces(engines, nodeInstances[node]);
+    }
+
+    // Each shape is read once, however many instances and materials use it
+    std::vector<RawMesh> meshes;
+    std::vector<MObjectHandle> meshHandles;
+    std::unordered_multimap<unsigned int, size_t> meshLookup;
+    std::vector<MeasureTask> tasks;
+    for (size_t node = 0; node < nodeInstances.size(); ++node) {
+        for (InstanceFaces& instance : nodeInstances[node]) {
+            size_t mesh = meshes.size();
+            auto range = meshLookup.equal_range(instance.mesh.hashCode());
+            for (auto it = range.first; it != range.second; ++it) {
+                if (meshHandles[it->second] == instance.mesh) {
+                    mesh = it->second;
+                    break;
+                }
+            }
+
+            if (mesh == meshes.size()) {
+                RawMesh raw;
+                if (!readRawMesh(instance.meshPath, raw)) {
+                    continue;
+                }
+                meshes.push_back(std::move(raw));
+                meshHandles.push_back(instance.mesh);
+                meshLookup.emplace(instance.mesh.hashCode(), mesh);
+            }
+            if (static_cast<int>(meshes[mesh].polygonCounts.size()) != instance.faceCount) {
+                continue;
+            }
+
+            MeasureTask task;
+            task.node = node;
+            task.mesh = mesh;
+            task.matrix = instance.meshPath.inclusiveMatrix();
+            task.bits.swap(instance.bits);
+            tasks.push_back(std::move(task));
+        }
+    }
+
+    measureAll(meshes, tasks);
+
+    for (const MeasureTask& task : tasks) {
+        MaterialMeshStats& stats = outStats[task.node];
+        stats.faceCount += task.stats.faceCount;
+        stats.triangleCount += task.stats.triangleCount;
+        stats.vertexCount += task.stats.vertexCount;
+        stats.surfaceArea += task.stats.surfaceArea;
+    }
+
+    for (size_t node = 0; node < nodeEngines.size(); ++node) {
+        EngineEntry* entry = nodeEngines[node].isValid() ? findEngine(nodeEngines[node].object()) : nullptr;
+        if (entry == nullptr) {
+            continue;
+        }
+
+        entry->stats = outStats[node];
+        entry->statsMatrices.clear();
+        for (const MeshFaces& mesh : entry->meshes) {
+            entry->statsMatrices.push_back(mesh.meshPath.inclusiveMatrix());
+        }
+        entry->statsValid = true;
+    }
+}
+
+void ExtraAttrShadingIndex::invalidateMeshStats()
+{
+    for (EngineEntry& entry : m_engines) {
+        entry.statsValid = false;
+    }
+}
+
+void ExtraAttrShadingIndex::clear()
+{
+    removeCallbacks();
+    m_engines.clear();
+    m_engineLookup.clear();
+    m_valid = false;
+}
+
+void ExtraAttrShadingIndex::collectFaces(const std::vector<MObject>& engines, std::vector<InstanceFaces>& outInstances)
+{
+    outInstances.clear();
+
+    // A mesh instance split between several engines gets one entry with their faces merged
+    std::unordered_map<std::string, size_t> instanceSlots;
+    for (const MObject& engine : engines) {
+        EngineEntry* entry = getEngine(engine);
+        if (entry == nullptr) {
+            continue;
+        }
+
+        for (const MeshFaces& mesh : entry->meshes) {
+            auto inserted = instanceSlots.emplace(mesh.meshPath.fullPathName().asChar(), outInstances.size());
+            if (inserted.second) {
+                outInstances.push_back(InstanceFaces{mesh.meshPath, mesh.mesh, mesh.bits, mesh.faceCount});
+                continue;
+            }
+
+            std::vector<uint64_t>& bits = outInstances[inserted.first->second].bits;
+            for (size_t word = 0; word < bits.size() && word < mesh.bits.size(); ++word) {
+                bits[word] |= mesh.bits[word];
+            }
+        }
+    }
+}
+
+void ExtraAttrShadingIndex::build()
+{
+    clear();
+
+    std::vector<MObject> engines;
+    for (MItDependencyNodes it(MFn::kShadingEngine); !it.isDone(); it.next()) {
+        engines.push_back(it.thisNode());
+    }
+
+    m_engines.resize(engines.size());
+    for (size_t i = 0; i < engines.size(); ++i) {
+        m_engines[i].engine = MObjectHandle(engines[i]);
+        m_engineLookup.emplace(m_engines[i].engine.hashCode(), i);
+    }
+
+    // Each mesh's assignment is read once and split between its engines
+    std::vector<MDagPath> meshes;
+    ExtraAttrShading::findMemberMeshes(engines, meshes);
+    for (const MDagPath& meshPath : meshes) {
+        readMesh(meshPath, nullptr);
+    }
+
+    m_valid = true;
+    installCallbacks();
+}
+
+void ExtraAttrShadingIndex::readMesh(const MDagPath& meshPath, EngineEntry* onlyEntry)
+{
+    MStatus status;
+    MFnMesh fnMesh(meshPath, &status);
+    if (status != MS::kSuccess) {
+        return;
+    }
+
+    MObjectArray shaders;
+    MIntArray shaderIndices;
+    if (fnMesh.getConnectedShaders(meshPath.instanceNumber(), shaders, shaderIndices) != MS::kSuccess) {
+        return;
+    }
+
+    int faceCount = static_cast<int>(shaderIndices.length());
+    std::vector<EngineEntry*> slotEntries(shaders.length(), nullptr);
+    std::vector<MeshFaces> slotFaces(shaders.length());
+    bool anyEntry = false;
+    for (unsigned int slot = 0; slot < shaders.length(); ++slot) {
+        EngineEntry* entry = findEngine(shaders[slot]);
+        if (entry == nullptr || (onlyEntry != nullptr && entry != onlyEntry)) {
+            continue;
+        }
+
+        slotEntries[slot] = entry;
+        slotFaces[slot].meshPath = meshPath;
+        slotFaces[slot].mesh = MObjectHandle(meshPath.node());
+        slotFaces[slot].bits.assign(wordCount(faceCount), 0);
+        slotFaces[slot].faceCount = faceCount;
+        anyEntry = true;
+    }
+    if (!anyEntry) {
+        return;
+    }
+
+    for (int face = 0; face < faceCount; ++face) {
+        int slot = shaderIndices[face];
+        if (slot < 0 || slotEntries[slot] == nullptr) {
+            continue;
+        }
+        slotFaces[slot].bits[face / kBitsPerWord] |= uint64_t(1) << (face % kBitsPerWord);
+        slotFaces[slot].assignedCount++;
+    }
+
+    for (size_t slot = 0; slot < slotFaces.size(); ++slot) {
+        if (slotEntries[slot] != nullptr && slotFaces[slot].assignedCount > 0) {
+            slotEntries[slot]->meshes.push_back(std::move(slotFaces[slot]));
+        }
+    }
+}
+
+void ExtraAttrShadingIndex::refreshEngine(EngineEntry& entry)
+{
+    entry.meshes.clear();
+    entry.dirty = false;
+    entry.statsValid = false;
+
+    std::vector<MDagPath> meshes;
+    ExtraAttrShading::findMemberMeshes(std::vector<MObject>(1, entry.engine.object()), meshes);
+    for (const MDagPath& meshPath : meshes) {
+        readMesh(meshPath, &entry);
+    }
+}
+
+bool ExtraAttrShadingIndex::isStale(const EngineEntry& entry) const
+{
+    // Topology edits keep the membership but renumber faces
+    MStatus status;
+    for (const MeshFaces& mesh : entry.meshes) {
+        if (!mesh.mesh.isValid() || !mesh.meshPath.isValid()) {
+            return true;
+        }
+
+        MFnMesh fnMesh(mesh.meshPath, &status);
+        if (status != MS::kSuccess || fnMesh.numPolygons() != mesh.faceCount) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ExtraAttrShadingIndex::hasCurrentStats(const EngineEntry& entry) const
+{
+    if (!entry.statsValid || entry.statsMatrices.size() != entry.meshes.size()) {
+        return false;
+    }
+
+    // Areas are measured in world space, so a moved instance needs measuring again
+    for (size_t i = 0; i < entry.meshes.size(); ++i) {
+        if (!(entry.meshes[i].meshPath.inclusiveMatrix() == entry.statsMatrices[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ExtraAttrShadingIndex::EngineEntry* ExtraAttrShadingIndex::findEngine(const MObject& engine)
+{
+    MObjectHandle handle(engine);
+    auto range = m_engineLookup.equal_range(handle.hashCode());
+    for (auto it = range.first; it != range.second; ++it) {
+        if (m_engines[it->second].engine == handle) {
+            return &m_engines[it->second];
+        }
+    }
+    return nullptr;
+}
+
+ExtraAttrShadingIndex::EngineEntry* ExtraAttrShadingIndex::getEngine(const MObject& engine)
+{
+    if (!m_valid) {
+        build();
+    }
+
+    EngineEntry* entry = findEngine(engine);
+    if (entry != nullptr && (entry->dirty || isStale(*entry))) {
+        refreshEngine(*entry);
+    }
+    return entry;
+}
+
+void ExtraAttrShadingIndex::installCallbacks()
+{
+    MStatus status;
+    for (EngineEntry& entry : m_engines) {
+        MObject engine = entry.engine.object();
+        MCallbackId callbackId =
+            MObjectSetMessage::addSetMembersModifiedCallback(engine, setMembersCallback, this, &status);
+        if (status == MS::kSuccess) {
+            m_callbackIds.append(callbackId);
+        }
+    }
+
+    MCallbackId callbackId = MDGMessage::addConnectionCallback(connectionCallback, this, &status);
+    if (status == MS::kSuccess) {
+        m_callbackIds.append(callbackId);
+    }
+
+    callbackId = MDGMessage::addNodeAddedCallback(engineAddedRemovedCallback, "shadingEngine", this, &status);
+    if (status == MS::kSuccess) {
+        m_callbackIds.append(callbackId);
+    }
+
+    callbackId = MDGMessage::addNodeRemovedCallback(engineAddedRemovedCallback, "shadingEngine", this, &status);
+    if (status == MS::kSuccess) {
+        m_callbackIds.append(callbackId);
+    }
+
+    callbackId = MSceneMessage::addCallback(MSceneMessage::kAfterNew, sceneCallback, this, &status);
+    if (status == MS::kSuccess) {
+        m_callbackIds.append(callbackId);
+    }
+
+    callbackId = MSceneMessage::addCallback(MSceneMessage::kAfterOpen, sceneCallback, this, &status);
+    if (status == MS::kSuccess) {
+        m_callbackIds.append(callbackId);
+    }
+}
+
+void ExtraAttrShadingIndex::removeCallbacks()
+{
+    if (m_callbackIds.length() > 0) {
+        MMessage::removeCallbacks(m_callbackIds);
+        m_callbackIds.clear();
+    }
+}
+
+void ExtraAttrShadingIndex::setMembersCallback(MObject& node, void* clientData)
+{
+    ExtraAttrShadingIndex* index = static_cast<ExtraAttrShadingIndex*>(clientData);
+    EngineEntry* entry = index->findEngine(node);
+    if (entry != nullptr) {
+        entry->dirty = true;
+    }
+}
+
+void ExtraAttrShadingIndex::connectionCallback(MPlug& srcPlug, MPlug& destPlug, bool made, void* clientData)
+{
+    (void)made;
+
+    // Members are connected to an engine's dagSetMembers, so only engine-side plugs matter
+    ExtraAttrShadingIndex* index = static_cast<ExtraAttrShadingIndex*>(clientData);
+    MObject nodes[2] = {destPlug.node(), srcPlug.node()};
+    for (const MObject& node : nodes) {
+        if (!node.hasFn(MFn::kShadingEngine)) {
+            continue;
+        }
+        EngineEntry* entry = index->findEngine(node);
+        if (entry != nullptr) {
+            entry->dirty = true;
+        }
+    }
+}
+
+void ExtraAttrShadingIndex::engineAddedRemovedCallback(MObject& node, void* clientData)
+{
+    (void)node;
+
+    // Rebuilt on next use; callbacks are not removed from inside a callback
+    static_cast<ExtraAttrShadingIndex*>(clientData)->m_valid = false;
+}
+
+void ExtraAttrShadingIndex::sceneCallback(void* clientData)
+{
+    static_cast<ExtraAttrShadingIndex*>(clientData)->m_valid = false;
+}
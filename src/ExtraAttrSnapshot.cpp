@@ -0,0 +1,154 @@
+#include "ExtraAttrSnapshot.h"
+#include <maya/MFnDagNode.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 64-bit FNV-1a hash of a null-terminated string
+uint64_t hashString(const char* str)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char* p = reinterpret_cast<const unsigned char*>(str); *p; ++p) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Named snapshots kept for the session
+std::map<MString, std::shared_ptr<ExtraAttrSnapshot>, MStringLess>& snapshotRegistry()
+{
+    static std::map<MString, std::shared_ptr<ExtraAttrSnapshot>, MStringLess> s_registry;
+    return s_registry;
+}
+
+// Unique name of a node: the full path for DAG nodes, else the node name
+MString uniqueNodeName(const NodeAttributeValue& nodeValue)
+{
+    if (nodeValue.nodeObj.hasFn(MFn::kDagNode)) {
+        MStatus status;
+        MFnDagNode fnDag(nodeValue.nodeObj, &status);
+        if (status == MS::kSuccess) {
+            MString path = fnDag.fullPathName(&status);
+            if (status == MS::kSuccess && path.length() > 0) {
+                return path;
+            }
+        }
+    }
+    return nodeValue.nodeName;
+}
+
+} // namespace
+
+ExtraAttrSnapshot::ExtraAttrSnapshot()
+{
+}
+
+std::shared_ptr<ExtraAttrSnapshot> ExtraAttrSnapshot::capture(const ExtraAttrScanner& scanner)
+{
+    auto snapshot = std::make_shared<ExtraAttrSnapshot>();
+
+    const auto& attrMap = scanner.getAttributeInfoMap();
+    for (const auto& pair : attrMap) {
+        // Attribute definition entry
+        snapshot->addEntry(pair.first.asChar(), pair.second->typeName.asChar());
+
+        // One entry per node using the attribute
+        std::vector<NodeAttributeValue> nodeValues = scanner.getNodesWithAttribute(pair.first);
+        for (const auto& nodeValue : nodeValues) {
+            MString key = uniqueNodeName(nodeValue) + "." + pair.first;
+            snapshot->addEntry(key.asChar(), nodeValue.valueStr.asChar());
+        }
+    }
+
+    const ExtraAttrSnapshot& self = *snapshot;
+    std::sort(snapshot->m_entries.begin(), snapshot->m_entries.end(), [&self](const Entry& a, const Entry& b) {
+        return compareKeys(self, a, self, b) < 0;
+    });
+
+    snapshot->m_entries.shrink_to_fit();
+    snapshot->m_keys.shrink_to_fit();
+    return snapshot;
+}
+
+void ExtraAttrSnapshot::diff(const ExtraAttrSnapshot& before, const ExtraAttrSnapshot& after, MStringArray& outLines)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+    // Sorted merge: each entry of both snapshots is visited once
+    while (i < before.m_entries.size() && j < after.m_entries.size()) {
+        const Entry& a = before.m_entries[i];
+        const Entry& b = after.m_entries[j];
+
+        int cmp = compareKeys(before, a, after, b);
+        if (cmp < 0) {
+            outLines.append(MString("- ") + before.keyOf(a));
+            ++i;
+        } else if (cmp > 0) {
+            outLines.append(MString("+ ") + after.keyOf(b));
+            ++j;
+        } else {
+            if (a.valueHash != b.valueHash) {
+                outLines.append(MString("~ ") + after.keyOf(b));
+            }
+            ++i;
+            ++j;
+        }
+    }
+
+    for (; i < before.m_entries.size(); ++i) {
+        outLines.append(MString("- ") + before.keyOf(before.m_entries[i]));
+    }
+
+    for (; j < after.m_entries.size(); ++j) {
+        outLines.append(MString("+ ") + after.keyOf(after.m_entries[j]));
+    }
+}
+
+void ExtraAttrSnapshot::store(const MString& name, const std::shared_ptr<ExtraAttrSnapshot>& snapshot)
+{
+    snapshotRegistry()[name] = snapshot;
+}
+
+std::shared_ptr<ExtraAttrSnapshot> ExtraAttrSnapshot::find(const MString& name)
+{
+    auto& registry = snapshotRegistry();
+    auto it = registry.find(name);
+    if (it == registry.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+size_t ExtraAttrSnapshot::entryCount() const
+{
+    return m_entries.size();
+}
+
+void ExtraAttrSnapshot::addEntry(const char* key, const char* value)
+{
+    Entry entry;
+    entry.keyHash = hashString(key);
+    entry.valueHash = hashString(value);
+    entry.keyOffset = static_cast<uint32_t>(m_keys.size());
+    m_entries.push_back(entry);
+
+    m_keys.insert(m_keys.end(), key, key + strlen(key) + 1);
+}
+
+const char* ExtraAttrSnapshot::keyOf(const Entry& entry) const
+{
+    return m_keys.data() + entry.keyOffset;
+}
+
+int ExtraAttrSnapshot::compareKeys(const ExtraAttrSnapshot& a, const Entry& ea,
+                                   const ExtraAttrSnapshot& b, const Entry& eb)
+{
+    if (ea.keyHash != eb.keyHash) {
+        return (ea.keyHash < eb.keyHash) ? -1 : 1;
+    }
+    // Only reached for equal hashes, which are almost always equal keys
+    return strcmp(a.keyOf(ea), b.keyOf(eb));
+}
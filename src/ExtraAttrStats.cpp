@@ -0,0 +1,166 @@
+#include "ExtraAttrStats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace ExtraAttrStats {
+
+namespace {
+
+// Independent accumulators per loop so the compiler can keep them in vector lanes
+const size_t kLanes = 4;
+
+// Above this magnitude, sums and ranges could overflow, so values are scaled down by a power of two
+const double kLargeMagnitude = 0x1p960;
+
+void computeMinMax(const double* values, size_t count, double& outMin, double& outMax)
+{
+    double mn[kLanes], mx[kLanes];
+    for (size_t l = 0; l < kLanes; ++l) {
+        mn[l] = values[0];
+        mx[l] = values[0];
+    }
+
+    size_t i = 0;
+    for (; i + kLanes <= count; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            double v = values[i + l];
+            mn[l] = v < mn[l] ? v : mn[l];
+            mx[l] = v > mx[l] ? v : mx[l];
+        }
+    }
+    for (; i < count; ++i) {
+        mn[0] = values[i] < mn[0] ? values[i] : mn[0];
+        mx[0] = values[i] > mx[0] ? values[i] : mx[0];
+    }
+
+    outMin = *std::min_element(mn, mn + kLanes);
+    outMax = *std::max_element(mx, mx + kLanes);
+}
+
+// Sum of the values, each multiplied by scale (a power of two, so the products are exact)
+double computeSum(const double* values, size_t count, double scale)
+{
+    double acc[kLanes] = {0.0, 0.0, 0.0, 0.0};
+
+    size_t i = 0;
+    for (; i + kLanes <= count; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            acc[l] += values[i + l] * scale;
+        }
+    }
+    for (; i < count; ++i) {
+        acc[0] += values[i] * scale;
+    }
+
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+// Sum of squared deviations from the mean (second pass for numerical stability), in scaled values
+double computeSquaredDeviation(const double* values, size_t count, double scaledMean, double scale)
+{
+    double acc[kLanes] = {0.0, 0.0, 0.0, 0.0};
+
+    size_t i = 0;
+    for (; i + kLanes <= count; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            double d = values[i + l] * scale - scaledMean;
+            acc[l] += d * d;
+        }
+    }
+    for (; i < count; ++i) {
+        double d = values[i] * scale - scaledMean;
+        acc[0] += d * d;
+    }
+
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+void computeHistogram(const double* values, size_t count, double minValue, double maxValue, double scale,
+                      std::vector<size_t>& histogram)
+{
+    size_t binCount = histogram.size();
+    double scaledMin = minValue * scale;
+    double range = maxValue * scale - scaledMin;
+    double binScale = static_cast<double>(binCount) / range;
+    if (!(range > 0.0) || !std::isfinite(binScale)) {
+        // All values equal, or too close together to tell apart
+        histogram[0] = count;
+        return;
+    }
+
+    // Compute bin indices in a branch-free pass, then count them; the bin is
+    // clamped as a double so rounding at either end never reaches the cast
+    double lastBin = static_cast<double>(binCount - 1);
+    std::vector<int32_t> bins(count);
+    for (size_t i = 0; i < count; ++i) {
+        double bin = (values[i] * scale - scaledMin) * binScale;
+        bin = bin >= 0.0 ? bin : 0.0;
+        bin = bin < lastBin ? bin : lastBin;
+        bins[i] = static_cast<int32_t>(bin);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        histogram[bins[i]]++;
+    }
+}
+
+} // namespace
+
+ValueStatistics computeValueStatistics(const double* values, size_t count, int binCount)
+{
+    ValueStatistics stats;
+    if (!values || count == 0) {
+        return stats;
+    }
+
+    // The kernels assume finite values; copy only if there is anything to drop
+    std::vector<double> finite;
+    size_t firstNonFinite = 0;
+    while (firstNonFinite < count && std::isfinite(values[firstNonFinite])) {
+        ++firstNonFinite;
+    }
+    if (firstNonFinite < count) {
+        finite.reserve(count);
+        finite.assign(values, values + firstNonFinite);
+        for (size_t i = firstNonFinite; i < count; ++i) {
+            if (std::isfinite(values[i])) {
+                finite.push_back(values[i]);
+            }
+        }
+        stats.skippedCount = count - finite.size();
+        values = finite.data();
+        count = finite.size();
+        if (count == 0) {
+            return stats;
+        }
+    }
+
+    stats.count = count;
+    computeMinMax(values, count, stats.minValue, stats.maxValue);
+
+    // Very large values are scaled into [-1, 1] so sums and the range stay finite
+    double maxMagnitude = std::max(std::abs(stats.minValue), std::abs(stats.maxValue));
+    int exponent = 0;
+    if (maxMagnitude > kLargeMagnitude) {
+        std::frexp(maxMagnitude, &exponent);
+    }
+    double scale = std::ldexp(1.0, -exponent);
+
+    double scaledMean = computeSum(values, count, scale) / static_cast<double>(count);
+    double scaledDeviation = computeSquaredDeviation(values, count, scaledMean, scale);
+    stats.mean = std::ldexp(scaledMean, exponent);
+    stats.stddev = std::ldexp(std::sqrt(scaledDeviation / static_cast<double>(count)), exponent);
+
+    stats.histogram.assign(static_cast<size_t>(std::max(binCount, 1)), 0);
+    computeHistogram(values, count, stats.minValue, stats.maxValue, scale, stats.histogram);
+
+    // Distinct values: sort a copy and count runs
+    std::vector<double> sorted(values, values + count);
+    std::sort(sorted.begin(), sorted.end());
+    stats.distinctCount = static_cast<size_t>(std::unique(sorted.begin(), sorted.end()) - sorted.begin());
+
+    return stats;
+}
+
+} // namespace ExtraAttrStats
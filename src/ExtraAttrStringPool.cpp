@@ -0,0 +1,144 @@
+#include "ExtraAttrStringPool.h"
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// Initial number of hash slots (a power of two)
+const size_t kInitialSlotCount = 64;
+
+// IDs not yet assigned during compaction
+const uint32_t kUnassignedId = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+ExtraAttrStringPool::ExtraAttrStringPool()
+{
+}
+
+void ExtraAttrStringPool::clear()
+{
+    m_entries.clear();
+    m_text.clear();
+    m_slots.clear();
+}
+
+void ExtraAttrStringPool::reserve(size_t stringCount, size_t textBytes)
+{
+    m_entries.reserve(stringCount);
+    m_text.reserve(textBytes);
+
+    // Keep the table at most half full
+    size_t slotCount = kInitialSlotCount;
+    while (slotCount < stringCount * 2) {
+        slotCount *= 2;
+    }
+    if (slotCount > m_slots.size()) {
+        rehash(slotCount);
+    }
+}
+
+uint32_t ExtraAttrStringPool::intern(const char* text, size_t length)
+{
+    if ((m_entries.size() + 1) * 2 > m_slots.size()) {
+        rehash(m_slots.empty() ? kInitialSlotCount : m_slots.size() * 2);
+    }
+
+    uint32_t hash = hashBytes(text, length);
+    size_t mask = m_slots.size() - 1;
+    size_t slot = hash & mask;
+
+    while (m_slots[slot] != 0) {
+        const Entry& entry = m_entries[m_slots[slot] - 1];
+        if (entry.hash == hash && entry.length == length && memcmp(m_text.data() + entry.offset, text, length) == 0) {
+            return m_slots[slot] - 1;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    Entry entry;
+    entry.offset = static_cast<uint32_t>(m_text.size());
+    entry.length = static_cast<uint32_t>(length);
+    entry.hash = hash;
+    m_text.append(text, length);
+    m_text.push_back('\0');
+
+    uint32_t id = static_cast<uint32_t>(m_entries.size());
+    m_entries.push_back(entry);
+    m_slots[slot] = id + 1;
+    return id;
+}
+
+uint32_t ExtraAttrStringPool::intern(const char* text)
+{
+    return intern(text, strlen(text));
+}
+
+const char* ExtraAttrStringPool::text(uint32_t id) const
+{
+    return m_text.data() + m_entries[id].offset;
+}
+
+size_t ExtraAttrStringPool::length(uint32_t id) const
+{
+    return m_entries[id].length;
+}
+
+size_t ExtraAttrStringPool::size() const
+{
+    return m_entries.size();
+}
+
+void ExtraAttrStringPool::compact(const std::vector<std::vector<uint32_t>*>& idColumns)
+{
+    // Old ID -> new ID, assigned in order of first use
+    std::vector<uint32_t> newIds(m_entries.size(), kUnassignedId);
+    std::vector<Entry> entries;
+    std::string text;
+
+    for (std::vector<uint32_t>* column : idColumns) {
+        for (uint32_t& id : *column) {
+            if (newIds[id] == kUnassignedId) {
+                Entry entry = m_entries[id];
+                newIds[id] = static_cast<uint32_t>(entries.size());
+                entry.offset = static_cast<uint32_t>(text.size());
+                text.append(m_text, m_entries[id].offset, entry.length + 1);
+                entries.push_back(entry);
+            }
+            id = newIds[id];
+        }
+    }
+
+    m_entries.swap(entries);
+    m_text.swap(text);
+
+    size_t slotCount = kInitialSlotCount;
+    while (slotCount < m_entries.size() * 2) {
+        slotCount *= 2;
+    }
+    rehash(slotCount);
+}
+
+uint32_t ExtraAttrStringPool::hashBytes(const char* text, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void ExtraAttrStringPool::rehash(size_t slotCount)
+{
+    m_slots.assign(slotCount, 0);
+    size_t mask = slotCount - 1;
+
+    for (size_t id = 0; id < m_entries.size(); ++id) {
+        size_t slot = m_entries[id].hash & mask;
+        while (m_slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot] = static_cast<uint32_t>(id) + 1;
+    }
+}
@@ -0,0 +1,273 @@
+#include "ExtraAttrTrigramIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <regex>
+
+namespace {
+
+/**
+ * @brief Count the characters after an escape letter that belong to the same escape
+ *
+ * Covers \xhh, \uhhhh, \cX and \0 followed by octal digits; other escapes are one letter.
+ *
+ * @param letter Position of the letter following the backslash
+ */
+size_t escapeOperandLength(const std::string& pattern, size_t letter)
+{
+    size_t available = pattern.size() - letter - 1;
+    switch (pattern[letter]) {
+        case 'x':
+            return std::min<size_t>(2, available);
+        case 'u':
+            return std::min<size_t>(4, available);
+        case 'c':
+            return std::min<size_t>(1, available);
+        case '0': {
+            size_t length = 0;
+            while (length < available && std::isdigit(static_cast<unsigned char>(pattern[letter + 1 + length]))) {
+                ++length;
+            }
+            return length;
+        }
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+ExtraAttrTrigramIndex::ExtraAttrTrigramIndex()
+{
+}
+
+void ExtraAttrTrigramIndex::clear()
+{
+    m_texts.clear();
+    m_postings.clear();
+}
+
+void ExtraAttrTrigramIndex::reserve(size_t documentCount)
+{
+    m_texts.reserve(documentCount);
+}
+
+uint32_t ExtraAttrTrigramIndex::add(const std::string& text)
+{
+    uint32_t id = static_cast<uint32_t>(m_texts.size());
+    m_texts.push_back(foldCase(text));
+
+    const std::string& folded = m_texts.back();
+    for (size_t i = 0; i + 3 <= folded.size(); ++i) {
+        std::vector<uint32_t>& ids = m_postings[trigramKey(folded.data() + i)];
+        // IDs only grow, so a repeated trigram in the same document is always at the back
+        if (ids.empty() || ids.back() != id) {
+            ids.push_back(id);
+        }
+    }
+
+    return id;
+}
+
+size_t ExtraAttrTrigramIndex::size() const
+{
+    return m_texts.size();
+}
+
+void ExtraAttrTrigramIndex::findSubstring(const std::string& needle, std::vector<uint32_t>& outIds) const
+{
+    outIds.clear();
+
+    std::string folded = foldCase(needle);
+    std::vector<uint32_t> candidates;
+    findCandidates(std::vector<std::string>(1, folded), candidates);
+
+    // Trigrams only guarantee the pieces are present, not that they are adjacent
+    for (uint32_t id : candidates) {
+        if (m_texts[id].find(folded) != std::string::npos) {
+            outIds.push_back(id);
+        }
+    }
+}
+
+bool ExtraAttrTrigramIndex::findRegex(const std::string& pattern, std::vector<uint32_t>& outIds) const
+{
+    outIds.clear();
+
+    std::regex regex;
+    try {
+        regex.assign(pattern, std::regex::ECMAScript | std::regex::icase | std::regex::optimize);
+    } catch (const std::regex_error&) {
+        return false;
+    }
+
+    std::vector<std::string> literals;
+    std::vector<uint32_t> candidates;
+    if (!extractRequiredLiterals(pattern, literals)) {
+        literals.clear();
+    }
+    findCandidates(literals, candidates);
+
+    for (uint32_t id : candidates) {
+        if (std::regex_search(m_texts[id], regex)) {
+            outIds.push_back(id);
+        }
+    }
+    return true;
+}
+
+void ExtraAttrTrigramIndex::findCandidates(const std::vector<std::string>& literals,
+                                           std::vector<uint32_t>& outIds) const
+{
+    outIds.clear();
+
+    // Gather the posting lists of every required trigram
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (const std::string& literal : literals) {
+        for (size_t i = 0; i + 3 <= literal.size(); ++i) {
+            auto it = m_postings.find(trigramKey(literal.data() + i));
+            if (it == m_postings.end()) {
+                // A required trigram occurs nowhere
+                return;
+            }
+            lists.push_back(&it->second);
+        }
+    }
+
+    if (lists.empty()) {
+        // Too short to narrow: every document is a candidate
+        outIds.resize(m_texts.size());
+        for (uint32_t id = 0; id < outIds.size(); ++id) {
+            outIds[id] = id;
+        }
+        return;
+    }
+
+    // Intersect starting from the shortest list so the working set stays small
+    std::sort(lists.begin(), lists.end(), [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) {
+        return a->size() < b->size();
+    });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+    outIds = *lists[0];
+    std::vector<uint32_t> merged;
+    for (size_t i = 1; i < lists.size() && !outIds.empty(); ++i) {
+        merged.clear();
+        std::set_intersection(outIds.begin(), outIds.end(), lists[i]->begin(), lists[i]->end(),
+                              std::back_inserter(merged));
+        outIds.swap(merged);
+    }
+}
+
+bool ExtraAttrTrigramIndex::extractRequiredLiterals(const std::string& pattern, std::vector<std::string>& outLiterals)
+{
+    std::string current;
+    int depth = 0;
+
+    auto flush = [&]() {
+        if (current.size() >= 3) {
+            outLiterals.push_back(current);
+        }
+        current.clear();
+    };
+
+    // Conservative scan: only plain characters outside groups and classes
+    // that are not made optional by a quantifier count as required
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+
+        switch (c) {
+            case '\\':
+                if (i + 1 < pattern.size() && depth == 0 &&
+                    !std::isalnum(static_cast<unsigned char>(pattern[i + 1]))) {
+                    // Escaped punctuation is a literal character
+                    current += pattern[++i];
+                } else {
+                    // Character class or code escape (\d, \w, \x41, ...) or escape inside a group;
+                    // the characters it consumes are not literals
+                    flush();
+                    ++i;
+                    if (i < pattern.size()) {
+                        i += escapeOperandLength(pattern, i);
+                    }
+                }
+                break;
+
+            case '[':
+                flush();
+                // Skip to the end of the bracket expression
+                for (++i; i < pattern.size() && pattern[i] != ']'; ++i) {
+                    if (pattern[i] == '\\') {
+                        ++i;
+                    }
+                }
+                break;
+
+            case '(':
+                flush();
+                ++depth;
+                break;
+
+            case ')':
+                flush();
+                --depth;
+                break;
+
+            case '|':
+                if (depth == 0) {
+                    // Either side may match, so nothing is required
+                    outLiterals.clear();
+                    return false;
+                }
+                break;
+
+            case '*':
+            case '?':
+            case '{':
+                // The preceding character may be absent
+                if (!current.empty()) {
+                    current.pop_back();
+                }
+                flush();
+                if (c == '{') {
+                    while (i < pattern.size() && pattern[i] != '}') {
+                        ++i;
+                    }
+                }
+                break;
+
+            case '+':
+            case '.':
+            case '^':
+            case '$':
+                flush();
+                break;
+
+            default:
+                if (depth == 0) {
+                    current += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                }
+                break;
+        }
+    }
+
+    flush();
+    return true;
+}
+
+std::string ExtraAttrTrigramIndex::foldCase(const std::string& text)
+{
+    std::string folded(text);
+    for (char& c : folded) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return folded;
+}
+
+uint32_t ExtraAttrTrigramIndex::trigramKey(const char* p)
+{
+    return (static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(p[2]));
+}
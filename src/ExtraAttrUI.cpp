@@ -1,10 +1,17 @@
 ﻿#include "ExtraAttrUI.h"
 #include "MayaUtils.h"
+#include "ExtraAttrStats.h"
+#include "ExtraAttrShading.h"
+#include "ExtraAttrShadingIndex.h"
+#include "ExtraAttrValueCodec.h"
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QProgressDialog>
 #include <QApplication>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
 #include <maya/MQtUtil.h>
 #include <maya/MGlobal.h>
 #include <maya/MSelectionList.h>
@@ -14,6 +21,8 @@
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MFnEnumAttribute.h>
 #include <maya/MFnNumericData.h>
+#include <maya/MDGModifier.h>
+#include <maya/MStringArray.h>
 
 // ========== EnumAttributeDelegate Implementation ==========
 
@@ -161,7 +170,7 @@ ExtraAttrUI* ExtraAttrUI::s_instance = nullptr;
 
 ExtraAttrUI::ExtraAttrUI(QWidget* parent)
     : QMainWindow(parent)
-    , m_scanner(new ExtraAttrScanner())
+    , m_scanner(&ExtraAttrScanner::sharedIndex())
 {
     setupUI();
 }
@@ -233,9 +242,8 @@ void ExtraAttrUI::setupUI()
     m_attributeModel = new ExtraAttrModel(this);
 
     // Use proxy model for filtering and sorting
-    m_attributeProxyModel = new QSortFilterProxyModel(this);
+    m_attributeProxyModel = new ExtraAttrProxyModel(this);
     m_attributeProxyModel->setSourceModel(m_attributeModel);
-    m_attributeProxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
     m_attributeProxyModel->setFilterKeyColumn(ExtraAttrModel::COL_ATTR_NAME);
 
     m_attributeTableView->setModel(m_attributeProxyModel);
@@ -296,15 +304,50 @@ void ExtraAttrUI::setupUI()
     nodeFilterLayout->addWidget(m_filterNodeTypeRadio);
     nodeFilterLayout->addWidget(m_filterValueRadio);
 
+    // Plug flag filter: each flag can be required or excluded
+    m_plugFlagButton = new QToolButton();
+    m_plugFlagButton->setText("Flags");
+    m_plugFlagButton->setFont(radioFont);
+    m_plugFlagButton->setPopupMode(QToolButton::InstantPopup);
+    QMenu* plugFlagMenu = new QMenu(m_plugFlagButton);
+
+    static const struct {
+        unsigned int flag;
+        const char* requireLabel;
+        const char* excludeLabel;
+    } kPlugFlagLabels[] = {
+        {MayaUtils::kPlugConnected, "Connected", "Not Connected"},
+        {MayaUtils::kPlugAnimated, "Animated", "Not Animated"},
+        {MayaUtils::kPlugLocked, "Locked", "Unlocked"},
+        {MayaUtils::kPlugKeyable, "Keyable", "Not Keyable"},
+        {MayaUtils::kPlugDefault, "Default Value", "Non-Default Value"},
+    };
+
+    plugFlagMenu->addSection("Only");
+    for (const auto& label : kPlugFlagLabels) {
+        QAction* action = plugFlagMenu->addAction(label.requireLabel);
+        action->setCheckable(true);
+        action->setData(label.flag);
+        m_requireFlagActions.push_back(action);
+    }
+    plugFlagMenu->addSection("Exclude");
+    for (const auto& label : kPlugFlagLabels) {
+        QAction* action = plugFlagMenu->addAction(label.excludeLabel);
+        action->setCheckable(true);
+        action->setData(label.flag);
+        m_excludeFlagActions.push_back(action);
+    }
+    m_plugFlagButton->setMenu(plugFlagMenu);
+    nodeFilterLayout->addWidget(m_plugFlagButton);
+
     rightLayout->addLayout(nodeFilterLayout);
 
     m_nodeTableView = new QTableView();
     m_nodeModel = new NodeAttributeModel(this);
 
     // Use proxy model for filtering and sorting
-    m_nodeProxyModel = new QSortFilterProxyModel(this);
+    m_nodeProxyModel = new ExtraAttrProxyModel(this);
     m_nodeProxyModel->setSourceModel(m_nodeModel);
-    m_nodeProxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
     m_nodeProxyModel->setFilterKeyColumn(NodeAttributeModel::COL_NODE_NAME);  // Default is Node Name
 
     m_nodeTableView->setModel(m_nodeProxyModel);
@@ -322,6 +365,14 @@ void ExtraAttrUI::setupUI()
     m_nodeTableView->setItemDelegate(new EnumAttributeDelegate(this));
 
     rightLayout->addWidget(m_nodeTableView);
+
+    // Value statistics for numeric attributes
+    m_valueStatsLabel = new QLabel();
+    m_valueStatsLabel->setFont(labelFont);
+    m_valueStatsLabel->setMaximumHeight(20);
+    m_valueStatsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    rightLayout->addWidget(m_valueStatsLabel);
+
     splitter->addWidget(rightWidget);
 
     // Splitter size ratio (50/50)
@@ -337,6 +388,7 @@ void ExtraAttrUI::setupUI()
     connect(m_nodeFilterLineEdit, &QLineEdit::textChanged, this, &ExtraAttrUI::onNodeFilterChanged);
     connect(m_filterButtonGroup, &QButtonGroup::buttonClicked,
             [this]() { onNodeFilterChanged(m_nodeFilterLineEdit->text()); });
+    connect(plugFlagMenu, &QMenu::triggered, this, &ExtraAttrUI::onPlugFlagFilterChanged);
 
     connect(m_attributeTableView->selectionModel(), &QItemSelectionModel::currentChanged,
             this, &ExtraAttrUI::onAttributeSelectionChanged);
@@ -373,6 +425,13 @@ QWidget* ExtraAttrUI::createToolBar()
     return toolbar;
 }
 
+void ExtraAttrUI::notifyIndexChanged()
+{
+    if (s_instance) {
+        s_instance->reloadFromIndex();
+    }
+}
+
 void ExtraAttrUI::showUI()
 {
     show();
@@ -393,9 +452,6 @@ void ExtraAttrUI::closeEvent(QCloseEvent* event)
 
 void ExtraAttrUI::onScanButtonClicked()
 {
-    // Preserve current selection
-    QString currentAttr = m_currentAttributeName;
-
     // Show progress dialog
     QProgressDialog progress("Scanning scene for extra attributes...", "Cancel", 0, 0, this);
     progress.setWindowModality(Qt::WindowModal);
@@ -404,7 +460,8 @@ void ExtraAttrUI::onScanButtonClicked()
 
     QApplication::processEvents();
 
-    // Scan scene
+    // Scan scene; mesh statistics are measured again as well, since point edits leave them cached
+    ExtraAttrShadingIndex::sharedIndex().invalidateMeshStats();
     bool success = m_scanner->scanScene();
 
     if (!success) {
@@ -412,6 +469,16 @@ void ExtraAttrUI::onScanButtonClicked()
         return;
     }
 
+    reloadFromIndex();
+
+    progress.setValue(100);
+}
+
+void ExtraAttrUI::reloadFromIndex()
+{
+    // Preserve current selection
+    QString currentAttr = m_currentAttributeName;
+
     // Load data into model
     m_attributeModel->loadFromScanner(*m_scanner);
 
@@ -422,22 +489,32 @@ void ExtraAttrUI::onScanButtonClicked()
     m_attributeTableView->sortByColumn(ExtraAttrModel::COL_ATTR_NAME, Qt::AscendingOrder);
 
     // Restore selection if attribute still exists
-    if (!currentAttr.isEmpty()) {
+    bool restored = false;
+    QModelIndex currentIndex = m_attributeTableView->currentIndex();
+    if (!currentAttr.isEmpty() && currentIndex.isValid() &&
+        m_attributeModel->getAttributeName(m_attributeProxyModel->mapToSource(currentIndex).row()) == currentAttr) {
+        // The model kept the row, so the selection did not change; update the node table in place
+        refreshNodeValues();
+        restored = true;
+    } else if (!currentAttr.isEmpty()) {
         for (int i = 0; i < m_attributeProxyModel->rowCount(); ++i) {
             QModelIndex proxyIndex = m_attributeProxyModel->index(i, 0);
             QModelIndex sourceIndex = m_attributeProxyModel->mapToSource(proxyIndex);
             if (m_attributeModel->getAttributeName(sourceIndex.row()) == currentAttr) {
                 m_attributeTableView->selectRow(i);
+                restored = true;
                 break;
             }
         }
-    } else {
+    }
+
+    if (!restored) {
         // Clear right side table if no selection
         m_nodeModel->clear();
+        m_nodeValues.clear();
         m_currentAttributeName.clear();
+        updateValueStatistics();
     }
-
-    progress.setValue(100);
 }
 
 void ExtraAttrUI::onAttributeSelectionChanged(const QModelIndex& current, const QModelIndex& previous)
@@ -446,6 +523,9 @@ void ExtraAttrUI::onAttributeSelectionChanged(const QModelIndex& current, const
 
     if (!current.isValid()) {
         m_nodeModel->clear();
+        m_nodeValues.clear();
+        m_currentAttributeName.clear();
+        updateValueStatistics();
         return;
     }
 
@@ -460,17 +540,70 @@ void ExtraAttrUI::onAttributeSelectionChanged(const QModelIndex& current, const
 
     m_currentAttributeName = attrName;
 
-    // Get list of nodes with this attribute
-    MString mayaAttrName(attrName.toUtf8().constData());
-    std::vector<NodeAttributeValue> nodeValues = m_scanner->getNodesWithAttribute(mayaAttrName);
-
-    // Set to node model
-    m_nodeModel->setNodeValues(attrName, nodeValues);
+    refreshNodeValues();
 
     // Set default sort to ascending order by NodeName column
     m_nodeTableView->sortByColumn(NodeAttributeModel::COL_NODE_NAME, Qt::AscendingOrder);
 }
 
+void ExtraAttrUI::refreshNodeValues()
+{
+    // Get list of nodes with this attribute. Driven values are left unread so a
+    // refresh never evaluates upstream nodes; they are read on request instead.
+    MString mayaAttrName(m_currentAttributeName.toUtf8().constData());
+    m_nodeValues = m_scanner->getNodesWithAttribute(
+        mayaAttrName, ExtraAttrScanner::kReadMeshStats | ExtraAttrScanner::kSkipDrivenValues);
+
+    applyPlugFlagFilter();
+    updateValueStatistics();
+}
+
+void ExtraAttrUI::applyPlugFlagFilter()
+{
+    unsigned int requiredFlags = 0;
+    unsigned int excludedFlags = 0;
+    for (QAction* action : m_requireFlagActions) {
+        if (action->isChecked()) {
+            requiredFlags |= action->data().toUInt();
+        }
+    }
+    for (QAction* action : m_excludeFlagActions) {
+        if (action->isChecked()) {
+            excludedFlags |= action->data().toUInt();
+        }
+    }
+
+    int activeCount = 0;
+    for (unsigned int flags = requiredFlags | excludedFlags; flags; flags &= flags - 1) {
+        ++activeCount;
+    }
+    m_plugFlagButton->setText(activeCount > 0 ? QString("Flags (%1)").arg(activeCount) : QString("Flags"));
+
+    // Set to node model (only rows that changed are updated when the attribute is the same)
+    if (activeCount == 0) {
+        m_nodeModel->setNodeValues(m_currentAttributeName, m_nodeValues);
+        return;
+    }
+
+    // Flags were recorded by the scan, so filtering reads no plugs
+    std::vector<NodeAttributeValue> filtered;
+    filtered.reserve(m_nodeValues.size());
+    for (const NodeAttributeValue& nodeValue : m_nodeValues) {
+        if ((nodeValue.plugFlags & requiredFlags) == requiredFlags && (nodeValue.plugFlags & excludedFlags) == 0) {
+            filtered.push_back(nodeValue);
+        }
+    }
+    m_nodeModel->setNodeValues(m_currentAttributeName, filtered);
+}
+
+void ExtraAttrUI::onPlugFlagFilterChanged()
+{
+    if (m_currentAttributeName.isEmpty()) {
+        return;
+    }
+    applyPlugFlagFilter();
+}
+
 void ExtraAttrUI::onSearchTextChanged(const QString& text)
 {
     // Simple filtering (better to use proxy model in the future)
@@ -491,6 +624,22 @@ void ExtraAttrUI::onNodeValueChanged(const QString& nodeName, const QString& att
     if (success) {
         MGlobal::displayInfo(MString("Updated ") + nodeName.toUtf8().constData() + "." +
                              attrName.toUtf8().constData() + " = " + newValue.toUtf8().constData());
+
+        // Keep the unfiltered rows in step with the edited cell, as the model does
+        MString mNodeName(nodeName.toUtf8().constData());
+        for (NodeAttributeValue& cached : m_nodeValues) {
+            if (cached.nodeName != mNodeName) {
+                continue;
+            }
+            QByteArray text = newValue.toUtf8();
+            cached.valueStr = text.constData();
+            bool boolValue = false;
+            if (cached.hasSortNumber && !ExtraAttrValueCodec::parseDouble(text.constData(), cached.sortNumber) &&
+                ExtraAttrValueCodec::parseBool(text.constData(), boolValue)) {
+                cached.sortNumber = boolValue ? 1.0 : 0.0;
+            }
+            break;
+        }
     } else {
         QMessageBox::warning(this, "Edit Error",
                              QString("Failed to update attribute: %1.%2").arg(nodeName).arg(attrName));
@@ -506,14 +655,17 @@ void ExtraAttrUI::onAttributeContextMenu(const QPoint& pos)
 
     QMenu menu(this);
     QAction* addAction = menu.addAction("Add Attribute to Selected Nodes...");
+    QAction* renameAction = menu.addAction("Rename Attribute on All Nodes...");
     QAction* deleteAction = menu.addAction("Delete Attribute from All Nodes...");
 
     QAction* selectedAction = menu.exec(m_attributeTableView->viewport()->mapToGlobal(pos));
 
     if (selectedAction == addAction) {
         onAddAttribute();
+    } else if (selectedAction == renameAction) {
+        onRenameAttribute();
     } else if (selectedAction == deleteAction) {
-        onDeleteAttribute();
+        onPurgeAttribute();
     }
 }
 
@@ -524,21 +676,26 @@ void ExtraAttrUI::onNodeContextMenu(const QPoint& pos)
         return;
     }
 
-    // Get selected node name
+    // Get the clicked row in the node model
     QModelIndex sourceIndex = m_nodeProxyModel->mapToSource(index);
-    QString nodeName = m_nodeModel->getNodeName(sourceIndex.row());
 
     QMenu menu(this);
     QAction* selectAction = menu.addAction("Select Node in Maya");
+    QAction* selectSameValueAction = menu.addAction("Select All Nodes With This Value");
 
     // Add polygon selection option if node is a material
     QAction* selectPolygonsAction = nullptr;
     QAction* extractPolygonsAction = nullptr;
-    if (isShadingNode(nodeName)) {
+    if (isShadingRow(sourceIndex.row())) {
         selectPolygonsAction = menu.addAction("Select Assigned Polygons");
         extractPolygonsAction = menu.addAction("Extract Assigned Polygons...");
     }
 
+    QAction* evaluateAction = nullptr;
+    if (m_nodeModel->isDrivenRow(sourceIndex.row())) {
+        evaluateAction = menu.addAction("Evaluate Driven Values");
+    }
+
     QAction* deleteAction = menu.addAction("Delete Attribute from This Node...");
     menu.addSeparator();
     QAction* batchAction = menu.addAction("Batch Edit Selected Nodes...");
@@ -547,10 +704,14 @@ void ExtraAttrUI::onNodeContextMenu(const QPoint& pos)
 
     if (selectedAction == selectAction) {
         onSelectNode();
+    } else if (selectedAction == selectSameValueAction) {
+        onSelectNodesWithSameValue();
     } else if (selectedAction == selectPolygonsAction && selectPolygonsAction) {
         onSelectAssignedPolygons();
     } else if (selectedAction == extractPolygonsAction && extractPolygonsAction) {
         onExtractAssignedPolygons();
+    } else if (selectedAction == evaluateAction && evaluateAction) {
+        onEvaluateDrivenValues();
     } else if (selectedAction == deleteAction) {
         onDeleteAttribute();
     } else if (selectedAction == batchAction) {
@@ -581,13 +742,39 @@ void ExtraAttrUI::onDeleteAttribute()
         return;
     }
 
-    int successCount = 0;
+    // Remove the attribute from all selected nodes in one batch
+    MString mAttrName(m_currentAttributeName.toUtf8().constData());
+    MDGModifier dgModifier;
+    std::vector<MObject> removedNodes;
+    removedNodes.reserve(selectedRows.size());
+
     for (const QModelIndex& index : selectedRows) {
         QModelIndex sourceIndex = m_nodeProxyModel->mapToSource(index);
         QString nodeName = m_nodeModel->getNodeName(sourceIndex.row());
-        if (deleteAttribute(nodeName, m_currentAttributeName)) {
-            successCount++;
+
+        MObject node;
+        if (!MayaUtils::getNodeFromName(MString(nodeName.toUtf8().constData()), node)) {
+            continue;
         }
+
+        MFnDependencyNode fnDep(node);
+        MStatus status;
+        MObject attr = fnDep.attribute(mAttrName, &status);
+        if (status != MS::kSuccess || attr.isNull()) {
+            continue;
+        }
+
+        if (dgModifier.removeAttribute(node, attr) == MS::kSuccess) {
+            removedNodes.push_back(node);
+        }
+    }
+
+    int successCount = 0;
+    if (!removedNodes.empty() && dgModifier.doIt() == MS::kSuccess) {
+        successCount = static_cast<int>(removedNodes.size());
+
+        // Patch the index instead of rescanning the scene
+        m_scanner->removeAttributeFromNodes(mAttrName, removedNodes);
     }
 
     QMessageBox::information(this, "Delete Complete",
@@ -595,7 +782,43 @@ void ExtraAttrUI::onDeleteAttribute()
                                  .arg(successCount)
                                  .arg(selectedRows.size()));
 
-    onScanButtonClicked();
+    reloadFromIndex();
+}
+
+void ExtraAttrUI::onPurgeAttribute()
+{
+    if (m_currentAttributeName.isEmpty()) {
+        return;
+    }
+
+    MString quotedName = MayaUtils::quoteMelString(MString(m_currentAttributeName.toUtf8().constData()));
+
+    // Count affected nodes first with a dry run
+    MStringArray affectedNodes;
+    MString dryRunCmd = MString("exAttrEditor -purge ") + quotedName + " -dryRun";
+    if (MGlobal::executeCommand(dryRunCmd, affectedNodes) != MS::kSuccess || affectedNodes.length() == 0) {
+        QMessageBox::information(this, "Delete Attribute",
+                                 QString("No nodes have attribute '%1'.").arg(m_currentAttributeName));
+        return;
+    }
+
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, "Delete Attribute",
+        QString("Are you sure you want to delete attribute '%1' from all %2 node(s)?")
+            .arg(m_currentAttributeName)
+            .arg(affectedNodes.length()),
+        QMessageBox::Yes | QMessageBox::No);
+
+    if (reply != QMessageBox::Yes) {
+        return;
+    }
+
+    // Run through the command so the purge is a single undo step; it refreshes the UI itself
+    MString purgeCmd = MString("exAttrEditor -purge ") + quotedName;
+    if (MGlobal::executeCommand(purgeCmd, true, true) != MS::kSuccess) {
+        QMessageBox::warning(this, "Delete Attribute",
+                             QString("Failed to delete attribute '%1'.").arg(m_currentAttributeName));
+    }
 }
 
 void ExtraAttrUI::onAddAttribute()
@@ -645,6 +868,44 @@ void ExtraAttrUI::onAddAttribute()
     onScanButtonClicked();
 }
 
+void ExtraAttrUI::onRenameAttribute()
+{
+    if (m_currentAttributeName.isEmpty()) {
+        return;
+    }
+
+    bool ok;
+    QString newName = QInputDialog::getText(this, "Rename Attribute",
+                                            QString("New name for attribute '%1':").arg(m_currentAttributeName),
+                                            QLineEdit::Normal, m_currentAttributeName, &ok);
+    if (!ok || newName.isEmpty() || newName == m_currentAttributeName) {
+        return;
+    }
+
+    MString mayaNewName(newName.toUtf8().constData());
+    if (!MayaUtils::isValidAttributeName(mayaNewName)) {
+        QMessageBox::warning(this, "Rename Attribute",
+                             QString("'%1' is not a valid attribute name. Use letters, digits and underscores, "
+                                     "not starting with a digit.").arg(newName));
+        return;
+    }
+
+    // Run through the command so the whole rename is a single undo step
+    QString oldName = m_currentAttributeName;
+    MString command = MString("exAttrEditor -rename ") +
+                      MayaUtils::quoteMelString(MString(oldName.toUtf8().constData())) + " " +
+                      MayaUtils::quoteMelString(mayaNewName);
+
+    // The command refreshes the UI from the patched index, so select the new name up front
+    m_currentAttributeName = newName;
+    MStatus status = MGlobal::executeCommand(command, true, true);
+    if (status != MS::kSuccess) {
+        m_currentAttributeName = oldName;
+        QMessageBox::warning(this, "Rename Attribute",
+                             QString("Failed to rename attribute '%1' to '%2'.").arg(oldName).arg(newName));
+    }
+}
+
 void ExtraAttrUI::onBatchEdit()
 {
     QModelIndexList selectedRows = m_nodeTableView->selectionModel()->selectedRows();
@@ -694,6 +955,101 @@ void ExtraAttrUI::onSelectNode()
     selectNodeInMaya(nodeName);
 }
 
+void ExtraAttrUI::onSelectNodesWithSameValue()
+{
+    QModelIndex index = m_nodeTableView->currentIndex();
+    if (!index.isValid() || m_currentAttributeName.isEmpty()) {
+        return;
+    }
+
+    QModelIndex sourceIndex = m_nodeProxyModel->mapToSource(index);
+    if (m_nodeModel->isDrivenRow(sourceIndex.row())) {
+        MGlobal::displayWarning("Value is driven and has not been read; evaluate it first");
+        return;
+    }
+    QString value = m_nodeModel->data(m_nodeModel->index(sourceIndex.row(), NodeAttributeModel::COL_VALUE)).toString();
+
+    std::vector<MString> values;
+    values.push_back(MString(value.toUtf8().constData()));
+
+    std::vector<MObject> nodes;
+    MString mAttrName(m_currentAttributeName.toUtf8().constData());
+    if (!m_scanner->findNodesWithValues(mAttrName, values, nodes)) {
+        return;
+    }
+
+    MSelectionList selList;
+    for (const MObject& node : nodes) {
+        if (!node.isNull()) {
+            selList.add(node);
+        }
+    }
+
+    MGlobal::setActiveSelectionList(selList);
+    MGlobal::displayInfo(MString("Selected ") + selList.length() + " nodes with " + mAttrName +
+                         " = " + value.toUtf8().constData());
+}
+
+void ExtraAttrUI::onEvaluateDrivenValues()
+{
+    QModelIndexList selectedRows = m_nodeTableView->selectionModel()->selectedRows();
+    if (selectedRows.isEmpty() || m_currentAttributeName.isEmpty()) {
+        return;
+    }
+
+    MString mAttrName(m_currentAttributeName.toUtf8().constData());
+    int evaluatedCount = 0;
+
+    // Read values by node name, so the unfiltered rows can be updated in one pass
+    std::unordered_map<std::string, NodeAttributeValue> evaluated;
+
+    for (const QModelIndex& index : selectedRows) {
+        int row = m_nodeProxyModel->mapToSource(index).row();
+        if (!m_nodeModel->isDrivenRow(row)) {
+            continue;
+        }
+
+        MFnDependencyNode fnDep;
+        MString nodeName(m_nodeModel->getNodeName(row).toUtf8().constData());
+        if (!MayaUtils::getDependencyNodeFromName(nodeName, fnDep)) {
+            continue;
+        }
+
+        MStatus status;
+        MObject attr = fnDep.attribute(mAttrName, &status);
+        if (status != MS::kSuccess || attr.isNull()) {
+            continue;
+        }
+        MPlug plug = fnDep.findPlug(attr, &status);
+        if (status != MS::kSuccess) {
+            continue;
+        }
+
+        NodeAttributeValue& nodeValue = evaluated[nodeName.asChar()];
+        nodeValue.hasSortNumber = MayaUtils::getPlugSortNumber(plug, attr, nodeValue.sortNumber);
+        nodeValue.valueStr = MayaUtils::getPlugValueAsString(plug, attr);
+        m_nodeModel->setEvaluatedValue(row, QString::fromUtf8(nodeValue.valueStr.asChar()), nodeValue.sortNumber,
+                                       nodeValue.hasSortNumber);
+        ++evaluatedCount;
+    }
+
+    // Keep the values when the plug flag filter is changed
+    for (NodeAttributeValue& cached : m_nodeValues) {
+        if (!cached.isDriven) {
+            continue;
+        }
+        auto it = evaluated.find(cached.nodeName.asChar());
+        if (it != evaluated.end()) {
+            cached.valueStr = it->second.valueStr;
+            cached.sortNumber = it->second.sortNumber;
+            cached.hasSortNumber = it->second.hasSortNumber;
+            cached.isDriven = false;
+        }
+    }
+
+    MGlobal::displayInfo(MString("Evaluated ") + evaluatedCount + " driven values of " + mAttrName);
+}
+
 void ExtraAttrUI::updateStatistics()
 {
     int totalAttrs, totalNodes;
@@ -704,35 +1060,52 @@ void ExtraAttrUI::updateStatistics()
                               .arg(totalNodes));
 }
 
-bool ExtraAttrUI::setAttributeValue(const QString& nodeName, const QString& attrName, const QString& value)
+void ExtraAttrUI::updateValueStatistics()
 {
-    MStatus status;
-    MFnDependencyNode fnDep;
+    m_valueStatsLabel->clear();
+    m_valueStatsLabel->setToolTip(QString());
 
-    // Get node
-    MString mNodeName(nodeName.toUtf8().constData());
-    if (!MayaUtils::getDependencyNodeFromName(mNodeName, fnDep)) {
-        return false;
+    if (m_currentAttributeName.isEmpty()) {
+        return;
     }
 
-    // Get attribute
-    MString mAttrName(attrName.toUtf8().constData());
-    MObject attr = fnDep.attribute(mAttrName, &status);
-    if (status != MS::kSuccess || attr.isNull()) {
-        return false;
+    std::vector<double> values;
+    MString mAttrName(m_currentAttributeName.toUtf8().constData());
+    if (!m_scanner->getNumericValues(mAttrName, values, ExtraAttrScanner::kSkipDrivenValues) || values.empty()) {
+        return;
     }
 
-    MPlug plug = fnDep.findPlug(attr, &status);
-    if (status != MS::kSuccess) {
-        return false;
+    ValueStatistics stats = ExtraAttrStats::computeValueStatistics(values.data(), values.size());
+
+    QString skipped = stats.skippedCount > 0 ? QString("  Skipped (inf/NaN): %1").arg(stats.skippedCount) : QString();
+    if (stats.count == 0) {
+        m_valueStatsLabel->setText(skipped.trimmed());
+        return;
     }
 
-    // Set value using utility function
-    MString mValue(value.toUtf8().constData());
-    return MayaUtils::setAttributeValueFromString(plug, attr, mValue);
+    m_valueStatsLabel->setText(QString("Min: %1  Max: %2  Mean: %3  StdDev: %4  Distinct: %5")
+                                   .arg(stats.minValue)
+                                   .arg(stats.maxValue)
+                                   .arg(stats.mean)
+                                   .arg(stats.stddev)
+                                   .arg(stats.distinctCount) +
+                               skipped);
+
+    // Histogram as a text bar chart in the tooltip
+    size_t maxBin = *std::max_element(stats.histogram.begin(), stats.histogram.end());
+    double binWidth = (stats.maxValue - stats.minValue) / static_cast<double>(stats.histogram.size());
+    QString tooltip;
+    for (size_t i = 0; i < stats.histogram.size(); ++i) {
+        int barLength = maxBin > 0 ? static_cast<int>(stats.histogram[i] * 30 / maxBin) : 0;
+        tooltip += QString("%1: %2 %3\n")
+                       .arg(stats.minValue + binWidth * static_cast<double>(i), 10, 'g', 4)
+                       .arg(QString(barLength, QChar('#')))
+                       .arg(stats.histogram[i]);
+    }
+    m_valueStatsLabel->setToolTip(tooltip.trimmed());
 }
 
-bool ExtraAttrUI::deleteAttribute(const QString& nodeName, const QString& attrName)
+bool ExtraAttrUI::setAttributeValue(const QString& nodeName, const QString& attrName, const QString& value)
 {
     MStatus status;
     MFnDependencyNode fnDep;
@@ -750,8 +1123,14 @@ bool ExtraAttrUI::deleteAttribute(const QString& nodeName, const QString& attrNa
         return false;
     }
 
-    status = fnDep.removeAttribute(attr);
-    return (status == MS::kSuccess);
+    MPlug plug = fnDep.findPlug(attr, &status);
+    if (status != MS::kSuccess) {
+        return false;
+    }
+
+    // Set value using utility function
+    MString mValue(value.toUtf8().constData());
+    return MayaUtils::setAttributeValueFromString(plug, attr, mValue);
 }
 
 bool ExtraAttrUI::addAttribute(const QString& nodeName, const QString& attrName, const QString& attrType)
@@ -821,88 +1200,12 @@ bool ExtraAttrUI::selectNodeInMaya(const QString& nodeName)
         return false;
     }
 
-    // Check if node is a shading engine or material
-    bool isShadingNode = false;
-    MString nodeType = fnDep.typeName(&status);
-
-    // Debug: Print node type
-    MString debugMsg = "ExtraAttrUI: Node '";
-    debugMsg += nodeName.toUtf8().constData();
-    debugMsg += "' has type: ";
-    debugMsg += nodeType;
-    MGlobal::displayInfo(debugMsg);
-
-    if (status == MS::kSuccess) {
-        // Check if it's a shading-related node
-        // Include common Maya material types
-        if (nodeType == "lambert" ||
-            nodeType == "blinn" ||
-            nodeType == "phong" ||
-            nodeType == "phongE" ||
-            nodeType == "anisotropic" ||
-            nodeType == "standardSurface" ||
-            nodeType == "aiStandardSurface" ||
-            nodeType == "shadingEngine" ||
-            nodeType.indexW("shader") >= 0 ||
-            nodeType.indexW("material") >= 0 ||
-            nodeType.indexW("texture") >= 0) {
-            isShadingNode = true;
-            MGlobal::displayInfo("ExtraAttrUI: Detected as shading node");
-        } else {
-            MGlobal::displayInfo("ExtraAttrUI: Detected as regular node");
-        }
-    }
+    // Check if node is a shading engine or material (cached per node type)
+    bool isShadingNode = (MayaUtils::getNodeTypeFlags(fnDep) & MayaUtils::kNodeTypeShading) != 0;
 
     if (isShadingNode) {
-        // For shading nodes, enable "Assigned Materials" display and select objects with this material
-        MString pythonCmd = "import maya.cmds as mc\n";
-        pythonCmd += "node = '" + MString(nodeName.toUtf8().constData()) + "'\n";
-        pythonCmd += "try:\n";
-        pythonCmd += "    # First, enable 'Assigned Materials' display in all outliners\n";
-        pythonCmd += "    outliner_panels = mc.getPanel(type='outlinerPanel')\n";
-        pythonCmd += "    if outliner_panels:\n";
-        pythonCmd += "        for panel in outliner_panels:\n";
-        pythonCmd += "            outliner = mc.outlinerPanel(panel, query=True, outlinerEditor=True)\n";
-        pythonCmd += "            if outliner:\n";
-        pythonCmd += "                mc.outlinerEditor(outliner, edit=True, showAssignedMaterials=True)\n";
-        pythonCmd += "    # Find objects assigned to this material\n";
-        pythonCmd += "    objects = []\n";
-        pythonCmd += "    shading_engines = []\n";
-        pythonCmd += "    if mc.objectType(node) == 'shadingEngine':\n";
-        pythonCmd += "        shading_engines = [node]\n";
-        pythonCmd += "    else:\n";
-        pythonCmd += "        connections = mc.listConnections(node, type='shadingEngine', destination=True) or []\n";
-        pythonCmd += "        shading_engines = list(set(connections))\n";
-        pythonCmd += "    for sg in shading_engines:\n";
-        pythonCmd += "        try:\n";
-        pythonCmd += "            members = mc.sets(sg, query=True) or []\n";
-        pythonCmd += "            for member in members:\n";
-        pythonCmd += "                if mc.objectType(member, isAType='shape'):\n";
-        pythonCmd += "                    transforms = mc.listRelatives(member, parent=True, fullPath=True) or []\n";
-        pythonCmd += "                    objects.extend(transforms)\n";
-        pythonCmd += "                elif mc.objectType(member, isAType='transform'):\n";
-        pythonCmd += "                    objects.append(member)\n";
-        pythonCmd += "        except Exception as e:\n";
-        pythonCmd += "            print('Error processing shading engine: ' + str(e))\n";
-        pythonCmd += "    # Select objects and expand in outliner\n";
-        pythonCmd += "    if objects:\n";
-        pythonCmd += "        mc.select(objects, replace=True)\n";
-        pythonCmd += "        # Expand outliner to show selected objects\n";
-        pythonCmd += "        outliner_panels = mc.getPanel(type='outlinerPanel')\n";
-        pythonCmd += "        if outliner_panels:\n";
-        pythonCmd += "            for panel in outliner_panels:\n";
-        pythonCmd += "                outliner = mc.outlinerPanel(panel, query=True, outlinerEditor=True)\n";
-        pythonCmd += "                if outliner:\n";
-        pythonCmd += "                    mc.outlinerEditor(outliner, edit=True, showSelected=True)\n";
-        pythonCmd += "        print('Selected ' + str(len(objects)) + ' objects with material: ' + node)\n";
-        pythonCmd += "    else:\n";
-        pythonCmd += "        # If no objects found, just select the material itself\n";
-        pythonCmd += "        mc.select(node, replace=True)\n";
-        pythonCmd += "        print('No objects found for material: ' + node)\n";
-        pythonCmd += "except Exception as e:\n";
-        pythonCmd += "    print('Error selecting objects for material: ' + str(e))\n";
-
-        MGlobal::executePythonCommand(pythonCmd);
+        // For shading nodes, select the objects with this material
+        selectObjectsWithMaterials(QStringList(nodeName));
     } else {
         // For regular nodes, select directly
         status = MGlobal::setActiveSelectionList(selList);
@@ -911,119 +1214,91 @@ bool ExtraAttrUI::selectNodeInMaya(const QString& nodeName)
         }
 
         // Expand outliner hierarchy to show selected node
-        MString pythonCmd =
-            "import maya.cmds as mc\n"
-            "outliner_panels = mc.getPanel(type='outlinerPanel')\n"
-            "if outliner_panels:\n"
-            "    for panel in outliner_panels:\n"
-            "        outliner = mc.outlinerPanel(panel, query=True, outlinerEditor=True)\n"
-            "        if outliner:\n"
-            "            mc.outlinerEditor(outliner, edit=True, showSelected=True)\n";
-        MGlobal::executePythonCommand(pythonCmd);
+        editOutliners("showSelected");
     }
 
     return true;
 }
 
-bool ExtraAttrUI::isShadingNode(const QString& nodeName)
+bool ExtraAttrUI::isShadingRow(int sourceRow) const
 {
-    MStatus status;
-    MSelectionList selList;
-    status = selList.add(nodeName.toUtf8().constData());
-    if (status != MS::kSuccess) {
-        return false;
-    }
+    // Classified per node type during the scan, so no node lookup is needed here
+    return (m_nodeModel->getNodeTypeFlags(sourceRow) & MayaUtils::kNodeTypeShading) != 0;
+}
 
-    MObject nodeObj;
-    status = selList.getDependNode(0, nodeObj);
-    if (status != MS::kSuccess || nodeObj.isNull()) {
-        return false;
+std::vector<MObject> ExtraAttrUI::getNodeObjects(const QStringList& nodeNames)
+{
+    std::vector<MObject> nodes;
+    nodes.reserve(nodeNames.size());
+    for (const QString& nodeName : nodeNames) {
+        MObject node;
+        if (MayaUtils::getNodeFromName(MString(nodeName.toUtf8().constData()), node)) {
+            nodes.push_back(node);
+        }
     }
+    return nodes;
+}
 
-    MFnDependencyNode fnDep(nodeObj, &status);
-    if (status != MS::kSuccess) {
-        return false;
-    }
+void ExtraAttrUI::editOutliners(const char* flag)
+{
+    MString pythonCmd =
+        "import maya.cmds as mc\n"
+        "outliner_panels = mc.getPanel(type='outlinerPanel')\n"
+        "if outliner_panels:\n"
+        "    for panel in outliner_panels:\n"
+        "        outliner = mc.outlinerPanel(panel, query=True, outlinerEditor=True)\n"
+        "        if outliner:\n"
+        "            mc.outlinerEditor(outliner, edit=True, ";
+    pythonCmd += flag;
+    pythonCmd += "=True)\n";
+    MGlobal::executePythonCommand(pythonCmd);
+}
+
+bool ExtraAttrUI::selectPolygonsWithMaterials(const QStringList& materialNames)
+{
+    // Faces come from the cached assignment index; one component per mesh instance
+    std::vector<MeshFaceSet> faceSets;
+    ExtraAttrShadingIndex::sharedIndex().resolveFaces(getNodeObjects(materialNames), faceSets);
+
+    MSelectionList selList;
+    ExtraAttrShading::addFaceSets(faceSets, selList);
 
-    MString nodeType = fnDep.typeName(&status);
+    MStatus status = MGlobal::setActiveSelectionList(selList, MGlobal::kReplaceList);
     if (status != MS::kSuccess) {
         return false;
     }
 
-    // Check if it's a shading-related node
-    if (nodeType == "lambert" ||
-        nodeType == "blinn" ||
-        nodeType == "phong" ||
-        nodeType == "phongE" ||
-        nodeType == "anisotropic" ||
-        nodeType == "standardSurface" ||
-        nodeType == "aiStandardSurface" ||
-        nodeType == "shadingEngine" ||
-        nodeType.indexW("shader") >= 0 ||
-        nodeType.indexW("material") >= 0 ||
-        nodeType.indexW("texture") >= 0) {
-        return true;
+    if (faceSets.empty()) {
+        MGlobal::displayInfo("No polygons found for selected materials");
+    } else {
+        MGlobal::displayInfo(MString("Selected faces on ") + static_cast<unsigned int>(faceSets.size()) +
+                             " mesh(es) from " + static_cast<int>(materialNames.size()) + " material(s)");
     }
-
-    return false;
+    return true;
 }
 
-bool ExtraAttrUI::selectPolygonsWithMaterial(const QString& materialName)
+void ExtraAttrUI::selectObjectsWithMaterials(const QStringList& materialNames)
 {
-    // Use Python to select polygons assigned to this material
-    // This handles face assignments properly, supporting multiple materials per mesh
-    MString pythonCmd = "import maya.cmds as mc\n";
-    pythonCmd += "material = '" + MString(materialName.toUtf8().constData()) + "'\n";
-    pythonCmd += "try:\n";
-    pythonCmd += "    # Find shading engines connected to this material\n";
-    pythonCmd += "    shading_engines = []\n";
-    pythonCmd += "    if mc.objectType(material) == 'shadingEngine':\n";
-    pythonCmd += "        shading_engines = [material]\n";
-    pythonCmd += "    else:\n";
-    pythonCmd += "        connections = mc.listConnections(material, type='shadingEngine', destination=True) or []\n";
-    pythonCmd += "        shading_engines = list(set(connections))\n";
-    pythonCmd += "    \n";
-    pythonCmd += "    if not shading_engines:\n";
-    pythonCmd += "        print('No shading engines found for material: ' + material)\n";
-    pythonCmd += "        mc.select(clear=True)\n";
-    pythonCmd += "    else:\n";
-    pythonCmd += "        # Get all faces assigned to these shading engines\n";
-    pythonCmd += "        face_list = []\n";
-    pythonCmd += "        for sg in shading_engines:\n";
-    pythonCmd += "            try:\n";
-    pythonCmd += "                members = mc.sets(sg, query=True) or []\n";
-    pythonCmd += "                for member in members:\n";
-    pythonCmd += "                    # Check if it's a face component (e.g., 'pCube1.f[0:5]')\n";
-    pythonCmd += "                    if '.f[' in member:\n";
-    pythonCmd += "                        face_list.append(member)\n";
-    pythonCmd += "                    # If it's a whole mesh shape, convert to all faces\n";
-    pythonCmd += "                    elif mc.objectType(member, isAType='mesh'):\n";
-    pythonCmd += "                        # Get the number of faces\n";
-    pythonCmd += "                        face_count = mc.polyEvaluate(member, face=True)\n";
-    pythonCmd += "                        if face_count > 0:\n";
-    pythonCmd += "                            face_list.append(member + '.f[0:' + str(face_count-1) + ']')\n";
-    pythonCmd += "                    # If it's a transform node, get its shape and convert to faces\n";
-    pythonCmd += "                    elif mc.objectType(member, isAType='transform'):\n";
-    pythonCmd += "                        shapes = mc.listRelatives(member, shapes=True, type='mesh') or []\n";
-    pythonCmd += "                        for shape in shapes:\n";
-    pythonCmd += "                            face_count = mc.polyEvaluate(shape, face=True)\n";
-    pythonCmd += "                            if face_count > 0:\n";
-    pythonCmd += "                                face_list.append(shape + '.f[0:' + str(face_count-1) + ']')\n";
-    pythonCmd += "            except Exception as e:\n";
-    pythonCmd += "                print('Error processing shading engine ' + sg + ': ' + str(e))\n";
-    pythonCmd += "        \n";
-    pythonCmd += "        if face_list:\n";
-    pythonCmd += "            mc.select(face_list, replace=True)\n";
-    pythonCmd += "            print('Selected ' + str(len(face_list)) + ' face component(s) with material: ' + material)\n";
-    pythonCmd += "        else:\n";
-    pythonCmd += "            print('No polygons found for material: ' + material)\n";
-    pythonCmd += "            mc.select(clear=True)\n";
-    pythonCmd += "except Exception as e:\n";
-    pythonCmd += "    print('Error selecting polygons for material: ' + str(e))\n";
-    pythonCmd += "    mc.select(clear=True)\n";
-
-    MStatus status = MGlobal::executePythonCommand(pythonCmd);
-    return (status == MS::kSuccess);
+    // Show the assigned materials under the objects in all outliners
+    editOutliners("showAssignedMaterials");
+
+    std::vector<MObject> materials = getNodeObjects(materialNames);
+
+    MSelectionList objects;
+    ExtraAttrShading::resolveObjects(materials, objects);
+
+    if (objects.length() > 0) {
+        MGlobal::setActiveSelectionList(objects, MGlobal::kReplaceList);
+        editOutliners("showSelected");
+        return;
+    }
+
+    // If no objects found, just select the materials themselves
+    MSelectionList materialList;
+    for (const MObject& material : materials) {
+        materialList.add(material);
+    }
+    MGlobal::setActiveSelectionList(materialList, MGlobal::kReplaceList);
 }
 
 void ExtraAttrUI::onSelectAssignedPolygons()
@@ -1038,9 +1313,8 @@ void ExtraAttrUI::onSelectAssignedPolygons()
     QStringList materialNames;
     for (const QModelIndex& index : selectedRows) {
         QModelIndex sourceIndex = m_nodeProxyModel->mapToSource(index);
-        QString nodeName = m_nodeModel->getNodeName(sourceIndex.row());
-        if (isShadingNode(nodeName)) {
-            materialNames.append(nodeName);
+        if (isShadingRow(sourceIndex.row())) {
+            materialNames.append(m_nodeModel->getNodeName(sourceIndex.row()));
         }
     }
 
@@ -1049,62 +1323,7 @@ void ExtraAttrUI::onSelectAssignedPolygons()
         return;
     }
 
-    // Build Python command to select polygons for all materials
-    MString pythonCmd = "import maya.cmds as mc\n";
-    pythonCmd += "materials = [";
-    for (int i = 0; i < materialNames.size(); ++i) {
-        pythonCmd += "'" + MString(materialNames[i].toUtf8().constData()) + "'";
-        if (i < materialNames.size() - 1) {
-            pythonCmd += ", ";
-        }
-    }
-    pythonCmd += "]\n";
-    pythonCmd += "try:\n";
-    pythonCmd += "    all_faces = []\n";
-    pythonCmd += "    for material in materials:\n";
-    pythonCmd += "        # Find shading engines connected to this material\n";
-    pythonCmd += "        shading_engines = []\n";
-    pythonCmd += "        if mc.objectType(material) == 'shadingEngine':\n";
-    pythonCmd += "            shading_engines = [material]\n";
-    pythonCmd += "        else:\n";
-    pythonCmd += "            connections = mc.listConnections(material, type='shadingEngine', destination=True) or []\n";
-    pythonCmd += "            shading_engines = list(set(connections))\n";
-    pythonCmd += "        \n";
-    pythonCmd += "        # Get all faces assigned to these shading engines\n";
-    pythonCmd += "        for sg in shading_engines:\n";
-    pythonCmd += "            try:\n";
-    pythonCmd += "                members = mc.sets(sg, query=True) or []\n";
-    pythonCmd += "                for member in members:\n";
-    pythonCmd += "                    # Check if it's a face component (e.g., 'pCube1.f[0:5]')\n";
-    pythonCmd += "                    if '.f[' in member:\n";
-    pythonCmd += "                        all_faces.append(member)\n";
-    pythonCmd += "                    # If it's a whole mesh shape, convert to all faces\n";
-    pythonCmd += "                    elif mc.objectType(member, isAType='mesh'):\n";
-    pythonCmd += "                        face_count = mc.polyEvaluate(member, face=True)\n";
-    pythonCmd += "                        if face_count > 0:\n";
-    pythonCmd += "                            all_faces.append(member + '.f[0:' + str(face_count-1) + ']')\n";
-    pythonCmd += "                    # If it's a transform node, get its shape and convert to faces\n";
-    pythonCmd += "                    elif mc.objectType(member, isAType='transform'):\n";
-    pythonCmd += "                        shapes = mc.listRelatives(member, shapes=True, type='mesh') or []\n";
-    pythonCmd += "                        for shape in shapes:\n";
-    pythonCmd += "                            face_count = mc.polyEvaluate(shape, face=True)\n";
-    pythonCmd += "                            if face_count > 0:\n";
-    pythonCmd += "                                all_faces.append(shape + '.f[0:' + str(face_count-1) + ']')\n";
-    pythonCmd += "            except Exception as e:\n";
-    pythonCmd += "                print('Error processing shading engine ' + sg + ': ' + str(e))\n";
-    pythonCmd += "    \n";
-    pythonCmd += "    if all_faces:\n";
-    pythonCmd += "        mc.select(all_faces, replace=True)\n";
-    pythonCmd += "        print('Selected ' + str(len(all_faces)) + ' face component(s) from ' + str(len(materials)) + ' material(s)')\n";
-    pythonCmd += "    else:\n";
-    pythonCmd += "        print('No polygons found for selected materials')\n";
-    pythonCmd += "        mc.select(clear=True)\n";
-    pythonCmd += "except Exception as e:\n";
-    pythonCmd += "    print('Error selecting polygons for materials: ' + str(e))\n";
-    pythonCmd += "    mc.select(clear=True)\n";
-
-    MStatus status = MGlobal::executePythonCommand(pythonCmd);
-    if (status != MS::kSuccess) {
+    if (!selectPolygonsWithMaterials(materialNames)) {
         QMessageBox::warning(this, "Select Polygons",
                            QString("Failed to select polygons for selected materials."));
     }
@@ -1122,9 +1341,8 @@ void ExtraAttrUI::onExtractAssignedPolygons()
     QStringList materialNames;
     for (const QModelIndex& index : selectedRows) {
         QModelIndex sourceIndex = m_nodeProxyModel->mapToSource(index);
-        QString nodeName = m_nodeModel->getNodeName(sourceIndex.row());
-        if (isShadingNode(nodeName)) {
-            materialNames.append(nodeName);
+        if (isShadingRow(sourceIndex.row())) {
+            materialNames.append(m_nodeModel->getNodeName(sourceIndex.row()));
         }
     }
 
@@ -1155,160 +1373,75 @@ void ExtraAttrUI::onExtractAssignedPolygons()
         return;
     }
 
-    // Build Python command
-    MString pythonCmd = "import maya.cmds as mc\n";
-    pythonCmd += "materials = [";
-    for (int i = 0; i < materialNames.size(); ++i) {
-        pythonCmd += "'" + MString(materialNames[i].toUtf8().constData()) + "'";
-        if (i < materialNames.size() - 1) {
-            pythonCmd += ", ";
+    // Quote a list of node names as MEL arguments
+    auto quoted = [](const MStringArray& names) {
+        MString args;
+        for (unsigned int i = 0; i < names.length(); ++i) {
+            args += MString(" \"") + names[i] + "\"";
+        }
+        return args;
+    };
+
+    MString baseName(newObjName.toUtf8().constData());
+    MString command("exAttrEditor");
+    for (const QString& material : materialNames) {
+        command += MString(" -extract \"") + material.toUtf8().constData() + "\"";
+    }
+    command += MString(" -extractName \"") + baseName + "\"";
+    if (keepOriginal) {
+        command += " -keepOriginal";
+    }
+    if (combineMeshes) {
+        command += " -combine";
+    }
+
+    // The native extraction and the follow-up edits undo as one step
+    MGlobal::executeCommand("undoInfo -openChunk");
+
+    MStringArray newObjects;
+    MStatus status = MGlobal::executeCommand(command, newObjects, true, true);
+    if (status == MS::kSuccess && newObjects.length() > 0) {
+        if (assignMaterial) {
+            MString material, shadingGroup;
+            MGlobal::executeCommand(MString("shadingNode -asShader -name \"") + newMatName.toUtf8().constData() +
+                                    "\" lambert", material, true, true);
+            MGlobal::executeCommand(MString("sets -renderable true -noSurfaceShader true -empty -name \"") +
+                                    material + "SG\"", shadingGroup, true, true);
+            MGlobal::executeCommand(MString("connectAttr -f \"") + material + ".outColor\" \"" +
+                                    shadingGroup + ".surfaceShader\"", true, true);
+            MGlobal::executeCommand(MString("sets -e -forceElement \"") + shadingGroup + "\"" +
+                                    quoted(newObjects), true, true);
         }
+
+        // Group the results; parent returns the new paths
+        MString group;
+        MGlobal::executeCommand(MString("group -empty -name \"") + baseName + "_grp\"", group, true, true);
+        MStringArray parented;
+        MGlobal::executeCommand(MString("parent") + quoted(newObjects) + " \"" + group + "\"", parented, true, true);
+        MGlobal::executeCommand(MString("select -r") + quoted(parented.length() > 0 ? parented : newObjects), true, true);
+
+        MGlobal::displayInfo(MString("Extracted ") + newObjects.length() + " object(s) into group: " + group);
     }
-    pythonCmd += "]\n";
-    
-    // Pass options to Python
-    pythonCmd += "new_obj_name_base = '" + MString(newObjName.toUtf8().constData()) + "'\n";
-    pythonCmd += "keep_original = " + MString(keepOriginal ? "True" : "False") + "\n";
-    pythonCmd += "assign_material = " + MString(assignMaterial ? "True" : "False") + "\n";
-    pythonCmd += "new_mat_name = '" + MString(newMatName.toUtf8().constData()) + "'\n";
-    pythonCmd += "combine_meshes = " + MString(combineMeshes ? "True" : "False") + "\n";
-
-    pythonCmd += "try:\n";
-    pythonCmd += "    # 1. Identify target faces\n";
-    pythonCmd += "    all_faces = []\n";
-    pythonCmd += "    for material in materials:\n";
-    pythonCmd += "        shading_engines = []\n";
-    pythonCmd += "        if mc.objectType(material) == 'shadingEngine':\n";
-    pythonCmd += "            shading_engines = [material]\n";
-    pythonCmd += "        else:\n";
-    pythonCmd += "            connections = mc.listConnections(material, type='shadingEngine', destination=True) or []\n";
-    pythonCmd += "            shading_engines = list(set(connections))\n";
-    pythonCmd += "        \n";
-    pythonCmd += "        for sg in shading_engines:\n";
-    pythonCmd += "            members = mc.sets(sg, query=True) or []\n";
-    pythonCmd += "            for member in members:\n";
-    pythonCmd += "                if '.f[' in member:\n";
-    pythonCmd += "                    all_faces.append(member)\n";
-    pythonCmd += "                elif mc.objectType(member, isAType='mesh'):\n";
-    pythonCmd += "                    face_count = mc.polyEvaluate(member, face=True)\n";
-    pythonCmd += "                    if face_count > 0:\n";
-    pythonCmd += "                        all_faces.append(member + '.f[0:' + str(face_count-1) + ']')\n";
-    pythonCmd += "                elif mc.objectType(member, isAType='transform'):\n";
-    pythonCmd += "                    shapes = mc.listRelatives(member, shapes=True, type='mesh') or []\n";
-    pythonCmd += "                    for shape in shapes:\n";
-    pythonCmd += "                        face_count = mc.polyEvaluate(shape, face=True)\n";
-    pythonCmd += "                        if face_count > 0:\n";
-    pythonCmd += "                            all_faces.append(shape + '.f[0:' + str(face_count-1) + ']')\n";
-    pythonCmd += "    \n";
-    pythonCmd += "    if not all_faces:\n";
-    pythonCmd += "        print('No polygons found for selected materials')\n";
-    pythonCmd += "    else:\n";
-    pythonCmd += "        # 2. Group faces by object\n";
-    pythonCmd += "        objects_to_process = {}\n";
-    pythonCmd += "        # Need to handle flattened list for easier processing, enforce long names to prevent mismatches\n";
-    pythonCmd += "        all_faces_flat = mc.ls(all_faces, flatten=True, long=True)\n";
-    pythonCmd += "        for face in all_faces_flat:\n";
-    pythonCmd += "            # Safer way to extract object name\n";
-    pythonCmd += "            obj = face.split('.f[')[0]\n";
-    pythonCmd += "            if obj not in objects_to_process:\n";
-    pythonCmd += "                objects_to_process[obj] = []\n";
-    pythonCmd += "            objects_to_process[obj].append(face)\n";
-    pythonCmd += "        \n";
-    pythonCmd += "        new_objects = []\n";
-    pythonCmd += "        \n";
-    pythonCmd += "        mc.undoInfo(openChunk=True)\n";
-    pythonCmd += "        try:\n";
-    pythonCmd += "            for obj, obj_faces in objects_to_process.items():\n";
-    pythonCmd += "                # 3. Duplicate object\n";
-    pythonCmd += "                new_obj = mc.duplicate(obj, name=new_obj_name_base)[0]\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                # Ensure we have the long name of the new object to match the source faces format\n";
-    pythonCmd += "                # IMPORTANT: mc.ls(..., long=True) on faces returns paths including the SHAPE node (e.g. |Transform|Shape.f[0])\n";
-    pythonCmd += "                # However, duplicate() returns the Transform name. We must get the Shape node's long path.\n";
-    pythonCmd += "                new_obj_long = mc.ls(new_obj, long=True)[0]\n";
-    pythonCmd += "                shapes = mc.listRelatives(new_obj_long, shapes=True, fullPath=True)\n";
-    pythonCmd += "                if shapes:\n";
-    pythonCmd += "                    target_obj_path = shapes[0]\n";
-    pythonCmd += "                else:\n";
-    pythonCmd += "                    target_obj_path = new_obj_long # Fallback if no shape (shouldn't happen for mesh)\n";
-    pythonCmd += "\n";
-    pythonCmd += "                # 4. Delete non-target faces on new object\n";
-    pythonCmd += "                # Get all faces of new object (long names) using the SHAPE path to ensure format matches\n";
-    pythonCmd += "                all_new_faces = mc.ls(target_obj_path + '.f[*]', flatten=True, long=True)\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                # Map target faces to new object by index (robust against name changes)\n";
-    pythonCmd += "                # Parse index from source face string \"object.f[123]\" -> \"123\"\n";
-    pythonCmd += "                target_faces_new = []\n";
-    pythonCmd += "                for f in obj_faces:\n";
-    pythonCmd += "                    if '.f[' in f:\n";
-    pythonCmd += "                        face_idx = f.split('.f[')[-1].rstrip(']')\n";
-    pythonCmd += "                        target_faces_new.append(target_obj_path + '.f[' + face_idx + ']')\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                # Calculate faces to delete (All - Target)\n";
-    pythonCmd += "                # Set operations with strings (perfect match required, hence long names)\n";
-    pythonCmd += "                to_delete = list(set(all_new_faces) - set(target_faces_new))\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                \n";
-    pythonCmd += "                if to_delete:\n";
-    pythonCmd += "                    mc.delete(to_delete)\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                new_objects.append(new_obj)\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                # 5. Determine if original faces should be deleted\n";
-    pythonCmd += "                if not keep_original:\n";
-    pythonCmd += "                    mc.delete(obj_faces)\n";
-    pythonCmd += "            \n";
-    pythonCmd += "            if new_objects:\n";
-    pythonCmd += "                final_objects = new_objects\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                # Combine meshes if requested\n";
-    pythonCmd += "                if combine_meshes and len(new_objects) > 0:\n";
-    pythonCmd += "                    if len(new_objects) > 1:\n";
-    pythonCmd += "                        # Use polyUnite to combine\n";
-    pythonCmd += "                        combined = mc.polyUnite(new_objects, name=new_obj_name_base + '_combined', ch=False, mergeUVSets=1)\n";
-    pythonCmd += "                        if combined:\n";
-    pythonCmd += "                            final_objects = [combined[0]]\n";
-    pythonCmd += "                    else:\n";
-    pythonCmd += "                        pass\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                # 6. Assign material\n";
-    pythonCmd += "                if assign_material:\n";
-    pythonCmd += "                    mat = mc.shadingNode('lambert', asShader=True, name=new_mat_name)\n";
-    pythonCmd += "                    sg = mc.sets(renderable=True, noSurfaceShader=True, empty=True, name=mat+'SG')\n";
-    pythonCmd += "                    mc.connectAttr(mat+'.outColor', sg+'.surfaceShader')\n";
-    pythonCmd += "                    mc.sets(final_objects, edit=True, forceElement=sg)\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                # 7. Group and reparent to top level\n";
-    pythonCmd += "                group_name = new_obj_name_base + '_grp'\n";
-    pythonCmd += "                group_node = mc.group(empty=True, name=group_name)\n";
-    pythonCmd += "                mc.parent(final_objects, group_node)\n";
-    pythonCmd += "                \n";
-    pythonCmd += "                mc.select(final_objects, replace=True)\n";
-    pythonCmd += "                print('Extracted ' + str(len(new_objects)) + ' object(s) into group: ' + group_name)\n";
-    pythonCmd += "            \n";
-    pythonCmd += "        except Exception as inner_e:\n";
-    pythonCmd += "            print('Error during extraction loop: ' + str(inner_e))\n";
-    pythonCmd += "            raise inner_e\n";
-    pythonCmd += "        finally:\n";
-    pythonCmd += "            mc.undoInfo(closeChunk=True)\n";
-    pythonCmd += "            \n";
-    pythonCmd += "except Exception as e:\n";
-    pythonCmd += "    print('Error extracting polygons: ' + str(e))\n";
-    pythonCmd += "    mc.undoInfo(closeChunk=True)\n";
 
-    MGlobal::executePythonCommand(pythonCmd);
+    MGlobal::executeCommand("undoInfo -closeChunk");
+
+    if (status != MS::kSuccess) {
+        QMessageBox::warning(this, "Extract Polygons", "Failed to extract polygons for selected materials.");
+    } else if (newObjects.length() == 0) {
+        QMessageBox::information(this, "Extract Polygons", "No polygons found for selected materials.");
+    }
 }
 
 void ExtraAttrUI::onAttributeFilterChanged(const QString& text)
 {
-    m_attributeProxyModel->setFilterFixedString(text);
+    m_attributeProxyModel->setSearchText(text);
 }
 
 void ExtraAttrUI::onNodeFilterChanged(const QString& text)
 {
     int filterColumn = m_filterButtonGroup->checkedId();
     m_nodeProxyModel->setFilterKeyColumn(filterColumn);
-    m_nodeProxyModel->setFilterFixedString(text);
+    m_nodeProxyModel->setSearchText(text);
 }
 
 void ExtraAttrUI::onNodeSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
@@ -1329,7 +1462,7 @@ void ExtraAttrUI::onNodeSelectionChanged(const QItemSelection& selected, const Q
         QString nodeName = m_nodeModel->getNodeName(sourceIndex.row());
         if (!nodeName.isEmpty()) {
             nodeNames.append(nodeName);
-            if (isShadingNode(nodeName)) {
+            if (isShadingRow(sourceIndex.row())) {
                 materialNames.append(nodeName);
             }
         }
@@ -1342,58 +1475,7 @@ void ExtraAttrUI::onNodeSelectionChanged(const QItemSelection& selected, const Q
     // If all selected nodes are materials, select objects assigned to those materials
     if (!materialNames.isEmpty() && materialNames.size() == nodeNames.size()) {
         // All selected nodes are materials - select their assigned objects
-        MString pythonCmd = "import maya.cmds as mc\n";
-        pythonCmd += "materials = [";
-        for (int i = 0; i < materialNames.size(); ++i) {
-            pythonCmd += "'" + MString(materialNames[i].toUtf8().constData()) + "'";
-            if (i < materialNames.size() - 1) {
-                pythonCmd += ", ";
-            }
-        }
-        pythonCmd += "]\n";
-        pythonCmd += "try:\n";
-        pythonCmd += "    # First, enable 'Assigned Materials' display in all outliners\n";
-        pythonCmd += "    outliner_panels = mc.getPanel(type='outlinerPanel')\n";
-        pythonCmd += "    if outliner_panels:\n";
-        pythonCmd += "        for panel in outliner_panels:\n";
-        pythonCmd += "            outliner = mc.outlinerPanel(panel, query=True, outlinerEditor=True)\n";
-        pythonCmd += "            if outliner:\n";
-        pythonCmd += "                mc.outlinerEditor(outliner, edit=True, showAssignedMaterials=True)\n";
-        pythonCmd += "    # Find objects assigned to these materials\n";
-        pythonCmd += "    objects = []\n";
-        pythonCmd += "    for material in materials:\n";
-        pythonCmd += "        shading_engines = []\n";
-        pythonCmd += "        if mc.objectType(material) == 'shadingEngine':\n";
-        pythonCmd += "            shading_engines = [material]\n";
-        pythonCmd += "        else:\n";
-        pythonCmd += "            connections = mc.listConnections(material, type='shadingEngine', destination=True) or []\n";
-        pythonCmd += "            shading_engines = list(set(connections))\n";
-        pythonCmd += "        for sg in shading_engines:\n";
-        pythonCmd += "            try:\n";
-        pythonCmd += "                members = mc.sets(sg, query=True) or []\n";
-        pythonCmd += "                for member in members:\n";
-        pythonCmd += "                    if mc.objectType(member, isAType='shape'):\n";
-        pythonCmd += "                        transforms = mc.listRelatives(member, parent=True, fullPath=True) or []\n";
-        pythonCmd += "                        objects.extend(transforms)\n";
-        pythonCmd += "                    elif mc.objectType(member, isAType='transform'):\n";
-        pythonCmd += "                        objects.append(member)\n";
-        pythonCmd += "            except Exception as e:\n";
-        pythonCmd += "                print('Error processing shading engine: ' + str(e))\n";
-        pythonCmd += "    # Select objects and expand in outliner\n";
-        pythonCmd += "    if objects:\n";
-        pythonCmd += "        mc.select(objects, replace=True)\n";
-        pythonCmd += "        outliner_panels = mc.getPanel(type='outlinerPanel')\n";
-        pythonCmd += "        if outliner_panels:\n";
-        pythonCmd += "            for panel in outliner_panels:\n";
-        pythonCmd += "                outliner = mc.outlinerPanel(panel, query=True, outlinerEditor=True)\n";
-        pythonCmd += "                if outliner:\n";
-        pythonCmd += "                    mc.outlinerEditor(outliner, edit=True, showSelected=True)\n";
-        pythonCmd += "    else:\n";
-        pythonCmd += "        mc.select(materials, replace=True)\n";
-        pythonCmd += "except Exception as e:\n";
-        pythonCmd += "    print('Error selecting objects for materials: ' + str(e))\n";
-
-        MGlobal::executePythonCommand(pythonCmd);
+        selectObjectsWithMaterials(materialNames);
     } else {
         // Mixed selection or all regular nodes - select them directly
         MSelectionList selList;
@@ -1410,15 +1492,7 @@ void ExtraAttrUI::onNodeSelectionChanged(const QItemSelection& selected, const Q
             MGlobal::setActiveSelectionList(selList);
 
             // Expand outliner to show selected nodes
-            MString pythonCmd =
-                "import maya.cmds as mc\n"
-                "outliner_panels = mc.getPanel(type='outlinerPanel')\n"
-                "if outliner_panels:\n"
-                "    for panel in outliner_panels:\n"
-                "        outliner = mc.outlinerPanel(panel, query=True, outlinerEditor=True)\n"
-                "        if outliner:\n"
-                "            mc.outlinerEditor(outliner, edit=True, showSelected=True)\n";
-            MGlobal::executePythonCommand(pythonCmd);
+            editOutliners("showSelected");
         }
     }
 }
@@ -1450,31 +1524,14 @@ QStringList ExtraAttrUI::getEnumFieldNames(const QString& nodeName, const QStrin
         return result;
     }
 
-    if (attr.apiType() != MFn::kEnumAttribute) {
-        return result;
-    }
-
-    MFnEnumAttribute fnEnum(attr, &status);
-    if (status != MS::kSuccess) {
+    std::shared_ptr<const EnumFieldTable> table = MayaUtils::getEnumFieldTable(attr);
+    if (!table) {
         return result;
     }
 
-    short minValue, maxValue;
-    status = fnEnum.getMin(minValue);
-    if (status != MS::kSuccess) {
-        minValue = 0;
-    }
-
-    status = fnEnum.getMax(maxValue);
-    if (status != MS::kSuccess) {
-        maxValue = 0;
-    }
-
-    for (short i = minValue; i <= maxValue; ++i) {
-        MString fieldName = fnEnum.fieldName(i, &status);
-        if (status == MS::kSuccess && fieldName.length() > 0) {
-            result.append(QString::fromUtf8(fieldName.asChar()));
-        }
+    result.reserve(static_cast<int>(table->names.size()));
+    for (const MString& fieldName : table->names) {
+        result.append(QString::fromUtf8(fieldName.asChar()));
     }
 
     return result;
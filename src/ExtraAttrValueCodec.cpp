@@ -0,0 +1,255 @@
+#include "ExtraAttrValueCodec.h"
+#include <charconv>
+#include <cstring>
+
+namespace ExtraAttrValueCodec {
+
+namespace {
+
+// Enough for the shortest round-trip form of any double or 64-bit integer
+const size_t kMaxNumberChars = 32;
+
+template <typename T>
+void appendNumber(std::string& out, T value)
+{
+    char buffer[kMaxNumberChars];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+template <typename T>
+void appendList(std::string& out, const T* values, size_t count, size_t tupleSize)
+{
+    if (tupleSize == 0) {
+        tupleSize = 1;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            if (i % tupleSize == 0) {
+                out += kElementSeparator;
+            } else {
+                out += ' ';
+            }
+        }
+        appendNumber(out, values[i]);
+    }
+}
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool isListSeparator(char c)
+{
+    return isSpace(c) || c == ',' || c == '[' || c == ']' || c == '(' || c == ')';
+}
+
+// Parse one number at p; from_chars rejects a leading '+', which users do type
+template <typename T>
+const char* parseNumberAt(const char* p, const char* end, T& out)
+{
+    if (p < end && *p == '+') {
+        ++p;
+    }
+
+    std::from_chars_result result = std::from_chars(p, end, out);
+    if (result.ec != std::errc() || result.ptr == p) {
+        return nullptr;
+    }
+    return result.ptr;
+}
+
+template <typename T>
+bool parseScalar(const char* text, T& out)
+{
+    if (!text) {
+        return false;
+    }
+
+    const char* end = text + strlen(text);
+    while (text < end && isSpace(*text)) {
+        ++text;
+    }
+    while (end > text && isSpace(end[-1])) {
+        --end;
+    }
+
+    const char* p = parseNumberAt(text, end, out);
+    return p == end;
+}
+
+template <typename T>
+bool parseList(const char* text, std::vector<T>& out)
+{
+    out.clear();
+    if (!text) {
+        return false;
+    }
+
+    const char* p = text;
+    const char* end = text + strlen(text);
+
+    while (true) {
+        while (p < end && isListSeparator(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            return true;
+        }
+
+        T value;
+        p = parseNumberAt(p, end, value);
+        if (!p) {
+            return false;
+        }
+        out.push_back(value);
+    }
+}
+
+} // namespace
+
+void appendBool(std::string& out, bool value)
+{
+    out += value ? "true" : "false";
+}
+
+void appendInt(std::string& out, long long value)
+{
+    appendNumber(out, value);
+}
+
+void appendFloat(std::string& out, float value)
+{
+    appendNumber(out, value);
+}
+
+void appendDouble(std::string& out, double value)
+{
+    appendNumber(out, value);
+}
+
+void appendDoubles(std::string& out, const double* values, size_t count, size_t tupleSize)
+{
+    appendList(out, values, count, tupleSize);
+}
+
+void appendFloats(std::string& out, const float* values, size_t count, size_t tupleSize)
+{
+    appendList(out, values, count, tupleSize);
+}
+
+void appendInts(std::string& out, const int* values, size_t count)
+{
+    appendList(out, values, count, 1);
+}
+
+void appendQuotedString(std::string& out, const char* value, size_t length)
+{
+    out += '"';
+    for (size_t i = 0; i < length; ++i) {
+        if (value[i] == '"' || value[i] == '\\') {
+            out += '\\';
+        }
+        out += value[i];
+    }
+    out += '"';
+}
+
+bool parseBool(const char* text, bool& out)
+{
+    if (!text) {
+        return false;
+    }
+
+    while (isSpace(*text)) {
+        ++text;
+    }
+    size_t length = strlen(text);
+    while (length > 0 && isSpace(text[length - 1])) {
+        --length;
+    }
+
+    if ((length == 4 && strncmp(text, "true", 4) == 0) || (length == 1 && text[0] == '1')) {
+        out = true;
+        return true;
+    }
+    if ((length == 5 && strncmp(text, "false", 5) == 0) || (length == 1 && text[0] == '0')) {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+bool parseShort(const char* text, short& out)
+{
+    return parseScalar(text, out);
+}
+
+bool parseInt(const char* text, int& out)
+{
+    return parseScalar(text, out);
+}
+
+bool parseFloat(const char* text, float& out)
+{
+    return parseScalar(text, out);
+}
+
+bool parseDouble(const char* text, double& out)
+{
+    return parseScalar(text, out);
+}
+
+bool parseDoubles(const char* text, std::vector<double>& out)
+{
+    return parseList(text, out);
+}
+
+bool parseFloats(const char* text, std::vector<float>& out)
+{
+    return parseList(text, out);
+}
+
+bool parseInts(const char* text, std::vector<int>& out)
+{
+    return parseList(text, out);
+}
+
+bool parseQuotedStrings(const char* text, std::vector<std::string>& out)
+{
+    out.clear();
+    if (!text) {
+        return false;
+    }
+
+    const char* p = text;
+    while (true) {
+        while (*p && isListSeparator(*p)) {
+            ++p;
+        }
+        if (!*p) {
+            return true;
+        }
+        if (*p != '"') {
+            return false;
+        }
+
+        std::string value;
+        for (++p; *p && *p != '"'; ++p) {
+            if (*p == '\\' && p[1]) {
+                ++p;
+            }
+            value += *p;
+        }
+        if (*p != '"') {
+            return false;
+        }
+        ++p;
+
+        out.push_back(value);
+    }
+}
+
+} // namespace ExtraAttrValueCodec
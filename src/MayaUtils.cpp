@@ -4,7 +4,179 @@
 #include <maya/MFnEnumAttribute.h>
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MFnNumericData.h>
+#include <maya/MFnUnitAttribute.h>
+#include <maya/MFnMatrixData.h>
+#include <maya/MFnDoubleArrayData.h>
+#include <maya/MFnIntArrayData.h>
+#include <maya/MFnPointArrayData.h>
+#include <maya/MFnVectorArrayData.h>
+#include <maya/MFnStringArrayData.h>
+#include <maya/MMatrix.h>
+#include <maya/MDoubleArray.h>
+#include <maya/MIntArray.h>
+#include <maya/MPointArray.h>
+#include <maya/MVectorArray.h>
+#include <maya/MStringArray.h>
+#include <maya/MAngle.h>
+#include <maya/MDistance.h>
+#include <maya/MTime.h>
 #include <maya/MGlobal.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MTypeId.h>
+#include <algorithm>
+#include "ExtraAttrValueCodec.h"
+
+bool EnumFieldTable::findValue(const MString& name, short& outValue) const
+{
+    auto it = valueByName.find(name.asChar());
+    if (it == valueByName.end()) {
+        return false;
+    }
+    outValue = it->second;
+    return true;
+}
+
+bool EnumFieldTable::findName(short value, MString& outName) const
+{
+    auto it = indexByValue.find(value);
+    if (it == indexByValue.end()) {
+        return false;
+    }
+    outName = names[it->second];
+    return true;
+}
+
+namespace {
+
+typedef std::pair<MObjectHandle, std::shared_ptr<const EnumFieldTable>> EnumTableEntry;
+
+// Cached tables before the cache is dropped; dynamic attributes give one entry per node
+const size_t kMaxEnumTables = 16384;
+size_t s_enumTableCount = 0;
+
+// Attribute handle hash -> cached tables (a bucket holds attributes with equal hashes)
+std::unordered_map<unsigned int, std::vector<EnumTableEntry>>& enumTableCache()
+{
+    static std::unordered_map<unsigned int, std::vector<EnumTableEntry>> s_cache;
+    return s_cache;
+}
+
+std::shared_ptr<const EnumFieldTable> buildEnumFieldTable(const MObject& attr)
+{
+    MStatus status;
+    MFnEnumAttribute fnEnum(attr, &status);
+    if (status != MS::kSuccess) {
+        return nullptr;
+    }
+
+    short minValue, maxValue;
+    status = fnEnum.getMin(minValue);
+    if (status != MS::kSuccess) minValue = 0;
+    status = fnEnum.getMax(maxValue);
+    if (status != MS::kSuccess) maxValue = 255;
+
+    auto table = std::make_shared<EnumFieldTable>();
+    table->minValue = minValue;
+    table->maxValue = maxValue;
+    for (int i = minValue; i <= maxValue; ++i) {
+        short value = static_cast<short>(i);
+        MString fieldName = fnEnum.fieldName(value, &status);
+        if (status != MS::kSuccess || fieldName.length() == 0) {
+            continue;
+        }
+
+        table->indexByValue[value] = table->names.size();
+        table->valueByName.emplace(fieldName.asChar(), value);
+        table->names.push_back(fieldName);
+        table->values.push_back(value);
+    }
+
+    return table;
+}
+
+/**
+ * @brief Check that a cached table still describes the attribute's fields
+ *
+ * Compares the value range and the outer fields, which field edits almost
+ * always change; a full comparison would cost as much as a rebuild.
+ */
+bool isEnumFieldTableCurrent(const MObject& attr, const EnumFieldTable& table)
+{
+    MStatus status;
+    MFnEnumAttribute fnEnum(attr, &status);
+    if (status != MS::kSuccess) {
+        return false;
+    }
+
+    short minValue, maxValue;
+    status = fnEnum.getMin(minValue);
+    if (status != MS::kSuccess) minValue = 0;
+    status = fnEnum.getMax(maxValue);
+    if (status != MS::kSuccess) maxValue = 255;
+    if (minValue != table.minValue || maxValue != table.maxValue) {
+        return false;
+    }
+
+    if (table.names.empty()) {
+        return true;
+    }
+    return fnEnum.fieldName(table.values.front(), &status) == table.names.front() && status == MS::kSuccess &&
+           fnEnum.fieldName(table.values.back(), &status) == table.names.back() && status == MS::kSuccess;
+}
+
+// Node type ID -> NodeTypeFlag combination
+std::unordered_map<unsigned int, unsigned int>& nodeTypeFlagCache()
+{
+    static std::unordered_map<unsigned int, unsigned int> s_cache;
+    return s_cache;
+}
+
+unsigned int computeNodeTypeFlags(const MFnDependencyNode& fnDep)
+{
+    unsigned int flags = 0;
+
+    MObject node = fnDep.object();
+    if (node.hasFn(MFn::kShadingEngine)) {
+        flags |= MayaUtils::kNodeTypeShadingEngine;
+    }
+    if (node.hasFn(MFn::kLambert)) {
+        flags |= MayaUtils::kNodeTypeMaterial;
+    }
+    if (node.hasFn(MFn::kTexture2d) || node.hasFn(MFn::kTexture3d)) {
+        flags |= MayaUtils::kNodeTypeTexture;
+    }
+
+    // Classification is a ':'-separated list of paths such as "shader/surface:drawdb/shader/surface/lambert"
+    MString typeName = fnDep.typeName();
+    std::string classification = MFnDependencyNode::classification(typeName).asChar();
+    size_t start = 0;
+    while (start <= classification.size()) {
+        size_t end = classification.find(':', start);
+        if (end == std::string::npos) {
+            end = classification.size();
+        }
+
+        if (classification.compare(start, 7, "shader/") == 0) {
+            flags |= MayaUtils::kNodeTypeMaterial;
+        } else if (classification.compare(start, 8, "texture/") == 0) {
+            flags |= MayaUtils::kNodeTypeTexture;
+        }
+        start = end + 1;
+    }
+
+    // Unclassified plug-in nodes are recognized by name as before
+    std::string name = typeName.asChar();
+    if (name.find("shader") != std::string::npos || name.find("material") != std::string::npos) {
+        flags |= MayaUtils::kNodeTypeMaterial;
+    }
+    if (name.find("texture") != std::string::npos) {
+        flags |= MayaUtils::kNodeTypeTexture;
+    }
+
+    return flags;
+}
+
+} // namespace
 
 namespace MayaUtils {
 
@@ -45,62 +217,651 @@ bool getDependencyNodeFromName(const MString& nodeName, MFnDependencyNode& outFn
 
 bool setAttributeValueFromString(MPlug& plug, const MObject& attr, const MString& value)
 {
-    MStatus status;
+    using namespace ExtraAttrValueCodec;
+
+    MStatus status = MS::kFailure;
+    const char* text = value.asChar();
     MFn::Type apiType = attr.apiType();
 
     if (apiType == MFn::kNumericAttribute) {
         MFnNumericAttribute fnNum(attr);
         MFnNumericData::Type numType = fnNum.unitType();
 
-        if (numType == MFnNumericData::kBoolean) {
-            bool bValue = (value == "true" || value == "1");
-            status = plug.setValue(bValue);
-        } else if (numType == MFnNumericData::kInt || numType == MFnNumericData::kLong) {
-            int iValue = value.asInt();
-            status = plug.setValue(iValue);
-        } else if (numType == MFnNumericData::kFloat) {
-            float fValue = value.asFloat();
-            status = plug.setValue(fValue);
-        } else if (numType == MFnNumericData::kDouble) {
-            double dValue = value.asDouble();
-            status = plug.setValue(dValue);
+        switch (numType) {
+            case MFnNumericData::kBoolean: {
+                bool bValue;
+                if (parseBool(text, bValue)) status = plug.setBool(bValue);
+                break;
+            }
+            case MFnNumericData::kShort: {
+                short sValue;
+                if (parseShort(text, sValue)) status = plug.setShort(sValue);
+                break;
+            }
+            case MFnNumericData::kInt: {
+                int iValue;
+                if (parseInt(text, iValue)) status = plug.setInt(iValue);
+                break;
+            }
+            case MFnNumericData::kFloat: {
+                float fValue;
+                if (parseFloat(text, fValue)) status = plug.setFloat(fValue);
+                break;
+            }
+            case MFnNumericData::kDouble: {
+                double dValue;
+                if (parseDouble(text, dValue)) status = plug.setDouble(dValue);
+                break;
+            }
+            case MFnNumericData::k2Float:
+            case MFnNumericData::k3Float: {
+                std::vector<float> values;
+                if (parseFloats(text, values) && values.size() == plug.numChildren()) {
+                    status = MS::kSuccess;
+                    for (unsigned int i = 0; i < values.size() && status == MS::kSuccess; ++i) {
+                        status = plug.child(i).setFloat(values[i]);
+                    }
+                }
+                break;
+            }
+            case MFnNumericData::k2Double:
+            case MFnNumericData::k3Double: {
+                std::vector<double> values;
+                if (parseDoubles(text, values) && values.size() == plug.numChildren()) {
+                    status = MS::kSuccess;
+                    for (unsigned int i = 0; i < values.size() && status == MS::kSuccess; ++i) {
+                        status = plug.child(i).setDouble(values[i]);
+                    }
+                }
+                break;
+            }
+            default:
+                status = plug.setString(value);
+                break;
         }
     } else if (apiType == MFn::kEnumAttribute) {
-        MFnEnumAttribute fnEnum(attr);
         // Search for value from string name
         short enumValue = -1;
         bool found = false;
 
-        // Scan all fields to find matching name
-        short minValue, maxValue;
-        status = fnEnum.getMin(minValue);
-        if (status != MS::kSuccess) minValue = 0;
-        status = fnEnum.getMax(maxValue);
-        if (status != MS::kSuccess) maxValue = 255;
+        std::shared_ptr<const EnumFieldTable> table = getEnumFieldTable(attr);
+        if (table) {
+            found = table->findValue(value, enumValue);
+            if (!found) {
+                // Fields may have been edited since the table was built
+                table = getEnumFieldTable(attr, true);
+                found = table && table->findValue(value, enumValue);
+            }
+        }
+
+        // If string name is not found, interpret as numeric value
+        if (found || parseShort(text, enumValue)) {
+            status = plug.setShort(enumValue);
+        }
+    } else if (apiType == MFn::kUnitAttribute) {
+        // Unit values are entered in the user's UI units
+        MFnUnitAttribute fnUnit(attr);
+        double dValue;
+        if (parseDouble(text, dValue)) {
+            switch (fnUnit.unitType()) {
+                case MFnUnitAttribute::kAngle:
+                    status = plug.setMAngle(MAngle(dValue, MAngle::uiUnit()));
+                    break;
+                case MFnUnitAttribute::kDistance:
+                    status = plug.setMDistance(MDistance(dValue, MDistance::uiUnit()));
+                    break;
+                case MFnUnitAttribute::kTime:
+                    status = plug.setMTime(MTime(dValue, MTime::uiUnit()));
+                    break;
+                default:
+                    status = plug.setDouble(dValue);
+                    break;
+            }
+        }
+    } else if (apiType == MFn::kTypedAttribute) {
+        MFnTypedAttribute fnTyped(attr);
+        MObject data;
 
-        for (short i = minValue; i <= maxValue; ++i) {
-            MString fieldName = fnEnum.fieldName(i, &status);
-            if (status == MS::kSuccess && fieldName == value) {
-                enumValue = i;
-                found = true;
+        switch (fnTyped.attrType()) {
+            case MFnData::kString:
+                status = plug.setString(value);
+                break;
+            case MFnData::kMatrix: {
+                std::vector<double> values;
+                if (parseDoubles(text, values) && values.size() == 16) {
+                    MMatrix matrix;
+                    for (unsigned int i = 0; i < 16; ++i) {
+                        matrix[i / 4][i % 4] = values[i];
+                    }
+                    MFnMatrixData fnData;
+                    data = fnData.create(matrix, &status);
+                }
+                break;
+            }
+            case MFnData::kDoubleArray: {
+                std::vector<double> values;
+                if (parseDoubles(text, values)) {
+                    MDoubleArray array(static_cast<unsigned int>(values.size()));
+                    for (unsigned int i = 0; i < values.size(); ++i) {
+                        array[i] = values[i];
+                    }
+                    MFnDoubleArrayData fnData;
+                    data = fnData.create(array, &status);
+                }
+                break;
+            }
+            case MFnData::kIntArray: {
+                std::vector<int> values;
+                if (parseInts(text, values)) {
+                    MIntArray array(static_cast<unsigned int>(values.size()));
+                    for (unsigned int i = 0; i < values.size(); ++i) {
+                        array[i] = values[i];
+                    }
+                    MFnIntArrayData fnData;
+                    data = fnData.create(array, &status);
+                }
+                break;
+            }
+            case MFnData::kPointArray: {
+                // Points are written as x y z w
+                std::vector<double> values;
+                if (parseDoubles(text, values) && values.size() % 4 == 0) {
+                    MPointArray array;
+                    for (size_t i = 0; i < values.size(); i += 4) {
+                        array.append(MPoint(values[i], values[i + 1], values[i + 2], values[i + 3]));
+                    }
+                    MFnPointArrayData fnData;
+                    data = fnData.create(array, &status);
+                }
                 break;
             }
+            case MFnData::kVectorArray: {
+                std::vector<double> values;
+                if (parseDoubles(text, values) && values.size() % 3 == 0) {
+                    MVectorArray array;
+                    for (size_t i = 0; i < values.size(); i += 3) {
+                        array.append(MVector(values[i], values[i + 1], values[i + 2]));
+                    }
+                    MFnVectorArrayData fnData;
+                    data = fnData.create(array, &status);
+                }
+                break;
+            }
+            case MFnData::kStringArray: {
+                std::vector<std::string> values;
+                if (parseQuotedStrings(text, values)) {
+                    MStringArray array;
+                    for (const std::string& element : values) {
+                        array.append(MString(element.c_str()));
+                    }
+                    MFnStringArrayData fnData;
+                    data = fnData.create(array, &status);
+                }
+                break;
+            }
+            default:
+                status = plug.setString(value);
+                break;
         }
 
-        if (found) {
-            status = plug.setValue(enumValue);
-        } else {
-            // If string name is not found, interpret as numeric value
-            enumValue = (short)value.asInt();
-            status = plug.setValue(enumValue);
+        if (!data.isNull() && status == MS::kSuccess) {
+            status = plug.setMObject(data);
         }
-    } else if (apiType == MFn::kTypedAttribute) {
-        status = plug.setValue(value);
     } else {
-        status = plug.setValue(value);
+        status = plug.setString(value);
     }
 
     return (status == MS::kSuccess);
 }
 
+bool isPlugDriven(const MPlug& plug)
+{
+    if (plug.isDestination()) {
+        return true;
+    }
+
+    // Only connected elements can be driven, so unconnected ones are never visited
+    if (plug.isArray()) {
+        unsigned int connectedCount = plug.numConnectedElements();
+        for (unsigned int i = 0; i < connectedCount; ++i) {
+            if (isPlugDriven(plug.connectionByPhysicalIndex(i))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (plug.isCompound()) {
+        for (unsigned int i = 0; i < plug.numChildren(); ++i) {
+            if (isPlugDriven(plug.child(i))) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+namespace {
+
+// Add the connection flags of a plug and of its connected children and elements
+void addConnectionFlags(const MPlug& plug, unsigned int& flags)
+{
+    if (plug.isConnected()) {
+        flags |= kPlugConnected;
+        if (plug.isDestination()) {
+            MPlug source = plug.source();
+            if (!source.isNull() && source.node().hasFn(MFn::kAnimCurve)) {
+                flags |= kPlugAnimated;
+            }
+        }
+    }
+
+    if (plug.isArray()) {
+        unsigned int connectedCount = plug.numConnectedElements();
+        for (unsigned int i = 0; i < connectedCount; ++i) {
+            addConnectionFlags(plug.connectionByPhysicalIndex(i), flags);
+        }
+    } else if (plug.isCompound()) {
+        for (unsigned int i = 0; i < plug.numChildren(); ++i) {
+            addConnectionFlags(plug.child(i), flags);
+        }
+    }
+}
+
+} // namespace
+
+unsigned int getPlugFlags(const MPlug& plug)
+{
+    unsigned int flags = 0;
+    addConnectionFlags(plug, flags);
+
+    if (plug.isLocked()) {
+        flags |= kPlugLocked;
+    }
+    if (plug.isKeyable()) {
+        flags |= kPlugKeyable;
+    }
+    if (plug.isDefaultValue(false)) {
+        flags |= kPlugDefault;
+    }
+    return flags;
+}
+
+bool parsePlugFlagNames(const MString& names, unsigned int& outFlags)
+{
+    outFlags = 0;
+
+    MStringArray words;
+    MString separated = names;
+    separated.substitute(",", " ");
+    separated.split(' ', words);
+
+    for (unsigned int i = 0; i < words.length(); ++i) {
+        const MString& word = words[i];
+        if (word == "connected") {
+            outFlags |= kPlugConnected;
+        } else if (word == "animated") {
+            outFlags |= kPlugAnimated;
+        } else if (word == "locked") {
+            outFlags |= kPlugLocked;
+        } else if (word == "keyable") {
+            outFlags |= kPlugKeyable;
+        } else if (word == "default") {
+            outFlags |= kPlugDefault;
+        } else if (word.length() > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isValidAttributeName(const MString& name)
+{
+    const char* text = name.asChar();
+    if (text[0] == '\0' || (text[0] >= '0' && text[0] <= '9')) {
+        return false;
+    }
+
+    for (const char* c = text; *c != '\0'; ++c) {
+        bool valid = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9') || *c == '_';
+        if (!valid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+MString quoteMelString(const MString& text)
+{
+    std::string quoted;
+    quoted.reserve(text.length() + 2);
+    quoted += '"';
+    for (const char* c = text.asChar(); *c != '\0'; ++c) {
+        switch (*c) {
+            case '\\':
+                quoted += "\\\\";
+                break;
+            case '"':
+                quoted += "\\\"";
+                break;
+            case '\n':
+                quoted += "\\n";
+                break;
+            case '\r':
+                quoted += "\\r";
+                break;
+            default:
+                quoted += *c;
+                break;
+        }
+    }
+    quoted += '"';
+    return MString(quoted.c_str());
+}
+
+MString getPlugValueAsString(const MPlug& plug, const MObject& attr)
+{
+    using namespace ExtraAttrValueCodec;
+
+    MStatus status;
+    std::string out;
+
+    switch (attr.apiType()) {
+        case MFn::kNumericAttribute: {
+            MFnNumericAttribute fnNum(attr);
+            switch (fnNum.unitType()) {
+                case MFnNumericData::kBoolean:
+                    appendBool(out, plug.asBool());
+                    break;
+                case MFnNumericData::kShort:
+                    appendInt(out, plug.asShort());
+                    break;
+                case MFnNumericData::kInt:
+                    appendInt(out, plug.asInt());
+                    break;
+                case MFnNumericData::kFloat:
+                    appendFloat(out, plug.asFloat());
+                    break;
+                case MFnNumericData::kDouble:
+                    appendDouble(out, plug.asDouble());
+                    break;
+                case MFnNumericData::k2Float:
+                case MFnNumericData::k3Float: {
+                    float values[3];
+                    unsigned int count = std::min(plug.numChildren(), 3u);
+                    for (unsigned int i = 0; i < count; ++i) {
+                        values[i] = plug.child(i).asFloat();
+                    }
+                    appendFloats(out, values, count, count);
+                    break;
+                }
+                case MFnNumericData::k2Double:
+                case MFnNumericData::k3Double: {
+                    double values[3];
+                    unsigned int count = std::min(plug.numChildren(), 3u);
+                    for (unsigned int i = 0; i < count; ++i) {
+                        values[i] = plug.child(i).asDouble();
+                    }
+                    appendDoubles(out, values, count, count);
+                    break;
+                }
+                default:
+                    return plug.asString(&status);
+            }
+            break;
+        }
+        case MFn::kUnitAttribute: {
+            MFnUnitAttribute fnUnit(attr);
+            switch (fnUnit.unitType()) {
+                case MFnUnitAttribute::kAngle:
+                    appendDouble(out, plug.asMAngle().asUnits(MAngle::uiUnit()));
+                    break;
+                case MFnUnitAttribute::kDistance:
+                    appendDouble(out, plug.asMDistance().asUnits(MDistance::uiUnit()));
+                    break;
+                case MFnUnitAttribute::kTime:
+                    appendDouble(out, plug.asMTime().as(MTime::uiUnit()));
+                    break;
+                default:
+                    appendDouble(out, plug.asDouble());
+                    break;
+            }
+            break;
+        }
+        case MFn::kTypedAttribute: {
+            MFnTypedAttribute fnTyped(attr);
+            MFnData::Type dataType = fnTyped.attrType();
+            if (dataType == MFnData::kString) {
+                return plug.asString(&status);
+            }
+
+            MObject data = plug.asMObject(&status);
+            if (status != MS::kSuccess || data.isNull()) {
+                // Unset array or matrix data
+                return "";
+            }
+
+            switch (dataType) {
+                case MFnData::kMatrix: {
+                    MMatrix matrix = MFnMatrixData(data).matrix();
+                    double values[16];
+                    for (unsigned int i = 0; i < 16; ++i) {
+                        values[i] = matrix[i / 4][i % 4];
+                    }
+                    appendDoubles(out, values, 16, 16);
+                    break;
+                }
+                case MFnData::kDoubleArray: {
+                    MDoubleArray array = MFnDoubleArrayData(data).array();
+                    for (unsigned int i = 0; i < array.length(); ++i) {
+                        if (i > 0) out += kElementSeparator;
+                        appendDouble(out, array[i]);
+                    }
+                    break;
+                }
+                case MFnData::kIntArray: {
+                    MIntArray array = MFnIntArrayData(data).array();
+                    for (unsigned int i = 0; i < array.length(); ++i) {
+                        if (i > 0) out += kElementSeparator;
+                        appendInt(out, array[i]);
+                    }
+                    break;
+                }
+                case MFnData::kPointArray: {
+                    MPointArray array = MFnPointArrayData(data).array();
+                    for (unsigned int i = 0; i < array.length(); ++i) {
+                        if (i > 0) out += kElementSeparator;
+                        const MPoint& point = array[i];
+                        double values[4] = {point.x, point.y, point.z, point.w};
+                        appendDoubles(out, values, 4, 4);
+                    }
+                    break;
+                }
+                case MFnData::kVectorArray: {
+                    MVectorArray array = MFnVectorArrayData(data).array();
+                    for (unsigned int i = 0; i < array.length(); ++i) {
+                        if (i > 0) out += kElementSeparator;
+                        const MVector& vector = array[i];
+                        double values[3] = {vector.x, vector.y, vector.z};
+                        appendDoubles(out, values, 3, 3);
+                    }
+                    break;
+                }
+                case MFnData::kStringArray: {
+                    MStringArray array = MFnStringArrayData(data).array();
+                    for (unsigned int i = 0; i < array.length(); ++i) {
+                        if (i > 0) out += kElementSeparator;
+                        appendQuotedString(out, array[i].asChar(), array[i].length());
+                    }
+                    break;
+                }
+                default:
+                    return plug.asString(&status);
+            }
+            break;
+        }
+        case MFn::kEnumAttribute: {
+            short value = plug.asShort();
+
+            // Convert enum value to string name
+            std::shared_ptr<const EnumFieldTable> table = getEnumFieldTable(attr);
+            MString fieldName;
+            if (table && table->findName(value, fieldName)) {
+                return fieldName;
+            }
+            // Return numeric value if field name cannot be obtained
+            appendInt(out, value);
+            break;
+        }
+        default:
+            return plug.asString(&status);
+    }
+
+    return MString(out.c_str(), static_cast<int>(out.length()));
+}
+
+bool getPlugSortNumber(const MPlug& plug, const MObject& attr, double& outValue)
+{
+    switch (attr.apiType()) {
+        case MFn::kNumericAttribute: {
+            MFnNumericAttribute fnNum(attr);
+            switch (fnNum.unitType()) {
+                case MFnNumericData::kBoolean:
+                    outValue = plug.asBool() ? 1.0 : 0.0;
+                    return true;
+                case MFnNumericData::kShort:
+                case MFnNumericData::kInt:
+                case MFnNumericData::kFloat:
+                case MFnNumericData::kDouble:
+                    outValue = plug.asDouble();
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        case MFn::kUnitAttribute: {
+            MFnUnitAttribute fnUnit(attr);
+            switch (fnUnit.unitType()) {
+                case MFnUnitAttribute::kAngle:
+                    outValue = plug.asMAngle().asUnits(MAngle::uiUnit());
+                    break;
+                case MFnUnitAttribute::kDistance:
+                    outValue = plug.asMDistance().asUnits(MDistance::uiUnit());
+                    break;
+                case MFnUnitAttribute::kTime:
+                    outValue = plug.asMTime().as(MTime::uiUnit());
+                    break;
+                default:
+                    outValue = plug.asDouble();
+                    break;
+            }
+            return true;
+        }
+        case MFn::kEnumAttribute: {
+            // Fields sort in the order they are declared; unknown values go last
+            short value = plug.asShort();
+            std::shared_ptr<const EnumFieldTable> table = getEnumFieldTable(attr);
+            if (!table) {
+                outValue = value;
+                return true;
+            }
+            auto it = table->indexByValue.find(value);
+            outValue = static_cast<double>((it != table->indexByValue.end()) ? it->second : table->names.size());
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+std::shared_ptr<const EnumFieldTable> getEnumFieldTable(const MObject& attr, bool refresh)
+{
+    if (attr.isNull() || attr.apiType() != MFn::kEnumAttribute) {
+        return nullptr;
+    }
+
+    MObjectHandle handle(attr);
+    std::vector<EnumTableEntry>& bucket = enumTableCache()[handle.hashCode()];
+
+    for (auto it = bucket.begin(); it != bucket.end();) {
+        if (!it->first.isAlive()) {
+            // Attribute was deleted: drop its table
+            it = bucket.erase(it);
+            --s_enumTableCount;
+        } else if (it->first == handle) {
+            if (refresh || !isEnumFieldTableCurrent(attr, *it->second)) {
+                it->second = buildEnumFieldTable(attr);
+            }
+            return it->second;
+        } else {
+            ++it;
+        }
+    }
+
+    std::shared_ptr<const EnumFieldTable> table = buildEnumFieldTable(attr);
+    if (!table) {
+        return nullptr;
+    }
+
+    if (s_enumTableCount >= kMaxEnumTables) {
+        clearEnumFieldTables();
+    }
+    enumTableCache()[handle.hashCode()].emplace_back(handle, table);
+    ++s_enumTableCount;
+    return table;
+}
+
+void invalidateEnumFieldTable(const MObject& attr)
+{
+    auto& cache = enumTableCache();
+    MObjectHandle handle(attr);
+    auto bucketIt = cache.find(handle.hashCode());
+    if (bucketIt == cache.end()) {
+        return;
+    }
+
+    std::vector<EnumTableEntry>& bucket = bucketIt->second;
+    for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+        if (it->first == handle) {
+            bucket.erase(it);
+            --s_enumTableCount;
+            break;
+        }
+    }
+    if (bucket.empty()) {
+        cache.erase(bucketIt);
+    }
+}
+
+void clearEnumFieldTables()
+{
+    enumTableCache().clear();
+    s_enumTableCount = 0;
+}
+
+unsigned int getNodeTypeFlags(const MFnDependencyNode& fnDep)
+{
+    MStatus status;
+    unsigned int typeId = fnDep.typeId(&status).id();
+    if (status != MS::kSuccess) {
+        return computeNodeTypeFlags(fnDep);
+    }
+
+    auto& cache = nodeTypeFlagCache();
+    auto it = cache.find(typeId);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    unsigned int flags = computeNodeTypeFlags(fnDep);
+    cache.emplace(typeId, flags);
+    return flags;
+}
+
+void clearNodeTypeFlags()
+{
+    nodeTypeFlagCache().clear();
+}
+
 } // namespace MayaUtils